@@ -27,12 +27,19 @@
 #define USE_ENCRYPTION                   // AES-128-CTR + HMAC (nécessite USE_CUSTOM_PROTOCOL)
                                          // ⚠️ Même clé sur tous les modules (security/Encryption.h)
 #define DEVICE_ID  2                     // ID unique (0-255) - CHANGER POUR CHAQUE MODULE !
+// #define SECURE_BAND_433                // Mode COMPLET : pile sécurisée sur XL1278 (433 MHz SF7) au lieu du E220
 
 // ============================================
 // CAPTEUR HUMAIN 24GHz
 // ============================================
 #define USE_HUMAN_SENSOR_24GHZ        // Capteur HLK-LD2450
 #define HUMAN_SENSOR_AUTO_SEND_INTERVAL 2500  // Intervalle auto-envoi (ms)
+#define BATCH_SENSOR_READINGS         // Mode SIMPLE : lectures groupées en trames BATCH
+#define BATCH_MAX_FRAME_SIZE     191  // Trame en clair max : 192 après padding AES + magic = 193 <= 200 (E220)
+#define BATCH_MAX_AGE_MS         10000 // Envoi dès que la plus ancienne lecture atteint cet âge
+#define BATCH_MIN_FREE_BYTES     30   // Envoi si la place restante < une lecture complète (2 + 3 + 25)
+#define SENSOR_COMPACT_ENCODING       // Cibles radar en deltas varint (3 octets par cible immobile au lieu de 8)
+#define SENSOR_KEYFRAME_INTERVAL 10   // Une trame absolue (resynchronisation) toutes les N trames
 
 // ============================================
 // PINS
@@ -61,12 +68,14 @@
 // ============================================
 // CONFIGURATION LORA E220-900T22D
 // ============================================
-#define CONFIG_ADDH              0xFF  // Adresse broadcast
+#define CONFIG_ADDH              0xFF  // Adresse broadcast (mode transparent)
 #define CONFIG_ADDL              0xFF
+#define E220_FIXED_TRANSMISSION  1     // 1 = transmission fixe : adresse dérivée du Device ID, filtrage matériel
+                                       // (même réglage sur tous les noeuds de la pile sécurisée)
 #define CONFIG_CHAN_E220         23    // 873.125 MHz (formule: 850.125 + CHAN)
 #define AIR_DATA_RATE            AIR_DATA_RATE_010_24  // 2.4 kbps
 #define TX_POWER                 POWER_22              // 22 dBm
-#define UART_BAUD                UART_BPS_9600
+#define UART_BAUD                UART_BPS_115200       // Liaison ESP32 <-> E220 en mode normal (configuration : 9600)
 #define UART_PARITY              MODE_00_8N1
 
 // ============================================
@@ -80,6 +89,7 @@
 #define LORA_CODING_RATE         5       // 4/5
 #define LORA_SYNC_WORD           0x12    // Privé (0x12) ou public (0x34)
 #define LORA_TX_POWER_XL         20      // 20 dBm
+#define XL1278_RX_RING_SLOTS     8       // Trames en attente côté réception (puissance de 2)
 
 // ============================================
 // INTERVALLES TEMPORELS (ms)
@@ -91,6 +101,43 @@
 #define HEARTBEAT_INTERVAL_MS    10000  // Heartbeat
 #define HEARTBEAT_TIMEOUT_MS     30000  // Timeout heartbeat
 
+// ============================================
+// DUTY CYCLE (réglementation ERC 70-03, 0 = pas de limite)
+// ============================================
+#define DUTY_CYCLE_WINDOW_MS          3600000UL  // Fenêtre glissante (1 h)
+#define DUTY_CYCLE_PERMILLE_E220      10     // 1 % (bande g 863-870 MHz)
+#define DUTY_CYCLE_PERMILLE_XL1278    100    // 10 % (bande 433.05-434.79 MHz)
+
+// ============================================
+// MODE DUAL : UNE TÂCHE FreeRTOS PAR RADIO
+// ============================================
+#define RADIO_TASK_CORE_900      0      // Coeur de la tâche E220
+#define RADIO_TASK_CORE_433      1      // Coeur de la tâche XL1278 (celui de l'ISR DIO0)
+#define RADIO_TASK_PRIORITY      2      // Au-dessus de loop() (priorité 1)
+#define RADIO_TASK_STACK         4096   // Octets
+#define RADIO_TASK_QUEUE_DEPTH   8      // Trames par file (TX par radio, RX partagée)
+
+// ============================================
+// PROFIL BASSE CONSOMMATION : WAKE-ON-RADIO (E220, pile sécurisée)
+// ============================================
+#define WOR_ROLE_NONE            0      // Toujours à l'écoute (alimentation secteur)
+#define WOR_ROLE_SLEEPER         1      // Noeud sur batterie : E220 en WOR, ESP32 en light sleep
+#define WOR_ROLE_WAKER           2      // Réveille un pair SLEEPER par préambule WOR
+#define WOR_ROLE                 WOR_ROLE_NONE
+#define WOR_WAKE_PERIOD          WOR_2000_011  // Période de réveil (identique sur les deux noeuds)
+#define WOR_WAKE_PERIOD_MS       2000
+#define WOR_AWAKE_WINDOW_MS      500    // Écoute continue après chaque échange (réponse, fragments suivants)
+#define WOR_MIN_SLEEP_MS         50     // En dessous, rester éveillé
+#define WOR_HEARTBEAT_INTERVAL_MS 60000 // Heartbeat en profil WOR (multiple de WOR_WAKE_PERIOD_MS)
+
+// Courants par état (µA, valeurs datasheet à étalonner à l'ampèremètre)
+#define CURRENT_ESP32_ACTIVE_UA       40000  // 240 MHz, WiFi/BT éteints
+#define CURRENT_ESP32_LIGHT_SLEEP_UA  800
+#define CURRENT_E220_RX_UA            17000  // Mode 0/1, réception continue
+#define CURRENT_E220_WOR_UA           30     // Mode 2, moyenne sur la période de réveil
+#define CURRENT_E220_TX_UA            110000 // 22 dBm
+#define BATTERY_CAPACITY_MAH          2600   // Une cellule 18650
+
 // ============================================
 // CONSTANTES PROTOCOLE
 // ============================================
@@ -99,6 +146,10 @@
 #define MAX_MESSAGE_SIZE         200    // Max message texte
 #define MAX_PACKET_SIZE          255    // Max paquet LoRa
 #define MAX_PAYLOAD_SIZE         220    // Max payload après headers
+#define FRAGMENT_POOL_SLOTS      48     // Slots de 200 octets (9.6 Ko) : fragments à réassembler et à renvoyer
+#define MAX_MESSAGE_FRAGMENTS    32     // Fragments par message, parité FEC comprise (~4.9 Ko de texte)
+#define MAX_PENDING_MESSAGES     8      // Messages en cours d'envoi (attente d'ACK)
+#define MAX_REASSEMBLY_BUFFERS   16     // Messages en cours de réception, tous pairs confondus
 
 // Tailles crypto
 #define AES_KEY_SIZE             16     // AES-128
@@ -107,6 +158,19 @@
 #define NONCE_SIZE               16     // Nonce ECDH
 #define ECDH_PUBKEY_SIZE         65     // Clé publique ECDH
 
+// ============================================
+// JOURNAL (src/utils/Log.h) : enregistrements binaires, affichage différé
+// ============================================
+#define LOG_LEVEL                LOG_LEVEL_INFO  // LOG_LEVEL_DEBUG : fragments et trames brutes en hexa
+#define LOG_CATEGORIES           LOG_CAT_ALL     // Masque LOG_CAT_BIT(LOG_CAT_xxx)
+#define LOG_RING_SLOTS           32     // Enregistrements en attente (puissance de 2)
+#define LOG_RECORD_DATA_SIZE     255    // Texte/octets copiés par enregistrement (%t, %p, %h) : un TEXT de 249 octets
+#define LOG_TASK_CORE            0      // Loin de l'ISR DIO0 (coeur 1)
+#define LOG_TASK_PRIORITY        1      // Même priorité que loop(), sous les tâches radio
+#define LOG_TASK_STACK           4096   // Octets (ligne formatée sur la pile)
+#define LOG_TASK_IDLE_MS         10     // Attente quand la file est vide
+// #define LOG_TIMESTAMPS               // Préfixe [millis] sur chaque ligne
+
 // ============================================
 // DEBUG & SERIAL
 // ============================================
@@ -0,0 +1,86 @@
+#include "../lora/DualBandRadio.h"
+#include "../utils/Log.h"
+
+DualBandRadio::DualBandRadio(LoRaModule* radio900, XL1278Module* radio433)
+	: rxQueue(nullptr), task900(nullptr), task433(nullptr), radio900(radio900), radio433(radio433) {
+}
+
+bool DualBandRadio::begin() {
+	// File RX partagée : les deux tâches y écrivent, loop() la lit
+	rxQueue = xQueueCreate(RADIO_TASK_QUEUE_DEPTH * 2, sizeof(RadioFrame));
+	if (!rxQueue) {
+		Serial.println("[TASK] ERREUR: file RX non allouée");
+		return false;
+	}
+	
+	if (radio900) {
+		task900 = new RadioTask<LoRaModule>(radio900, RADIO_BAND_900, rxQueue);
+		if (!task900->start("radio900", RADIO_TASK_CORE_900)) {
+			delete task900;
+			task900 = nullptr;
+		}
+	}
+	if (radio433) {
+		task433 = new RadioTask<XL1278Module>(radio433, RADIO_BAND_433, rxQueue);
+		if (!task433->start("radio433", RADIO_TASK_CORE_433)) {
+			delete task433;
+			task433 = nullptr;
+		}
+	}
+	
+	return task900 || task433;
+}
+
+uint8_t DualBandRadio::submit(uint8_t bands, const uint8_t* data, size_t len, TxPriority prio) {
+	uint8_t accepted = 0;
+	if ((bands & RADIO_BAND_900) && task900 && task900->submit(data, len, prio)) {
+		accepted |= RADIO_BAND_900;
+	}
+	if ((bands & RADIO_BAND_433) && task433 && task433->submit(data, len, prio)) {
+		accepted |= RADIO_BAND_433;
+	}
+	return accepted;
+}
+
+bool DualBandRadio::receive(RadioFrame& frame) {
+	if (!rxQueue) return false;
+	return xQueueReceive(rxQueue, &frame, 0) == pdTRUE;
+}
+
+bool DualBandRadio::hasBand(RadioBand band) const {
+	if (band == RADIO_BAND_900) return task900 != nullptr;
+	if (band == RADIO_BAND_433) return task433 != nullptr;
+	return task900 != nullptr && task433 != nullptr;
+}
+
+void DualBandRadio::printStatus() {
+	LogSerialLock lock;
+	Serial.print("[STATUS] File RX: ");
+	Serial.print(rxQueue ? uxQueueMessagesWaiting(rxQueue) : 0);
+	Serial.print("/");
+	Serial.println(RADIO_TASK_QUEUE_DEPTH * 2);
+	
+	if (task900) {
+		Serial.print("[STATUS] 900MHz: envoyés ");
+		Serial.print(radio900->getTxSentCount());
+		Serial.print(", refusés ");
+		Serial.print(task900->getTxRejectedCount());
+		Serial.print(", RX perdus ");
+		Serial.println(task900->getRxOverflowCount());
+		radio900->getDutyCycle().print("900MHz");
+	} else {
+		Serial.println("[STATUS] 900MHz: indisponible");
+	}
+	
+	if (task433) {
+		Serial.print("[STATUS] 433MHz: envoyés ");
+		Serial.print(radio433->getTxSentCount());
+		Serial.print(", refusés ");
+		Serial.print(task433->getTxRejectedCount());
+		Serial.print(", RX perdus ");
+		Serial.println(task433->getRxOverflowCount() + radio433->getRxDroppedCount());
+		radio433->getDutyCycle().print("433MHz");
+	} else {
+		Serial.println("[STATUS] 433MHz: indisponible");
+	}
+}
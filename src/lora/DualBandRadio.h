@@ -0,0 +1,40 @@
+#ifndef DUAL_BAND_RADIO_H
+#define DUAL_BAND_RADIO_H
+
+#include <Arduino.h>
+#include "../lora/RadioTask.h"
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+
+/**
+ * Point d'entrée unique du mode dual : E220 (900 MHz) + XL1278 (433 MHz)
+ *
+ * Chaque radio tourne dans sa propre tâche (RadioTask) : une trame soumise aux
+ * deux bandes part en parallèle sur les deux modules, et les réceptions des
+ * deux bandes arrivent dans une seule file, étiquetées par bande.
+ * Un driver absent (nullptr, init échouée) rend simplement sa bande indisponible.
+ */
+class DualBandRadio {
+public:
+	DualBandRadio(LoRaModule* radio900, XL1278Module* radio433);
+	
+	bool begin();
+	
+	// Retourne le masque des bandes ayant accepté la trame (RADIO_BAND_900 | RADIO_BAND_433)
+	uint8_t submit(uint8_t bands, const uint8_t* data, size_t len, TxPriority prio = TX_PRIO_NORMAL);
+	
+	// Trame reçue sur l'une ou l'autre bande (non bloquant)
+	bool receive(RadioFrame& frame);
+	
+	bool hasBand(RadioBand band) const;
+	void printStatus();
+	
+private:
+	QueueHandle_t rxQueue;
+	RadioTask<LoRaModule>* task900;
+	RadioTask<XL1278Module>* task433;
+	LoRaModule* radio900;
+	XL1278Module* radio433;
+};
+
+#endif // DUAL_BAND_RADIO_H
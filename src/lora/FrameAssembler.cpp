@@ -0,0 +1,58 @@
+#include "../lora/FrameAssembler.h"
+
+FrameAssembler::FrameAssembler(Stream* stream, int auxPin, unsigned long baud)
+	: stream(stream), auxPin(auxPin), gapUs(0), frameLength(0), frameReady(false),
+	  overflow(false), lastByteUs(0), overflowCount(0) {
+	setBaud(baud);
+}
+
+void FrameAssembler::setBaud(unsigned long baud) {
+	// 10 bits par caractère (8N1)
+	gapUs = (unsigned long)RX_GAP_CHARS * 10UL * 1000000UL / baud;
+}
+
+bool FrameAssembler::poll() {
+	// La trame rendue au tour précédent est libérée
+	if (frameReady) {
+		frameReady = false;
+		frameLength = 0;
+	}
+	
+	int pending = stream->available();
+	if (pending > 0) {
+		lastByteUs = micros();
+		while (pending > 0) {
+			if (frameLength < sizeof(buffer)) {
+				size_t room = sizeof(buffer) - frameLength;
+				size_t toRead = (size_t)pending < room ? (size_t)pending : room;
+				frameLength += stream->readBytes(buffer + frameLength, toRead);
+				pending -= (int)toRead;
+			} else {
+				// Trame trop longue : on vide l'UART jusqu'à la fin de la trame
+				stream->read();
+				overflow = true;
+				pending--;
+			}
+		}
+		return false;
+	}
+	
+	if (frameLength == 0 && !overflow) return false;
+	
+	// Le module sort encore la trame
+	if (auxPin >= 0 && digitalRead(auxPin) == LOW) {
+		lastByteUs = micros();
+		return false;
+	}
+	if (micros() - lastByteUs < gapUs) return false;
+	
+	if (overflow) {
+		overflow = false;
+		frameLength = 0;
+		overflowCount++;
+		return false;
+	}
+	
+	frameReady = true;
+	return true;
+}
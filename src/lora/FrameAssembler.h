@@ -0,0 +1,53 @@
+#ifndef FRAME_ASSEMBLER_H
+#define FRAME_ASSEMBLER_H
+
+#include <Arduino.h>
+#include "../Config.h"
+#include "../utils/ByteView.h"
+
+/**
+ * Délimitation des trames reçues sur l'UART du E220 (mode transparent)
+ *
+ * Le E220 garde AUX à l'état bas pendant qu'il sort une trame sur l'UART.
+ * Une trame est considérée complète quand AUX est remonté ET que l'UART est
+ * resté silencieux pendant RX_GAP_CHARS temps-caractère. Le silence couvre le
+ * délai de vidage de la FIFO matérielle de l'ESP32 (timeout RX ~10 symboles).
+ *
+ * Non bloquant : poll() est appelé à chaque tour de loop() et rend la trame
+ * dès que le module a fini de la sortir (plus de delay(50) arbitraire).
+ */
+class FrameAssembler {
+public:
+	static const uint8_t RX_GAP_CHARS = 12;
+	
+	// auxPin < 0 : pas de ligne AUX, délimitation sur le seul silence UART
+	FrameAssembler(Stream* stream, int auxPin, unsigned long baud);
+	
+	// Recalcule le silence de fin de trame (changement de débit UART)
+	void setBaud(unsigned long baud);
+	
+	// Lit les octets disponibles ; true quand une trame complète est prête.
+	// La trame reste valide jusqu'au prochain appel de poll().
+	bool poll();
+	
+	uint8_t* data() { return buffer; }
+	size_t length() const { return frameLength; }
+	ByteView frame() const { return ByteView(buffer, frameLength); }
+	
+	// Trames plus longues que le buffer (abandonnées)
+	uint32_t getOverflowCount() const { return overflowCount; }
+	
+private:
+	Stream* stream;
+	int auxPin;
+	unsigned long gapUs;
+	
+	uint8_t buffer[MAX_PACKET_SIZE];
+	size_t frameLength;
+	bool frameReady;
+	bool overflow;
+	unsigned long lastByteUs;
+	uint32_t overflowCount;
+};
+
+#endif // FRAME_ASSEMBLER_H
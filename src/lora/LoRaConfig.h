@@ -2,6 +2,7 @@
 #define LORA_CONFIG_H
 
 #include <Arduino.h>
+#include <LoRa_E220.h>
 #include "../Config.h"
 
 /**
@@ -24,5 +25,23 @@ static const int PIN_LORA_M1 = PIN_E220_M1;
 // Configuration standard pour mode transparent (utilise Config.h)
 static const byte CONFIG_CHAN = CONFIG_CHAN_E220;
 
+// Le E220 n'accepte les commandes de configuration (mode 3) qu'à 9600 bauds 8N1,
+// quel que soit le débit UART enregistré pour le mode normal
+static const unsigned long E220_CONFIG_BAUD = 9600;
+
+// Débit en bauds d'un code UART_BPS_xxx (registre SPED)
+inline unsigned long e220UartBaud(uint8_t uartBpsCode) {
+	switch (uartBpsCode) {
+		case UART_BPS_1200:   return 1200;
+		case UART_BPS_2400:   return 2400;
+		case UART_BPS_4800:   return 4800;
+		case UART_BPS_19200:  return 19200;
+		case UART_BPS_38400:  return 38400;
+		case UART_BPS_57600:  return 57600;
+		case UART_BPS_115200: return 115200;
+		default:              return 9600;
+	}
+}
+
 #endif // LORA_CONFIG_H
 
@@ -1,7 +1,80 @@
 #include "../lora/LoRaModule.h"
+#include "../storage/NVSManager.h"
+#include "../utils/AirTime.h"
 
-LoRaModule::LoRaModule() {
+// Échelle de débits air, du plus robuste au plus rapide
+static const uint8_t E220_RATE_LADDER[LoRaModule::RATE_COUNT] = {
+	AIR_DATA_RATE_010_24, AIR_DATA_RATE_011_48, AIR_DATA_RATE_100_96, AIR_DATA_RATE_101_192
+};
+// Version du jeu de paramètres imposés (à incrémenter si la liste change)
+static const uint8_t E220_CONFIG_LAYOUT_VERSION = 2;
+
+#if E220_FIXED_TRANSMISSION
+static const uint8_t E220_TRANSMISSION_MODE = FT_FIXED_TRANSMISSION;
+// En-tête ADDH/ADDL/CHAN du destinataire, écrit avant chaque trame et émis avec elle
+static const size_t E220_FIXED_HEADER_BYTES = 3;
+#else
+static const uint8_t E220_TRANSMISSION_MODE = FT_TRANSPARENT_TRANSMISSION;
+static const size_t E220_FIXED_HEADER_BYTES = 0;
+#endif
+
+static const char* const E220_RATE_NAMES[LoRaModule::RATE_COUNT] = {
+	"2.4kbps", "4.8kbps", "9.6kbps", "19.2kbps"
+};
+static const uint32_t E220_RATE_BPS[LoRaModule::RATE_COUNT] = { 2400, 4800, 9600, 19200 };
+// Sensibilité approximative par débit (datasheet E220-900T22D : -129 dBm à 2.4 kbps)
+static const int16_t E220_RATE_SENSITIVITY_DBM[LoRaModule::RATE_COUNT] = { -129, -126, -123, -120 };
+
+// Échelle de puissances, de la plus faible à la plus forte
+static const uint8_t E220_POWER_LADDER[LoRaModule::POWER_COUNT] = { POWER_10, POWER_13, POWER_17, POWER_22 };
+static const int8_t E220_POWER_DBM[LoRaModule::POWER_COUNT] = { 10, 13, 17, 22 };
+
+// Empreinte (FNV-1a) des paramètres imposés par configureForTransparentMode
+static uint32_t configFingerprint(const Configuration& config) {
+	const uint8_t fields[] = {
+		E220_CONFIG_LAYOUT_VERSION,
+		config.ADDH, config.ADDL, config.CHAN,
+		(uint8_t)config.SPED.airDataRate, (uint8_t)config.SPED.uartBaudRate, (uint8_t)config.SPED.uartParity,
+		(uint8_t)config.OPTION.transmissionPower, (uint8_t)config.OPTION.RSSIAmbientNoise,
+		(uint8_t)config.TRANSMISSION_MODE.fixedTransmission, (uint8_t)config.TRANSMISSION_MODE.enableRSSI,
+		(uint8_t)config.TRANSMISSION_MODE.enableLBT, (uint8_t)config.TRANSMISSION_MODE.WORPeriod
+	};
+	uint32_t h = 2166136261UL;
+	for (size_t i = 0; i < sizeof(fields); i++) {
+		h ^= fields[i];
+		h *= 16777619UL;
+	}
+	return h;
+}
+
+// Empreinte d'un module conforme : toute modification de ces paramètres
+// (adresse comprise) la change et force la reconfiguration
+static uint32_t desiredConfigFingerprint(uint16_t address) {
+	Configuration config;
+	config.ADDH = (uint8_t)(address >> 8);
+	config.ADDL = (uint8_t)(address & 0xFF);
+	config.CHAN = CONFIG_CHAN_E220;
+	config.SPED.airDataRate = AIR_DATA_RATE;
+	config.SPED.uartBaudRate = UART_BAUD;
+	config.SPED.uartParity = MODE_00_8N1;
+	config.OPTION.transmissionPower = TX_POWER;
+	config.OPTION.RSSIAmbientNoise = RSSI_AMBIENT_NOISE_DISABLED;
+	config.TRANSMISSION_MODE.fixedTransmission = E220_TRANSMISSION_MODE;
+	config.TRANSMISSION_MODE.enableRSSI = RSSI_ENABLED;
+	config.TRANSMISSION_MODE.enableLBT = LBT_DISABLED;
+	config.TRANSMISSION_MODE.WORPeriod = WOR_WAKE_PERIOD;
+	return configFingerprint(config);
+}
+
+LoRaModule::LoRaModule()
+	: RadioDriver<LoRaModule>(DUTY_CYCLE_PERMILLE_E220),
+	  nvs(nullptr), storedConfigFingerprint(0), persistedConfigFingerprint(0), lastTxWriteMs(0), txHoldoffMs(0), rateIndex(getBaseRateIndex()),
+	  powerIndex(getMaxPowerIndex()),
+	  rssiByteEnabled(false), lastRssi(0), lastRxTimestampMs(0),
+	  hostBaud(E220_CONFIG_BAUD), moduleBaud(E220_CONFIG_BAUD),
+	  radioMode(MODE_0_NORMAL), wakePreamble(false) {
 	serial = new HardwareSerial(2);
+	rxAssembler = new FrameAssembler(serial, PIN_LORA_AUX, E220_CONFIG_BAUD);
 	
 	#if E220_PIN_MODE == MODE_MINIMAL
 	e220ttl = new LoRa_E220(serial);
@@ -14,12 +87,73 @@ LoRaModule::LoRaModule() {
 
 LoRaModule::~LoRaModule() {
 	delete e220ttl;
+	delete rxAssembler;
 	delete serial;
 }
 
-bool LoRaModule::begin() {
-	serial->begin(9600, SERIAL_8N1, PIN_LORA_RX, PIN_LORA_TX);
-	delay(500);
+bool LoRaModule::waitAuxHigh(unsigned long timeoutMs) {
+	const unsigned long start = millis();
+	while (digitalRead(PIN_LORA_AUX) != HIGH) {
+		if (millis() - start >= timeoutMs) return false;
+		delay(1);
+	}
+	return true;
+}
+
+void LoRaModule::setHostBaud(unsigned long baud) {
+	if (baud == hostBaud) return;
+	serial->flush();
+	serial->updateBaudRate(baud);
+	rxAssembler->setBaud(baud);
+	hostBaud = baud;
+}
+
+void LoRaModule::enterConfigMode(unsigned long settleMs) {
+	setHostBaud(E220_CONFIG_BAUD);
+	e220ttl->setMode(MODE_3_CONFIGURATION);
+	radioMode = MODE_3_CONFIGURATION;
+	delay(settleMs);
+}
+
+void LoRaModule::exitConfigMode(unsigned long settleMs) {
+	e220ttl->setMode(MODE_0_NORMAL);
+	radioMode = MODE_0_NORMAL;
+	delay(settleMs);
+	// Retour au débit que le module utilise en mode normal
+	setHostBaud(moduleBaud);
+}
+
+uint16_t LoRaModule::moduleAddress() const {
+	#if E220_FIXED_TRANSMISSION
+	return getLocalAddress();
+	#else
+	return (uint16_t)((CONFIG_ADDH << 8) | CONFIG_ADDL);
+	#endif
+}
+
+void LoRaModule::storeConfigFingerprint(bool valid) {
+	// Empreinte de la configuration relue dans le module, pas de celle demandée :
+	// une écriture partiellement ignorée ne permet pas de sauter la configuration
+	const uint32_t fingerprint = valid ? persistedConfigFingerprint : 0;
+	if (!nvs || fingerprint == storedConfigFingerprint) return;
+	
+	if (fingerprint != 0) {
+		nvs->saveRadioConfigFingerprint(fingerprint);
+	} else {
+		nvs->clearRadioConfigFingerprint();
+	}
+	storedConfigFingerprint = fingerprint;
+}
+
+bool LoRaModule::begin(NVSManager* nvsManager) {
+	nvs = nvsManager;
+	const unsigned long startMs = millis();
+	
+	// Tampon TX logiciel : une trame complète tient dedans, write() ne bloque pas
+	serial->setTxBufferSize(256);
+	serial->begin(E220_CONFIG_BAUD, SERIAL_8N1, PIN_LORA_RX, PIN_LORA_TX);
+	// AUX remonte à la fin de l'auto-test du module (au lieu d'un delay(500) fixe)
+	waitAuxHigh(500);
 	
 	Serial.println("[LoRa] Initialisation du module E220...");
 	if (!e220ttl->begin()) {
@@ -28,21 +162,35 @@ bool LoRaModule::begin() {
 	}
 	
 	Serial.println("[LoRa] Module E220 initialisé avec succès");
-	delay(300);
 	
 	#if E220_PIN_MODE == MODE_COMPLET
-	e220ttl->setMode(MODE_3_CONFIGURATION);
+	uint32_t storedFingerprint = 0;
+	if (nvs && nvs->loadRadioConfigFingerprint(storedFingerprint) &&
+	    storedFingerprint == desiredConfigFingerprint(moduleAddress())) {
+		// Démarrage à chaud : le module a déjà la configuration voulue en EEPROM
+		storedConfigFingerprint = storedFingerprint;
+		persistedConfigFingerprint = storedFingerprint;
+		rssiByteEnabled = true;
+		rateIndex = getBaseRateIndex();
+		powerIndex = getMaxPowerIndex();
+		moduleBaud = e220UartBaud(UART_BAUD);
+		setHostBaud(moduleBaud);
+		Serial.print("[BOOT] LoRa: configuration inchangée (empreinte NVS), mode config évité - ");
+		Serial.print(millis() - startMs);
+		Serial.println(" ms");
+		return true;
+	}
+	
 	delay(300);
+	const unsigned long configStartMs = millis();
+	enterConfigMode(300);
 	
-	bool configRead = false;
 	Configuration currentConfig;
-	for (int i = 0; i < 3 && !configRead; i++) {
-		if (readConfiguration(currentConfig)) {
-			printConfiguration();
-			configRead = true;
-		} else if (i < 2) {
-			delay(200);
-		}
+	const bool configRead = probeConfiguration(currentConfig);
+	if (configRead) {
+		rssiByteEnabled = (currentConfig.TRANSMISSION_MODE.enableRSSI == RSSI_ENABLED);
+		moduleBaud = e220UartBaud(currentConfig.SPED.uartBaudRate);
+		printConfiguration();
 	}
 	
 	if (configRead) {
@@ -56,8 +204,16 @@ bool LoRaModule::begin() {
 		Serial.println("[LoRa] ATTENTION: Configuration non lue");
 	}
 	
-	e220ttl->setMode(MODE_0_NORMAL);
-	delay(200);
+	exitConfigMode(200);
+	Serial.print("[LoRa] Liaison UART: ");
+	Serial.print(hostBaud);
+	Serial.println(" bauds");
+	
+	Serial.print("[BOOT] LoRa: aller-retour mode configuration ");
+	Serial.print(millis() - configStartMs);
+	Serial.print(" ms, total ");
+	Serial.print(millis() - startMs);
+	Serial.println(" ms");
 	#else
 	Serial.println("[LoRa] E220-900T22D initialisé");
 	Serial.println("[LoRa] Note: Configuration non accessible (nécessite pins M0/M1)");
@@ -86,8 +242,32 @@ bool LoRaModule::readConfiguration(Configuration& config) {
 	return false;
 }
 
-bool LoRaModule::writeConfiguration(const Configuration& config) {
-	ResponseStatus rs = e220ttl->setConfiguration(config, WRITE_CFG_PWR_DWN_SAVE);
+bool LoRaModule::probeConfiguration(Configuration& config) {
+	// 9600 bauds d'abord (débit du mode configuration), puis le débit du mode
+	// normal : module resté en mode normal ou variante qui garde son débit
+	const unsigned long rates[] = { E220_CONFIG_BAUD, e220UartBaud(UART_BAUD) };
+	for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+		if (r > 0 && rates[r] == rates[0]) break;
+		setHostBaud(rates[r]);
+		for (int i = 0; i < 3; i++) {
+			if (readConfiguration(config)) {
+				if (r > 0) {
+					Serial.print("[LoRa] Configuration lue à ");
+					Serial.print(rates[r]);
+					Serial.println(" bauds");
+				}
+				return true;
+			}
+			if (i < 2) delay(200);
+		}
+	}
+	setHostBaud(E220_CONFIG_BAUD);
+	return false;
+}
+
+bool LoRaModule::writeConfiguration(const Configuration& config, bool persist) {
+	// persist = false : configuration perdue à la mise hors tension (pas d'usure de l'EEPROM)
+	ResponseStatus rs = e220ttl->setConfiguration(config, persist ? WRITE_CFG_PWR_DWN_SAVE : WRITE_CFG_PWR_DWN_LOSE);
 	return (rs.getResponseDescription() == "Success");
 }
 
@@ -123,56 +303,58 @@ void LoRaModule::printConfiguration() {
 
 bool LoRaModule::configureForTransparentMode(bool forceConfig) {
 	#if E220_PIN_MODE == MODE_COMPLET
+	#if E220_FIXED_TRANSMISSION
+	Serial.println("[LoRa] Configuration du module pour transmission fixe...");
+	#else
 	Serial.println("[LoRa] Configuration du module pour mode transparent...");
+	#endif
 	
-	e220ttl->setMode(MODE_3_CONFIGURATION);
-	delay(300);
-	
-	Configuration configuration;
-	bool configRead = false;
-	for (int retry = 0; retry < 3 && !configRead; retry++) {
-		if (readConfiguration(configuration)) {
-			configRead = true;
-		} else if (retry < 2) {
-			delay(200);
-		}
+	// Ne pas changer de mode au milieu d'une émission en file
+	if (!flushTxQueue(2000)) {
+		Serial.println("[LoRa] ATTENTION: File TX non vidée avant configuration");
 	}
 	
-	if (!configRead) {
+	enterConfigMode(300);
+	
+	Configuration configuration;
+	if (!probeConfiguration(configuration)) {
 		Serial.println("[LoRa] Erreur: Impossible de lire la configuration.");
-		e220ttl->setMode(MODE_0_NORMAL);
-		delay(100);
+		exitConfigMode(100);
 		return false;
 	}
 	
 	bool needsUpdate = forceConfig;
+	const uint8_t addh = (uint8_t)(moduleAddress() >> 8);
+	const uint8_t addl = (uint8_t)(moduleAddress() & 0xFF);
 	
-	if (configuration.ADDH != CONFIG_ADDH || 
-	    configuration.ADDL != CONFIG_ADDL || 
+	if (configuration.ADDH != addh || 
+	    configuration.ADDL != addl || 
 	    configuration.CHAN != CONFIG_CHAN_E220 ||
-	    configuration.SPED.airDataRate != AIR_DATA_RATE_101_192 ||
-	    configuration.SPED.uartBaudRate != UART_BPS_9600 ||
+	    configuration.SPED.airDataRate != AIR_DATA_RATE ||
+	    configuration.SPED.uartBaudRate != UART_BAUD ||
 	    configuration.SPED.uartParity != MODE_00_8N1 ||
-	    configuration.OPTION.transmissionPower != POWER_22 ||
-	    configuration.TRANSMISSION_MODE.fixedTransmission != FT_TRANSPARENT_TRANSMISSION) {
+	    configuration.OPTION.transmissionPower != TX_POWER ||
+	    configuration.TRANSMISSION_MODE.enableRSSI != RSSI_ENABLED ||
+	    configuration.TRANSMISSION_MODE.fixedTransmission != E220_TRANSMISSION_MODE) {
 		needsUpdate = true;
 	}
 	
 	if (needsUpdate) {
 		Serial.println("[LoRa] Mise à jour de la configuration...");
 		
-		configuration.ADDH = CONFIG_ADDH;
-		configuration.ADDL = CONFIG_ADDL;
+		configuration.ADDH = addh;
+		configuration.ADDL = addl;
 		configuration.CHAN = CONFIG_CHAN_E220;
-		configuration.SPED.airDataRate = AIR_DATA_RATE_101_192;
-		configuration.SPED.uartBaudRate = UART_BPS_9600;
+		configuration.SPED.airDataRate = AIR_DATA_RATE;
+		configuration.SPED.uartBaudRate = UART_BAUD;
 		configuration.SPED.uartParity = MODE_00_8N1;
-		configuration.OPTION.transmissionPower = POWER_22;
+		configuration.OPTION.transmissionPower = TX_POWER;
 		configuration.OPTION.RSSIAmbientNoise = RSSI_AMBIENT_NOISE_DISABLED;
-		configuration.TRANSMISSION_MODE.fixedTransmission = FT_TRANSPARENT_TRANSMISSION;
-		configuration.TRANSMISSION_MODE.enableRSSI = RSSI_DISABLED;
+		configuration.TRANSMISSION_MODE.fixedTransmission = E220_TRANSMISSION_MODE;
+		// Octet RSSI ajouté par le module à chaque trame reçue (retiré par receiveFrame)
+		configuration.TRANSMISSION_MODE.enableRSSI = RSSI_ENABLED;
 		configuration.TRANSMISSION_MODE.enableLBT = LBT_DISABLED;
-		configuration.TRANSMISSION_MODE.WORPeriod = WOR_2000_011;
+		configuration.TRANSMISSION_MODE.WORPeriod = WOR_WAKE_PERIOD;
 		
 		bool configSaved = false;
 		for (int retry = 0; retry < 3 && !configSaved; retry++) {
@@ -186,16 +368,38 @@ bool LoRaModule::configureForTransparentMode(bool forceConfig) {
 		}
 		
 		if (!configSaved) {
-			e220ttl->setMode(MODE_0_NORMAL);
-			delay(100);
+			exitConfigMode(100);
 			return false;
 		}
 	} else {
 		Serial.println("[LoRa] Configuration déjà correcte, pas de modification nécessaire.");
 	}
 	
-	e220ttl->setMode(MODE_0_NORMAL);
-	delay(200);
+	// Le débit UART rapide n'est adopté côté ESP32 que si le module l'a bien enregistré :
+	// sinon repli à 9600 bauds, toujours joignable
+	bool fastUartConfirmed = false;
+	Configuration check;
+	if (probeConfiguration(check) && check.SPED.uartBaudRate == UART_BAUD) {
+		moduleBaud = e220UartBaud(UART_BAUD);
+		fastUartConfirmed = true;
+		persistedConfigFingerprint = configFingerprint(check);
+	} else {
+		persistedConfigFingerprint = 0;
+		Serial.println("[LoRa] ATTENTION: Débit UART non confirmé par le module, repli à 9600 bauds");
+		configuration.SPED.uartBaudRate = UART_BPS_9600;
+		writeConfiguration(configuration);
+		moduleBaud = E220_CONFIG_BAUD;
+	}
+	
+	exitConfigMode(200);
+	
+	// Tous les noeuds repartent du débit de base (point de rendez-vous de l'adaptation)
+	// et de la puissance nominale
+	rateIndex = getBaseRateIndex();
+	powerIndex = getMaxPowerIndex();
+	rssiByteEnabled = true;
+	// Repli : pas d'empreinte, le prochain démarrage retentera le débit rapide
+	storeConfigFingerprint(fastUartConfirmed);
 	
 	return true;
 	#else
@@ -204,61 +408,200 @@ bool LoRaModule::configureForTransparentMode(bool forceConfig) {
 	#endif
 }
 
-bool LoRaModule::sendPacket(const std::vector<uint8_t>& data) {
-	if (data.empty()) {
-		Serial.println("[LoRa] Erreur: Tentative d'envoi d'un paquet vide");
+bool LoRaModule::canTransmit() {
+	// AUX reste haut quelques ms après l'écriture UART : on attend la durée
+	// de transfert de la trame avant de s'y fier
+	if (millis() - lastTxWriteMs < txHoldoffMs) {
 		return false;
 	}
+	return digitalRead(PIN_LORA_AUX) == HIGH;
+}
+
+void LoRaModule::transmitFrame(const uint8_t* data, size_t len, uint16_t dest) {
+	#if E220_PIN_MODE == MODE_COMPLET
+	// AUX haut (canTransmit) : le changement de mode est sûr
+	const MODE_TYPE txMode = wakePreamble ? MODE_1_WOR_TRANSMITTER : MODE_0_NORMAL;
+	if (radioMode != txMode) {
+		setMode(txMode);
+	}
+	#endif
+	
+	// La trame est simplement écrite sur l'UART,
+	// sans l'attente bloquante de fin d'émission de sendMessage()
+	#if E220_FIXED_TRANSMISSION
+	// Transmission fixe : le module lit l'adresse et le canal du destinataire en tête
+	const uint8_t header[E220_FIXED_HEADER_BYTES] = {
+		(uint8_t)(dest >> 8), (uint8_t)(dest & 0xFF), CONFIG_CHAN_E220
+	};
+	serial->write(header, sizeof(header));
+	#else
+	(void)dest;
+	#endif
+	serial->write(data, len);
+	
+	const unsigned long uartBytes = (unsigned long)(len + E220_FIXED_HEADER_BYTES);
+	lastTxWriteMs = millis();
+	txHoldoffMs = (uartBytes * 10UL * 1000UL + hostBaud - 1) / hostBaud + AUX_SETTLE_MS;
+}
+
+uint8_t LoRaModule::getBaseRateIndex() const {
+	for (uint8_t i = 0; i < RATE_COUNT; i++) {
+		if (E220_RATE_LADDER[i] == AIR_DATA_RATE) return i;
+	}
+	return 0;
+}
+
+const char* LoRaModule::getRateName(uint8_t index) const {
+	return index < RATE_COUNT ? E220_RATE_NAMES[index] : "?";
+}
+
+uint32_t LoRaModule::timeOnAirUs(size_t len) const {
+	const uint32_t preambleUs = wakePreamble ? WOR_WAKE_PERIOD_MS * 1000UL : 0;
+	return AirTime::e220Us(len + E220_FIXED_HEADER_BYTES, E220_RATE_BPS[rateIndex]) + preambleUs;
+}
+
+int LoRaModule::getSensitivityDbm() const {
+	return E220_RATE_SENSITIVITY_DBM[rateIndex];
+}
+
+bool LoRaModule::isAtPersistedConfig() const {
+	// Débit de base et puissance nominale : le module est conforme à son EEPROM
+	return rateIndex == getBaseRateIndex() && powerIndex == getMaxPowerIndex();
+}
+
+bool LoRaModule::writeRuntimeParameters(uint8_t airDataRate, uint8_t transmissionPower) {
+	#if E220_PIN_MODE == MODE_COMPLET
+	// Les trames en file partent encore avec les anciens paramètres
+	if (!flushTxQueue(2000)) {
+		Serial.println("[LoRa] ATTENTION: File TX non vidée avant changement de paramètres");
+	}
+	
+	enterConfigMode(100);
+	
+	Configuration configuration;
+	bool ok = readConfiguration(configuration);
+	if (ok) {
+		configuration.SPED.airDataRate = airDataRate;
+		configuration.OPTION.transmissionPower = transmissionPower;
+		ok = writeConfiguration(configuration, false);
+	}
+	
+	exitConfigMode(100);
+	return ok;
+	#else
+	(void)airDataRate;
+	(void)transmissionPower;
+	return false;
+	#endif
+}
+
+uint8_t LoRaModule::getMaxPowerIndex() const {
+	for (uint8_t i = 0; i < POWER_COUNT; i++) {
+		if (E220_POWER_LADDER[i] == TX_POWER) return i;
+	}
+	return POWER_COUNT - 1;
+}
+
+int LoRaModule::getPowerDbm(uint8_t index) const {
+	return index < POWER_COUNT ? E220_POWER_DBM[index] : 0;
+}
+
+bool LoRaModule::setPowerIndex(uint8_t index) {
+	if (index > getMaxPowerIndex()) return false;
+	if (index == powerIndex) return true;
 	
-	const size_t MAX_SEND_SIZE = 200;
-	if (data.size() > MAX_SEND_SIZE) {
-		Serial.print("[LoRa] ERREUR: Paquet trop grand (");
-		Serial.print(data.size());
-		Serial.print(" octets, max ");
-		Serial.print(MAX_SEND_SIZE);
-		Serial.println(" octets)");
+	#if E220_PIN_MODE == MODE_COMPLET
+	if (!writeRuntimeParameters(E220_RATE_LADDER[rateIndex], E220_POWER_LADDER[index])) {
+		Serial.println("[LoRa] ERREUR: Changement de puissance échoué");
 		return false;
 	}
 	
-	ResponseStatus rs = e220ttl->sendMessage(data.data(), (uint8_t)data.size());
-	if (rs.getResponseDescription() != "Success") {
-		Serial.print("[LoRa] Erreur envoi: ");
-		Serial.println(rs.getResponseDescription());
+	Serial.print("[LoRa] Puissance TX: ");
+	Serial.print(E220_POWER_DBM[powerIndex]);
+	Serial.print(" -> ");
+	Serial.print(E220_POWER_DBM[index]);
+	Serial.println(" dBm");
+	powerIndex = index;
+	storeConfigFingerprint(isAtPersistedConfig());
+	return true;
+	#else
+	Serial.println("[LoRa] Changement de puissance impossible: nécessite pins M0/M1 (mode COMPLET)");
+	return false;
+	#endif
+}
+
+bool LoRaModule::setRateIndex(uint8_t index) {
+	if (index >= RATE_COUNT) return false;
+	if (index == rateIndex) return true;
+	
+	#if E220_PIN_MODE == MODE_COMPLET
+	if (!writeRuntimeParameters(E220_RATE_LADDER[index], E220_POWER_LADDER[powerIndex])) {
+		Serial.println("[LoRa] ERREUR: Changement de débit air échoué");
 		return false;
 	}
 	
+	Serial.print("[LoRa] Débit air: ");
+	Serial.print(E220_RATE_NAMES[rateIndex]);
+	Serial.print(" -> ");
+	Serial.println(E220_RATE_NAMES[index]);
+	rateIndex = index;
+	// Débit hors base : le module n'est plus conforme à son EEPROM jusqu'à sa mise hors tension
+	storeConfigFingerprint(isAtPersistedConfig());
 	return true;
+	#else
+	Serial.println("[LoRa] Changement de débit impossible: nécessite pins M0/M1 (mode COMPLET)");
+	return false;
+	#endif
 }
 
 bool LoRaModule::available() {
 	return e220ttl->available() > 0;
 }
 
-bool LoRaModule::receiveMessage(std::vector<uint8_t>& buffer) {
-	if (!available()) return false;
-	
-	ResponseContainer rc = e220ttl->receiveMessageComplete(false);
-	if (rc.status.getResponseDescription() != "Success") {
+bool LoRaModule::receiveFrame(ByteView& frame) {
+	if (!rxAssembler->poll()) {
 		return false;
 	}
+	frame = rxAssembler->frame();
+	lastRxTimestampMs = millis();
 	
-	buffer.clear();
-	if (rc.data.length() > 0) {
-		buffer.reserve(rc.data.length());
-		for (size_t i = 0; i < rc.data.length(); ++i) {
-			buffer.push_back((uint8_t)rc.data[i]);
-		}
+	if (rssiByteEnabled && frame.size() >= 2) {
+		// Dernier octet = RSSI du paquet : dBm = -(256 - octet)
+		lastRssi = -(256 - (int)frame[frame.size() - 1]);
+		frame = ByteView(frame.data(), frame.size() - 1);
 	}
-	
-	return !buffer.empty();
+	return true;
 }
 
 void LoRaModule::setMode(MODE_TYPE mode) {
+	// Le débit UART suit le mode : 9600 en configuration, débit enregistré sinon
+	if (mode == MODE_3_CONFIGURATION) {
+		setHostBaud(E220_CONFIG_BAUD);
+	}
 	e220ttl->setMode(static_cast<MODE_TYPE>(mode));
+	radioMode = mode;
+	if (mode != MODE_3_CONFIGURATION) {
+		setHostBaud(moduleBaud);
+	}
 }
 
 MODE_TYPE LoRaModule::getMode() {
-	// La bibliothèque ne fournit pas de getter direct, on assume le mode
-	return MODE_0_NORMAL;
+	// La bibliothèque ne fournit pas de getter direct : dernier mode demandé
+	return radioMode;
+}
+
+bool LoRaModule::enterWorReceive() {
+	#if E220_PIN_MODE == MODE_COMPLET
+	if (radioMode == MODE_2_WOR_RECEIVER) return true;
+	// Le mode 2 n'émet pas : la file TX doit être vide
+	if (!flushTxQueue(2000)) {
+		Serial.println("[LoRa] ATTENTION: File TX non vidée, WOR reporté");
+		return false;
+	}
+	setMode(MODE_2_WOR_RECEIVER);
+	return true;
+	#else
+	return false;
+	#endif
 }
 
@@ -6,30 +6,120 @@
 #include <LoRa_E220.h>
 #include <vector>
 #include "../lora/LoRaConfig.h"
+#include "../lora/FrameAssembler.h"
+#include "../lora/RadioDriver.h"
+#include "../utils/ByteView.h"
 
-class LoRaModule {
+class NVSManager;
+
+class LoRaModule : public RadioDriver<LoRaModule> {
 public:
+	// Marge après l'envoi UART avant de faire confiance à AUX (le module le baisse avec retard)
+	static const unsigned long AUX_SETTLE_MS = 4;
+	
 	LoRaModule();
 	~LoRaModule();
 	
-	bool begin();
+	// nvs (optionnel) : empreinte de la configuration écrite, un démarrage à chaud
+	// sans changement de configuration évite alors le mode configuration
+	bool begin(NVSManager* nvs = nullptr);
 	bool configureForTransparentMode(bool forceConfig = false);
-	bool sendPacket(const std::vector<uint8_t>& data);
+	
 	bool available();
-	bool receiveMessage(std::vector<uint8_t>& buffer);
+	
+	// Réception sans allocation, non bloquante : la trame est délimitée par AUX
+	// et le silence UART (FrameAssembler). Vue sur le buffer interne, valide
+	// jusqu'à la réception suivante.
+	bool receiveFrame(ByteView& frame);
+	using RadioDriver<LoRaModule>::receiveFrame;
+	
+	// RSSI de la dernière trame (octet ajouté par le module, enableRSSI) ; pas de SNR sur E220
+	int getLastRssi() const { return lastRssi; }
+	float getLastSnr() const { return 0.0f; }
+	bool hasSnr() const { return false; }
+	
+	// Horodatage (millis) de fin de trame, vue par le FrameAssembler
+	uint32_t getLastRxTimestamp() const { return lastRxTimestampMs; }
+	
+	// Interface RadioDriver : AUX haut = module libre, écriture UART de la trame
+	// (précédée de l'en-tête ADDH/ADDL/CHAN du destinataire en transmission fixe)
+	bool canTransmit();
+	void transmitFrame(const uint8_t* data, size_t len, uint16_t dest);
+	const char* bandName() const { return "900MHz"; }
+	
+	// Adaptation de débit air : 2.4 -> 19.2 kbps, AIR_DATA_RATE (Config.h) = débit de base.
+	// Le changement est temporaire (non sauvegardé) : au redémarrage, retour au débit de base.
+	static const uint8_t RATE_COUNT = 4;
+	uint8_t getRateCount() const { return RATE_COUNT; }
+	uint8_t getRateIndex() const { return rateIndex; }
+	uint8_t getBaseRateIndex() const;
+	bool setRateIndex(uint8_t index);
+	const char* getRateName(uint8_t index) const;
+	
+	int getSensitivityDbm() const;
+	
+	// Contrôle de puissance : 10 -> 22 dBm, TX_POWER (Config.h) = puissance nominale.
+	// Comme le débit, changement temporaire ; les trames en file partent à l'ancienne puissance.
+	static const uint8_t POWER_COUNT = 4;
+	uint8_t getPowerCount() const { return POWER_COUNT; }
+	uint8_t getPowerIndex() const { return powerIndex; }
+	uint8_t getMaxPowerIndex() const;
+	bool setPowerIndex(uint8_t index);
+	int getPowerDbm(uint8_t index) const;
+	
+	// Temps d'antenne estimé au débit air courant (voir AirTime::e220Us)
+	uint32_t timeOnAirUs(size_t len) const;
 	
 	void setMode(MODE_TYPE mode);
 	MODE_TYPE getMode();
 	
+	// Wake-on-radio (Config.h, WOR_ROLE) :
+	// - préambule de réveil : les trames partent en mode 1 (préambule long d'une
+	//   période WOR) pour réveiller un pair en mode 2 ; compté dans le temps d'antenne
+	// - réception WOR : mode 2, le module n'écoute qu'une fois par période. Une
+	//   émission repasse automatiquement en mode 0 (le mode 2 n'émet pas).
+	void setWakePreamble(bool on) { wakePreamble = on; }
+	bool enterWorReceive();
+	bool isWorReceiving() const { return radioMode == MODE_2_WOR_RECEIVER; }
+	
 	void printConfiguration();
 	
 private:
 	HardwareSerial* serial;
 	LoRa_E220* e220ttl;
+	NVSManager* nvs;
+	uint32_t storedConfigFingerprint;     // empreinte en NVS (0 : aucune)
+	uint32_t persistedConfigFingerprint;  // relue après la dernière écriture persistante (0 : inconnue)
+	
+	FrameAssembler* rxAssembler;
 	
+	unsigned long lastTxWriteMs;
+	unsigned long txHoldoffMs;
+	uint8_t rateIndex;
+	uint8_t powerIndex;
+	bool rssiByteEnabled;
+	int lastRssi;
+	uint32_t lastRxTimestampMs;
+	
+	// Débit UART côté ESP32 et débit enregistré dans le module pour le mode normal
+	unsigned long hostBaud;
+	unsigned long moduleBaud;
+	
+	MODE_TYPE radioMode;
+	bool wakePreamble;
+	
+	bool waitAuxHigh(unsigned long timeoutMs);
+	void setHostBaud(unsigned long baud);
+	void enterConfigMode(unsigned long settleMs);
+	void exitConfigMode(unsigned long settleMs);
+	uint16_t moduleAddress() const;
+	void storeConfigFingerprint(bool valid);
+	bool writeRuntimeParameters(uint8_t airDataRate, uint8_t transmissionPower);
+	bool isAtPersistedConfig() const;
 	bool readConfiguration(Configuration& config);
-	bool writeConfiguration(const Configuration& config);
+	// readConfiguration à 9600 bauds, puis au débit UART_BAUD ; false si aucun ne répond
+	bool probeConfiguration(Configuration& config);
+	bool writeConfiguration(const Configuration& config, bool persist = true);
 };
 
 #endif // LORA_MODULE_H
-
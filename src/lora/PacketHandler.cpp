@@ -1,11 +1,20 @@
 #include "../lora/PacketHandler.h"
+#ifdef RADIO_SIM
+#include "../sim/SimRadio.h"
+#else
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#endif
 
-PacketHandler::PacketHandler(PairingManager* pairing, FragmentManager* fragment,
-                             HeartbeatManager* heartbeat, DiscoveryManager* discovery)
-	: pairing(pairing), fragment(fragment), heartbeat(heartbeat), discovery(discovery) {
+template <class Radio>
+PacketHandler<Radio>::PacketHandler(PairingManager<Radio>* pairing, FragmentManager<Radio>* fragment,
+                                    HeartbeatManager<Radio>* heartbeat, DiscoveryManager<Radio>* discovery)
+	: pairing(pairing), fragment(fragment), heartbeat(heartbeat), discovery(discovery),
+	  rateController(nullptr) {
 }
 
-uint8_t PacketHandler::findPacketType(const std::vector<uint8_t>& buffer, size_t& typeOffset) {
+template <class Radio>
+uint8_t PacketHandler<Radio>::findPacketType(const ByteView& buffer, size_t& typeOffset) {
 	typeOffset = 0;
 	
 	// Chercher le type de paquet dans les premiers octets
@@ -14,7 +23,8 @@ uint8_t PacketHandler::findPacketType(const std::vector<uint8_t>& buffer, size_t
 		if (candidate == PKT_BIND_REQ || candidate == PKT_BIND_RESP || 
 		    candidate == PKT_BIND_CONFIRM || candidate == PKT_DATA || 
 		    candidate == PKT_BEACON || candidate == PKT_ACK || 
-		    candidate == PKT_HEARTBEAT) {
+		    candidate == PKT_HEARTBEAT || candidate == PKT_RATE_CTRL ||
+		    candidate == PKT_DATA_FEC || candidate == PKT_SACK) {
 			typeOffset = i;
 			return candidate;
 		}
@@ -23,8 +33,9 @@ uint8_t PacketHandler::findPacketType(const std::vector<uint8_t>& buffer, size_t
 	return 0;
 }
 
-bool PacketHandler::handlePacket(const std::vector<uint8_t>& packet, uint32_t deviceId,
-                                bool isPaired, const uint8_t* sessionKey, PairingManager* pairingMgr) {
+template <class Radio>
+bool PacketHandler<Radio>::handlePacket(const ByteView& packet, uint32_t deviceId,
+                                       bool isPaired, const uint8_t* sessionKey, PairingManager<Radio>* pairingMgr) {
 	if (packet.empty()) return false;
 	
 	size_t typeOffset = 0;
@@ -34,27 +45,22 @@ bool PacketHandler::handlePacket(const std::vector<uint8_t>& packet, uint32_t de
 		return false; // Type invalide
 	}
 	
-	// Ajuster le buffer pour ignorer les octets avant le type
-	std::vector<uint8_t> adjustedPacket;
-	if (typeOffset > 0) {
-		adjustedPacket.assign(packet.begin() + typeOffset, packet.end());
-	} else {
-		adjustedPacket = packet;
-	}
+	// Ignorer les octets avant le type (vue décalée, sans copie)
+	const ByteView adjustedPacket = packet.subview(typeOffset);
 	
 	switch (type) {
 		case PKT_BIND_REQ:
 			return pairing->handleBindRequest(adjustedPacket);
-			
+		
 		case PKT_BIND_RESP:
 			return pairing->handleBindResponse(adjustedPacket);
-			
+		
 		case PKT_BIND_CONFIRM:
 			return pairing->handleBindConfirm(adjustedPacket);
-			
+		
 		case PKT_BEACON:
 			return discovery->handleBeacon(adjustedPacket, deviceId);
-			
+		
 		case PKT_HEARTBEAT:
 			if (!isPaired) {
 				Serial.println("[HEARTBEAT] Heartbeat reçu mais non appairé, ignoré");
@@ -65,25 +71,43 @@ bool PacketHandler::handlePacket(const std::vector<uint8_t>& packet, uint32_t de
 				// peut le mettre à jour temporairement pour la détection
 				uint32_t tempPairedDeviceId = pairingMgr->getPairedDeviceId();
 				bool result = heartbeat->handleHeartbeat(adjustedPacket, sessionKey, deviceId, tempPairedDeviceId);
-				// Le pairedDeviceId sera mis à jour dans PairingManager lors de l'appairage
+				// Heartbeat authentifié : son émetteur devient la destination unicast
+				if (result) {
+					pairingMgr->notePairedDeviceId(tempPairedDeviceId);
+				}
 				return result;
 			}
-			
+		
 		case PKT_DATA:
+		case PKT_DATA_FEC:
 			if (!isPaired) {
 				Serial.println("[SEC] Données reçues alors que non appairé, ignoré");
 				return false;
 			}
 			return fragment->handleDataPacket(adjustedPacket, sessionKey);
-			
+		
 		case PKT_ACK:
+		case PKT_SACK:
 			if (!isPaired) {
 				return false; // Ignorer si non appairé
 			}
 			return fragment->handleAck(adjustedPacket, sessionKey);
-			
+		
+		case PKT_RATE_CTRL:
+			if (!isPaired || !rateController) {
+				return false;
+			}
+			return rateController->handleRateControl(adjustedPacket, sessionKey, deviceId);
+		
 		default:
 			return false;
 	}
 }
 
+// Instanciations explicites : une par driver radio
+#ifdef RADIO_SIM
+template class PacketHandler<SimRadio>;
+#else
+template class PacketHandler<LoRaModule>;
+template class PacketHandler<XL1278Module>;
+#endif
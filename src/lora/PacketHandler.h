@@ -4,28 +4,35 @@
 #include <Arduino.h>
 #include <vector>
 #include "../protocol/PacketTypes.h"
+#include "../utils/ByteView.h"
 #include "../security/PairingManager.h"
 #include "../protocol/FragmentManager.h"
 #include "../utils/HeartbeatManager.h"
 #include "../security/DiscoveryManager.h"
+#include "../protocol/AdaptiveRateController.h"
 
+template <class Radio>
 class PacketHandler {
 public:
-	PacketHandler(PairingManager* pairing, FragmentManager* fragment, 
-	             HeartbeatManager* heartbeat, DiscoveryManager* discovery);
+	PacketHandler(PairingManager<Radio>* pairing, FragmentManager<Radio>* fragment, 
+	             HeartbeatManager<Radio>* heartbeat, DiscoveryManager<Radio>* discovery);
+	
+	// Optionnel : sans contrôleur, les paquets PKT_RATE_CTRL sont ignorés
+	void setRateController(AdaptiveRateController<Radio>* controller) { rateController = controller; }
 	
 	// Traitement d'un paquet reçu
-	bool handlePacket(const std::vector<uint8_t>& packet, uint32_t deviceId, 
-	                 bool isPaired, const uint8_t* sessionKey, PairingManager* pairing);
+	bool handlePacket(const ByteView& packet, uint32_t deviceId, 
+	                 bool isPaired, const uint8_t* sessionKey, PairingManager<Radio>* pairing);
 	
 private:
-	PairingManager* pairing;
-	FragmentManager* fragment;
-	HeartbeatManager* heartbeat;
-	DiscoveryManager* discovery;
+	PairingManager<Radio>* pairing;
+	FragmentManager<Radio>* fragment;
+	HeartbeatManager<Radio>* heartbeat;
+	DiscoveryManager<Radio>* discovery;
+	AdaptiveRateController<Radio>* rateController;
 	
 	// Trouver le type de paquet dans le buffer (peut être décalé)
-	uint8_t findPacketType(const std::vector<uint8_t>& buffer, size_t& typeOffset);
+	uint8_t findPacketType(const ByteView& buffer, size_t& typeOffset);
 };
 
 #endif // PACKET_HANDLER_H
@@ -0,0 +1,294 @@
+#ifndef RADIO_DRIVER_H
+#define RADIO_DRIVER_H
+
+#include <Arduino.h>
+#include <vector>
+#include <cstdint>
+#include "../utils/ByteView.h"
+#include "../utils/DutyCycleBudget.h"
+#include "../utils/Log.h"
+
+// Adresse radio 16 bits (ADDH/ADDL du E220) ; 0xFFFF = broadcast, et un module
+// configuré à 0xFFFF reçoit toutes les trames
+static const uint16_t RADIO_ADDR_BROADCAST = 0xFFFF;
+
+// Adresse d'un noeud dérivée de son Device ID (repli 32 -> 16 bits),
+// jamais 0x0000 ni 0xFFFF (adresses spéciales du E220)
+inline uint16_t radioAddressOf(uint32_t deviceId) {
+	uint16_t addr = (uint16_t)((deviceId >> 16) ^ (deviceId & 0xFFFF));
+	if (addr == 0x0000) return 0x0001;
+	if (addr == RADIO_ADDR_BROADCAST) return 0xFFFE;
+	return addr;
+}
+
+/**
+ * Interface radio commune aux modules E220 (900 MHz) et XL1278 (433 MHz)
+ *
+ * Polymorphisme statique (CRTP) : les managers sont paramétrés par le type
+ * concret du driver, aucun appel virtuel sur le chemin émission/réception.
+ *
+ * La base gère la file d'émission (non bloquante). Le driver fournit :
+ *   bool canTransmit()                          module libre pour une nouvelle trame
+ *   void transmitFrame(const uint8_t*, size_t, uint16_t dest)
+ *                                               lance l'émission sans attendre la fin
+ *   bool receiveFrame(ByteView& frame)          trame reçue, valide jusqu'à la suivante
+ *   const char* bandName() const                libellé pour les logs ("900MHz", ...)
+ *   int getLastRssi() const / float getLastSnr() const / bool hasSnr() const
+ *                                               mesure radio de la dernière trame reçue
+ *   uint32_t getLastRxTimestamp() const         millis() à la réception de cette trame
+ *   uint32_t timeOnAirUs(size_t len) const      temps d'antenne au débit courant
+ *
+ * Duty cycle : chaque trame émise est imputée au budget de la bande. Une trame
+ * LOW refusée par le budget est abandonnée dès la mise en file ; NORMAL et HIGH
+ * restent en file jusqu'à ce que la fenêtre glissante libère du temps d'antenne.
+ * La file sert la priorité la plus haute d'abord (FIFO à priorité égale).
+ *
+ * Adressage : chaque trame porte une adresse destination (broadcast par défaut).
+ * Le E220 en transmission fixe ne remet au destinataire que les trames qui lui
+ * sont adressées ; le XL1278 n'a pas de filtrage matériel et ignore l'adresse.
+ *
+ * Adaptation de débit : échelle de débits indexée du plus robuste (0)
+ * au plus rapide, identique sur tous les noeuds d'une même bande :
+ *   uint8_t getRateCount() const / getRateIndex() const / getBaseRateIndex() const
+ *   bool setRateIndex(uint8_t index)            bascule (vide la file TX avant)
+ *   const char* getRateName(uint8_t index) const
+ *   int getSensitivityDbm() const               sensibilité au débit courant (marge de lien)
+ *
+ * Contrôle de puissance : échelle indexée de la plus faible (0) à la puissance
+ * nominale (getMaxPowerIndex, celle de Config.h) :
+ *   uint8_t getPowerCount() const / getPowerIndex() const / getMaxPowerIndex() const
+ *   bool setPowerIndex(uint8_t index)
+ *   int getPowerDbm(uint8_t index) const
+ */
+template <class Derived>
+class RadioDriver {
+public:
+	static const size_t MAX_SEND_SIZE = 200;
+	static const uint8_t TX_QUEUE_CAPACITY = 8;
+	
+	// Mise en file d'attente (non bloquant) : l'envoi réel se fait dans processTxQueue()
+	bool sendPacket(const std::vector<uint8_t>& data, TxPriority prio = TX_PRIO_NORMAL,
+	                uint16_t dest = RADIO_ADDR_BROADCAST) {
+		return sendPacket(data.data(), data.size(), prio, dest);
+	}
+	bool sendPacket(const uint8_t* data, size_t len, TxPriority prio = TX_PRIO_NORMAL,
+	                uint16_t dest = RADIO_ADDR_BROADCAST);
+	
+	// Adresse propre (à fixer avant begin) et adresse du pair appairé
+	// (broadcast tant qu'il n'est pas connu)
+	void setLocalAddress(uint16_t addr) { localAddress = addr; }
+	uint16_t getLocalAddress() const { return localAddress; }
+	void setPeerAddress(uint16_t addr) { peerAddress = addr; }
+	uint16_t getPeerAddress() const { return peerAddress; }
+	
+	// Réception avec copie dans un buffer fourni par l'appelant
+	bool receiveFrame(uint8_t* buffer, size_t capacity, size_t& length);
+	
+	// File d'émission : une trame part dès que le driver signale le module libre
+	void processTxQueue();
+	bool flushTxQueue(unsigned long timeoutMs);
+	bool isTxIdle() { return txCount == 0 && derived().canTransmit(); }
+	
+	// Statistiques de la file d'émission
+	uint8_t getTxQueueDepth() const { return txCount; }
+	uint8_t getTxQueueHighWatermark() const { return txHighWatermark; }
+	uint32_t getTxDroppedCount() const { return txDropped; }
+	uint32_t getTxSentCount() const { return txSent; }
+	uint32_t getTxBudgetDroppedCount() const { return txBudgetDropped; }
+	uint32_t getTxDeferredCount() const { return txDeferred; }
+	uint64_t getTxAirtimeTotalUs() const { return txAirtimeTotalUs; }
+	
+	DutyCycleBudget& getDutyCycle() { return dutyCycle; }
+
+protected:
+	explicit RadioDriver(uint16_t dutyCyclePermille)
+		: txCount(0), txHighWatermark(0), txOrder(0),
+		  txDropped(0), txSent(0), txBudgetDropped(0), txDeferred(0), txAirtimeTotalUs(0),
+		  dutyCycle(dutyCyclePermille),
+		  localAddress(RADIO_ADDR_BROADCAST), peerAddress(RADIO_ADDR_BROADCAST) {
+		for (uint8_t i = 0; i < TX_QUEUE_CAPACITY; i++) {
+			txQueue[i].used = false;
+		}
+	}
+	~RadioDriver() {}
+
+private:
+	struct TxSlot {
+		bool used;
+		bool deferred;       // déjà comptée comme différée par le budget
+		uint8_t prio;
+		uint8_t len;
+		uint16_t dest;
+		uint32_t order;      // rang d'arrivée (FIFO à priorité égale)
+		uint8_t data[MAX_SEND_SIZE];
+	};
+	
+	TxSlot txQueue[TX_QUEUE_CAPACITY];
+	uint8_t txCount;
+	uint8_t txHighWatermark;
+	uint32_t txOrder;
+	uint32_t txDropped;
+	uint32_t txSent;
+	uint32_t txBudgetDropped;
+	uint32_t txDeferred;
+	uint64_t txAirtimeTotalUs;
+	DutyCycleBudget dutyCycle;
+	uint16_t localAddress;
+	uint16_t peerAddress;
+	
+	int8_t findFreeSlot(TxPriority prio);
+	int8_t nextSlot() const;
+	
+	Derived& derived() { return *static_cast<Derived*>(this); }
+};
+
+template <class Derived>
+const size_t RadioDriver<Derived>::MAX_SEND_SIZE;
+
+template <class Derived>
+const uint8_t RadioDriver<Derived>::TX_QUEUE_CAPACITY;
+
+template <class Derived>
+bool RadioDriver<Derived>::sendPacket(const uint8_t* data, size_t len, TxPriority prio, uint16_t dest) {
+	if (len == 0) {
+		Serial.println("[LoRa] Erreur: Tentative d'envoi d'un paquet vide");
+		return false;
+	}
+	
+	if (len > MAX_SEND_SIZE) {
+		LogSerialLock lock;
+		Serial.print("[LoRa] ERREUR: Paquet trop grand (");
+		Serial.print(len);
+		Serial.print(" octets, max ");
+		Serial.print(MAX_SEND_SIZE);
+		Serial.println(" octets)");
+		return false;
+	}
+	
+	// Trafic de fond : inutile de l'empiler si la bande n'a plus de budget pour lui
+	if (prio == TX_PRIO_LOW && !dutyCycle.allows(derived().timeOnAirUs(len), prio)) {
+		txBudgetDropped++;
+		return false;
+	}
+	
+	const int8_t index = findFreeSlot(prio);
+	if (index < 0) {
+		txDropped++;
+		LogSerialLock lock;
+		Serial.print("[LoRa] File TX ");
+		Serial.print(derived().bandName());
+		Serial.println(" pleine, paquet abandonné");
+		return false;
+	}
+	
+	TxSlot& slot = txQueue[index];
+	memcpy(slot.data, data, len);
+	slot.len = (uint8_t)len;
+	slot.prio = prio;
+	slot.dest = dest;
+	slot.order = txOrder++;
+	slot.deferred = false;
+	slot.used = true;
+	txCount++;
+	if (txCount > txHighWatermark) {
+		txHighWatermark = txCount;
+	}
+	
+	// Envoi immédiat si le module est déjà libre
+	processTxQueue();
+	return true;
+}
+
+template <class Derived>
+int8_t RadioDriver<Derived>::findFreeSlot(TxPriority prio) {
+	if (txCount < TX_QUEUE_CAPACITY) {
+		for (uint8_t i = 0; i < TX_QUEUE_CAPACITY; i++) {
+			if (!txQueue[i].used) return i;
+		}
+	}
+	
+	// File pleine : une trame prioritaire évince la plus ancienne des moins prioritaires
+	int8_t victim = -1;
+	for (uint8_t i = 0; i < TX_QUEUE_CAPACITY; i++) {
+		const TxSlot& slot = txQueue[i];
+		if (slot.prio >= prio) continue;
+		if (victim < 0 || slot.prio < txQueue[victim].prio ||
+		    (slot.prio == txQueue[victim].prio && (int32_t)(slot.order - txQueue[victim].order) < 0)) {
+			victim = i;
+		}
+	}
+	if (victim >= 0) {
+		txQueue[victim].used = false;
+		txCount--;
+		txDropped++;
+	}
+	return victim;
+}
+
+template <class Derived>
+int8_t RadioDriver<Derived>::nextSlot() const {
+	int8_t best = -1;
+	for (uint8_t i = 0; i < TX_QUEUE_CAPACITY; i++) {
+		const TxSlot& slot = txQueue[i];
+		if (!slot.used) continue;
+		if (best < 0 || slot.prio > txQueue[best].prio ||
+		    (slot.prio == txQueue[best].prio && (int32_t)(slot.order - txQueue[best].order) < 0)) {
+			best = i;
+		}
+	}
+	return best;
+}
+
+template <class Derived>
+bool RadioDriver<Derived>::receiveFrame(uint8_t* buffer, size_t capacity, size_t& length) {
+	length = 0;
+	ByteView frame;
+	if (!derived().receiveFrame(frame)) return false;
+	
+	length = frame.size() < capacity ? frame.size() : capacity;
+	memcpy(buffer, frame.data(), length);
+	return true;
+}
+
+template <class Derived>
+void RadioDriver<Derived>::processTxQueue() {
+	if (txCount == 0) return;
+	if (!derived().canTransmit()) return;
+	
+	const int8_t index = nextSlot();
+	if (index < 0) return;
+	TxSlot& slot = txQueue[index];
+	
+	// Pas de dépassement de priorité : la tête de file attend que le budget se libère
+	const uint32_t airtimeUs = derived().timeOnAirUs(slot.len);
+	if (!dutyCycle.allows(airtimeUs, (TxPriority)slot.prio)) {
+		if (!slot.deferred) {
+			slot.deferred = true;
+			txDeferred++;
+		}
+		return;
+	}
+	
+	derived().transmitFrame(slot.data, slot.len, slot.dest);
+	dutyCycle.spend(airtimeUs);
+	txAirtimeTotalUs += airtimeUs;
+	
+	slot.used = false;
+	txCount--;
+	txSent++;
+}
+
+template <class Derived>
+bool RadioDriver<Derived>::flushTxQueue(unsigned long timeoutMs) {
+	const unsigned long start = millis();
+	while (!isTxIdle()) {
+		if (millis() - start >= timeoutMs) {
+			return false;
+		}
+		processTxQueue();
+		delay(1);
+	}
+	return true;
+}
+
+#endif // RADIO_DRIVER_H
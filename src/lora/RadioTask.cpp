@@ -0,0 +1,95 @@
+#include "../lora/RadioTask.h"
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#include "../utils/Log.h"
+
+template <class Radio>
+RadioTask<Radio>::RadioTask(Radio* radio, RadioBand band, QueueHandle_t rxQueue)
+	: radio(radio), band(band), txQueue(nullptr), rxQueue(rxQueue), handle(nullptr),
+	  txRejected(0), rxOverflow(0) {
+}
+
+template <class Radio>
+bool RadioTask<Radio>::start(const char* name, BaseType_t core) {
+	LogSerialLock lock;
+	txQueue = xQueueCreate(RADIO_TASK_QUEUE_DEPTH, sizeof(RadioFrame));
+	if (!txQueue) {
+		Serial.print("[TASK] ERREUR: file TX ");
+		Serial.print(radio->bandName());
+		Serial.println(" non allouée");
+		return false;
+	}
+	
+	if (xTaskCreatePinnedToCore(taskEntry, name, RADIO_TASK_STACK, this,
+	                            RADIO_TASK_PRIORITY, &handle, core) != pdPASS) {
+		Serial.print("[TASK] ERREUR: tâche ");
+		Serial.print(name);
+		Serial.println(" non créée");
+		return false;
+	}
+	
+	Serial.print("[TASK] ");
+	Serial.print(name);
+	Serial.print(" démarrée sur le coeur ");
+	Serial.println(core);
+	return true;
+}
+
+template <class Radio>
+bool RadioTask<Radio>::submit(const uint8_t* data, size_t len, TxPriority prio) {
+	if (!txQueue || len == 0 || len > Radio::MAX_SEND_SIZE) {
+		txRejected.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	
+	RadioFrame frame;
+	frame.band = band;
+	frame.prio = prio;
+	frame.len = (uint8_t)len;
+	memcpy(frame.data, data, len);
+	if (xQueueSend(txQueue, &frame, 0) != pdTRUE) {
+		txRejected.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+template <class Radio>
+void RadioTask<Radio>::taskEntry(void* arg) {
+	static_cast<RadioTask<Radio>*>(arg)->run();
+}
+
+template <class Radio>
+void RadioTask<Radio>::run() {
+	RadioFrame frame;
+	
+	for (;;) {
+		// Trames soumises par l'application -> file à priorités du driver
+		while (xQueueReceive(txQueue, &frame, 0) == pdTRUE) {
+			if (!radio->sendPacket(frame.data, frame.len, (TxPriority)frame.prio)) {
+				txRejected.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		radio->processTxQueue();
+		
+		ByteView rx;
+		while (radio->receiveFrame(rx)) {
+			frame.band = band;
+			frame.len = rx.size() < sizeof(frame.data) ? (uint8_t)rx.size() : (uint8_t)sizeof(frame.data);
+			memcpy(frame.data, rx.data(), frame.len);
+			frame.rssi = (int16_t)radio->getLastRssi();
+			frame.snr = radio->getLastSnr();
+			frame.timestampMs = radio->getLastRxTimestamp();
+			if (xQueueSend(rxQueue, &frame, 0) != pdTRUE) {
+				rxOverflow++;
+			}
+		}
+		
+		// Un tick : laisse tourner loop() et l'autre radio
+		vTaskDelay(1);
+	}
+}
+
+// Instanciations explicites : une par driver radio
+template class RadioTask<LoRaModule>;
+template class RadioTask<XL1278Module>;
@@ -0,0 +1,64 @@
+#ifndef RADIO_TASK_H
+#define RADIO_TASK_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "../Config.h"
+#include "../utils/DutyCycleBudget.h"
+
+// Bandes (masque : une trame peut être soumise aux deux)
+enum RadioBand : uint8_t {
+	RADIO_BAND_900 = 0x01,
+	RADIO_BAND_433 = 0x02,
+	RADIO_BAND_ALL = RADIO_BAND_900 | RADIO_BAND_433
+};
+
+// Trame échangée entre l'application et une tâche radio (copiée dans les files FreeRTOS)
+struct RadioFrame {
+	uint8_t band;
+	uint8_t prio;          // TxPriority (émission)
+	uint8_t len;
+	int16_t rssi;          // réception
+	float snr;             // réception (0 si le module ne le fournit pas)
+	uint32_t timestampMs;  // réception
+	uint8_t data[MAX_PACKET_SIZE];
+};
+
+/**
+ * Tâche FreeRTOS dédiée à un driver radio
+ *
+ * La tâche est seule à toucher au driver une fois démarrée : elle transfère
+ * les trames soumises vers la file à priorités du driver, pompe processTxQueue()
+ * et pousse les trames reçues dans la file RX (partageable entre plusieurs tâches).
+ * Une émission lente sur une bande ne bloque ainsi ni l'autre bande ni loop().
+ */
+template <class Radio>
+class RadioTask {
+public:
+	RadioTask(Radio* radio, RadioBand band, QueueHandle_t rxQueue);
+	
+	bool start(const char* name, BaseType_t core);
+	
+	// Appelables depuis n'importe quelle tâche (non bloquant)
+	bool submit(const uint8_t* data, size_t len, TxPriority prio);
+	
+	uint32_t getTxRejectedCount() const { return txRejected.load(std::memory_order_relaxed); }
+	uint32_t getRxOverflowCount() const { return rxOverflow; }
+	
+private:
+	Radio* radio;
+	RadioBand band;
+	QueueHandle_t txQueue;
+	QueueHandle_t rxQueue;
+	TaskHandle_t handle;
+	std::atomic<uint32_t> txRejected;   // file de la tâche ou du driver pleine (submit() depuis les deux coeurs)
+	volatile uint32_t rxOverflow;   // file RX applicative pleine
+	
+	static void taskEntry(void* arg);
+	void run();
+};
+
+#endif // RADIO_TASK_H
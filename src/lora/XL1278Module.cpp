@@ -0,0 +1,196 @@
+#include "../lora/XL1278Module.h"
+#include "../utils/AirTime.h"
+
+SpscRing<XL1278Module::RxSlot, XL1278_RX_RING_SLOTS> XL1278Module::rxRing;
+std::atomic<bool> XL1278Module::isrTxDone(false);
+
+// Échelle de spreading factors, du plus robuste au plus rapide
+static const uint8_t XL1278_RATE_SF[XL1278Module::RATE_COUNT] = { 10, 9, 8, 7 };
+static const char* const XL1278_RATE_NAMES[XL1278Module::RATE_COUNT] = { "SF10", "SF9", "SF8", "SF7" };
+// Sensibilité SX1278 à 125 kHz (datasheet)
+static const int16_t XL1278_RATE_SENSITIVITY_DBM[XL1278Module::RATE_COUNT] = { -132, -129, -126, -123 };
+static const int8_t XL1278_POWER_DBM[XL1278Module::POWER_COUNT] = { 2, 5, 8, 11, 14, 17, 20 };
+
+XL1278Module::XL1278Module()
+	: RadioDriver<XL1278Module>(DUTY_CYCLE_PERMILLE_XL1278),
+	  transmitting(false), txStartMs(0), rateIndex(getBaseRateIndex()),
+	  powerIndex(getMaxPowerIndex()), appliedPowerIndex(0xFF), lastRssi(0), lastSnr(0.0f),
+	  lastRxTimestampMs(0), holdingRxSlot(false) {
+}
+
+void XL1278Module::onReceiveIsr(int packetSize) {
+	if (packetSize == 0) return;
+	
+	// File pleine : on vide la FIFO radio, la trame est comptée en débordement
+	RxSlot* slot = rxRing.reserve();
+	if (!slot) {
+		while (LoRa.available()) LoRa.read();
+		return;
+	}
+	
+	uint16_t n = 0;
+	while (LoRa.available() && n < MAX_PACKET_SIZE) {
+		slot->data[n++] = (uint8_t)LoRa.read();
+	}
+	slot->len = n;
+	slot->rssi = (int16_t)LoRa.packetRssi();
+	slot->snr = LoRa.packetSnr();
+	slot->timestampMs = millis();
+	rxRing.commit();
+}
+
+void XL1278Module::onTxDoneIsr() {
+	isrTxDone.store(true, std::memory_order_release);
+}
+
+bool XL1278Module::begin(NVSManager* nvs) {
+	(void)nvs;
+	SPI.begin(PIN_LORA_SCLK, PIN_LORA_MISO, PIN_LORA_MOSI, PIN_LORA_SS);
+	LoRa.setPins(PIN_LORA_SS, PIN_LORA_RST, PIN_LORA_DIO0);
+	
+	Serial.println("[433MHz] Initialisation du module XL1278...");
+	if (!LoRa.begin(LORA_FREQUENCY)) {
+		Serial.println("[433MHz] ERREUR: Echec init XL1278. Vérifiez le câblage.");
+		return false;
+	}
+	
+	LoRa.setSignalBandwidth(LORA_BANDWIDTH);
+	LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR);
+	LoRa.setCodingRate4(LORA_CODING_RATE);
+	LoRa.setTxPower(LORA_TX_POWER_XL);
+	LoRa.setSyncWord(LORA_SYNC_WORD);
+	LoRa.enableCrc();
+	
+	LoRa.onReceive(onReceiveIsr);
+	LoRa.onTxDone(onTxDoneIsr);
+	LoRa.receive();
+	
+	Serial.println("[433MHz] Module XL1278 initialisé avec succès");
+	printConfiguration();
+	return true;
+}
+
+void XL1278Module::printConfiguration() {
+	Serial.print("[433MHz] XL1278-SMT @ ");
+	Serial.print(LORA_FREQUENCY / 1E6);
+	Serial.println("MHz");
+	Serial.print("  Spreading Factor: SF"); Serial.println(LORA_SPREADING_FACTOR);
+	Serial.print("  Bande passante: "); Serial.print(LORA_BANDWIDTH / 1E3); Serial.println(" kHz");
+	Serial.print("  Coding Rate: 4/"); Serial.println(LORA_CODING_RATE);
+	Serial.print("  Puissance TX: "); Serial.print(LORA_TX_POWER_XL); Serial.println(" dBm");
+	Serial.print("  Sync Word: 0x"); Serial.println(LORA_SYNC_WORD, HEX);
+}
+
+uint8_t XL1278Module::getBaseRateIndex() const {
+	for (uint8_t i = 0; i < RATE_COUNT; i++) {
+		if (XL1278_RATE_SF[i] == LORA_SPREADING_FACTOR) return i;
+	}
+	return RATE_COUNT - 1;
+}
+
+const char* XL1278Module::getRateName(uint8_t index) const {
+	return index < RATE_COUNT ? XL1278_RATE_NAMES[index] : "?";
+}
+
+int XL1278Module::getSensitivityDbm() const {
+	return XL1278_RATE_SENSITIVITY_DBM[rateIndex];
+}
+
+uint8_t XL1278Module::getMaxPowerIndex() const {
+	for (uint8_t i = POWER_COUNT; i > 0; i--) {
+		if (XL1278_POWER_DBM[i - 1] <= LORA_TX_POWER_XL) return i - 1;
+	}
+	return 0;
+}
+
+int XL1278Module::getPowerDbm(uint8_t index) const {
+	return index < POWER_COUNT ? XL1278_POWER_DBM[index] : 0;
+}
+
+bool XL1278Module::setPowerIndex(uint8_t index) {
+	if (index > getMaxPowerIndex()) return false;
+	// Appliqué trame par trame dans transmitFrame (accès SPI, sans coût)
+	powerIndex = index;
+	return true;
+}
+
+uint32_t XL1278Module::timeOnAirUs(size_t len) const {
+	return AirTime::loraUs(len, XL1278_RATE_SF[rateIndex], (uint32_t)LORA_BANDWIDTH, LORA_CODING_RATE);
+}
+
+bool XL1278Module::setRateIndex(uint8_t index) {
+	if (index >= RATE_COUNT) return false;
+	if (index == rateIndex) return true;
+	
+	// Les trames en file partent encore avec l'ancien SF
+	if (!flushTxQueue(2000)) {
+		Serial.println("[433MHz] ATTENTION: File TX non vidée avant changement de SF");
+	}
+	
+	LoRa.idle();
+	LoRa.setSpreadingFactor(XL1278_RATE_SF[index]);
+	LoRa.receive();
+	
+	Serial.print("[433MHz] Débit: ");
+	Serial.print(XL1278_RATE_NAMES[rateIndex]);
+	Serial.print(" -> ");
+	Serial.println(XL1278_RATE_NAMES[index]);
+	rateIndex = index;
+	return true;
+}
+
+bool XL1278Module::canTransmit() {
+	if (!transmitting) return true;
+	
+	const bool txDone = isrTxDone.load(std::memory_order_acquire);
+	if (txDone || millis() - txStartMs >= TX_DONE_TIMEOUT_MS) {
+		if (!txDone) {
+			Serial.println("[433MHz] ATTENTION: TX done non reçu, reprise forcée");
+		}
+		isrTxDone.store(false, std::memory_order_relaxed);
+		transmitting = false;
+		// Retour en réception continue après l'émission
+		LoRa.receive();
+		return true;
+	}
+	return false;
+}
+
+void XL1278Module::transmitFrame(const uint8_t* data, size_t len, uint16_t dest) {
+	// Pas de filtrage par adresse ; seule la puissance dépend du destinataire
+	const uint8_t txPower = (dest == RADIO_ADDR_BROADCAST) ? getMaxPowerIndex() : powerIndex;
+	if (txPower != appliedPowerIndex) {
+		LoRa.setTxPower(XL1278_POWER_DBM[txPower]);
+		appliedPowerIndex = txPower;
+	}
+	
+	isrTxDone.store(false, std::memory_order_relaxed);
+	if (!LoRa.beginPacket()) {
+		// Le module émet encore : la trame est perdue, comme un échec radio
+		Serial.println("[433MHz] ERREUR: Module occupé, trame non émise");
+		return;
+	}
+	LoRa.write(data, len);
+	// Non bloquant : la fin d'émission est signalée par onTxDoneIsr()
+	LoRa.endPacket(true);
+	transmitting = true;
+	txStartMs = millis();
+}
+
+bool XL1278Module::receiveFrame(ByteView& frame) {
+	// La vue précédente n'est plus utilisée : son slot retourne à l'interruption
+	if (holdingRxSlot) {
+		rxRing.pop();
+		holdingRxSlot = false;
+	}
+	
+	const RxSlot* slot = rxRing.front();
+	if (!slot) return false;
+	
+	holdingRxSlot = true;
+	lastRssi = slot->rssi;
+	lastSnr = slot->snr;
+	lastRxTimestampMs = slot->timestampMs;
+	frame = ByteView(slot->data, slot->len);
+	return true;
+}
@@ -0,0 +1,107 @@
+#ifndef XL1278_MODULE_H
+#define XL1278_MODULE_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <LoRa.h>
+#include "../lora/LoRaConfig_XL1278.h"
+#include "../lora/RadioDriver.h"
+#include "../utils/ByteView.h"
+#include "../utils/SpscRing.h"
+#include <atomic>
+
+class NVSManager;
+
+/**
+ * Driver XL1278-SMT (SX1278, SPI, 433 MHz) pour la pile sécurisée
+ *
+ * Même interface que LoRaModule (RadioDriver) : émission asynchrone
+ * (endPacket(true) + callback TX done), réception par callback DIO0 dans une
+ * file sans verrou de XL1278_RX_RING_SLOTS trames (rafales sans perte).
+ * La bibliothèque LoRa étant un singleton, une seule instance est permise.
+ */
+class XL1278Module : public RadioDriver<XL1278Module> {
+public:
+	// Garde-fou si l'interruption TX done est manquée (SF7/125 kHz : < 400 ms pour 255 octets)
+	static const unsigned long TX_DONE_TIMEOUT_MS = 1000;
+	
+	XL1278Module();
+	
+	// nvs inutilisé : le SX1278 est configuré à chaque démarrage (accès SPI direct, rapide)
+	bool begin(NVSManager* nvs = nullptr);
+	void printConfiguration();
+	
+	// Réception sans allocation ni copie : vue sur le slot de la file RX,
+	// valide jusqu'à la réception suivante (le slot est alors libéré)
+	bool receiveFrame(ByteView& frame);
+	using RadioDriver<XL1278Module>::receiveFrame;
+	
+	// Qualité de la dernière trame reçue
+	int getLastRssi() const { return lastRssi; }
+	float getLastSnr() const { return lastSnr; }
+	bool hasSnr() const { return true; }
+	
+	// Interface RadioDriver (pas de filtrage matériel : dest ne sert qu'au choix de la puissance)
+	bool canTransmit();
+	void transmitFrame(const uint8_t* data, size_t len, uint16_t dest);
+	const char* bandName() const { return "433MHz"; }
+	
+	// Adaptation de débit : SF10 -> SF7 à 125 kHz, LORA_SPREADING_FACTOR = débit de base
+	static const uint8_t RATE_COUNT = 4;
+	uint8_t getRateCount() const { return RATE_COUNT; }
+	uint8_t getRateIndex() const { return rateIndex; }
+	uint8_t getBaseRateIndex() const;
+	bool setRateIndex(uint8_t index);
+	const char* getRateName(uint8_t index) const;
+	
+	int getSensitivityDbm() const;
+	
+	// Contrôle de puissance : 2 -> 20 dBm (PA_BOOST) par pas de 3 dB,
+	// LORA_TX_POWER_XL = puissance nominale. Les trames broadcast partent toujours
+	// à la puissance nominale (beacons, appairage) : le réglage vise le pair.
+	static const uint8_t POWER_COUNT = 7;
+	uint8_t getPowerCount() const { return POWER_COUNT; }
+	uint8_t getPowerIndex() const { return powerIndex; }
+	uint8_t getMaxPowerIndex() const;
+	bool setPowerIndex(uint8_t index);
+	int getPowerDbm(uint8_t index) const;
+	
+	// Temps d'antenne au SF courant
+	uint32_t timeOnAirUs(size_t len) const;
+	
+	// Horodatage (millis) de la dernière trame reçue, pris dans l'interruption
+	uint32_t getLastRxTimestamp() const { return lastRxTimestampMs; }
+	
+	// Trames perdues parce que la file RX était pleine
+	uint32_t getRxDroppedCount() const { return rxRing.getOverflowCount(); }
+	uint32_t getRxRingHighWatermark() const { return rxRing.getHighWatermark(); }
+	
+private:
+	// Trame reçue, remplie dans l'interruption (mesures radio prises au même instant)
+	struct RxSlot {
+		uint32_t timestampMs;
+		int16_t rssi;
+		float snr;
+		uint16_t len;
+		uint8_t data[MAX_PACKET_SIZE];
+	};
+	
+	bool transmitting;
+	unsigned long txStartMs;
+	uint8_t rateIndex;
+	uint8_t powerIndex;
+	uint8_t appliedPowerIndex;  // puissance programmée dans le SX1278 (0xFF = celle de begin)
+	int lastRssi;
+	float lastSnr;
+	uint32_t lastRxTimestampMs;
+	bool holdingRxSlot;  // slot en tête encore exposé par la dernière vue
+	
+	// Partagés avec les callbacks (contexte interruption)
+	static SpscRing<RxSlot, XL1278_RX_RING_SLOTS> rxRing;
+	static std::atomic<bool> isrTxDone;
+	
+	static void onReceiveIsr(int packetSize);
+	static void onTxDoneIsr();
+};
+
+#endif // XL1278_MODULE_H
@@ -33,7 +33,12 @@
 
 #elif defined(MODULE_XL1278_433)
 	// Module XL1278-SMT (SPI, 433 MHz) uniquement
-	#include "modes/main_xl1278.cpp"
+	#ifdef MODE_SIMPLE
+		#include "modes/main_xl1278.cpp"
+	#else
+		// Mode complet : appairage et sécurité sur 433 MHz
+		#include "modes/main_complet.cpp"
+	#endif
 
 #else
 	#error "Aucun module sélectionné! Décommentez MODULE_E220_900, MODULE_XL1278_433 ou MODULE_DUAL dans main.cpp"
@@ -3,50 +3,127 @@
 #include "../storage/NVSManager.h"
 #include "../security/SecurityManager.h"
 #include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
 #include "../security/PairingManager.h"
 #include "../protocol/FragmentManager.h"
 #include "../utils/HeartbeatManager.h"
 #include "../security/DiscoveryManager.h"
+#include "../protocol/AdaptiveRateController.h"
+#include "../protocol/TransmitPowerController.h"
+#include "../utils/LinkQualityTable.h"
+#include "../utils/BootProfiler.h"
 #include "../lora/PacketHandler.h"
+#include "../utils/PowerMeter.h"
+#include "../utils/Log.h"
+
+// Bande utilisée par la pile sécurisée (choix à la compilation, voir Config.h)
+#if defined(MODULE_XL1278_433) || defined(SECURE_BAND_433)
+typedef XL1278Module SecureRadio;
+#else
+#define SECURE_RADIO_E220
+typedef LoRaModule SecureRadio;
+#endif
 
 // Variables globales pour les managers
 static NVSManager* nvsManager = nullptr;
 static SecurityManager* securityManager = nullptr;
-static LoRaModule* loraModule = nullptr;
-static PairingManager* pairingManager = nullptr;
-static FragmentManager* fragmentManager = nullptr;
-static HeartbeatManager* heartbeatManager = nullptr;
-static DiscoveryManager* discoveryManager = nullptr;
-static PacketHandler* packetHandler = nullptr;
+static SecureRadio* loraModule = nullptr;
+static PairingManager<SecureRadio>* pairingManager = nullptr;
+static FragmentManager<SecureRadio>* fragmentManager = nullptr;
+static HeartbeatManager<SecureRadio>* heartbeatManager = nullptr;
+static DiscoveryManager<SecureRadio>* discoveryManager = nullptr;
+static AdaptiveRateController<SecureRadio>* rateController = nullptr;
+static TransmitPowerController<SecureRadio>* powerController = nullptr;
+static LinkQualityTable* linkQuality = nullptr;
+static PacketHandler<SecureRadio>* packetHandler = nullptr;
 
 // État global
 static uint32_t deviceId = 0xA1B2C3D4;
 static uint32_t seqNumber = 0;
 
+#ifdef SECURE_RADIO_E220
+// Bilan énergétique (commande POWER) et profil wake-on-radio (Config.h, WOR_ROLE)
+static PowerMeter* powerMeter = nullptr;
+static unsigned long lastRadioActivityMs = 0;
+
+#if WOR_ROLE != WOR_ROLE_NONE
+static_assert(WOR_HEARTBEAT_INTERVAL_MS % WOR_WAKE_PERIOD_MS == 0,
+              "WOR_HEARTBEAT_INTERVAL_MS doit être un multiple de WOR_WAKE_PERIOD_MS");
+#endif
+
+static const char* worRoleName() {
+	#if WOR_ROLE == WOR_ROLE_SLEEPER
+	return "WOR SLEEPER (batterie)";
+	#elif WOR_ROLE == WOR_ROLE_WAKER
+	return "WOR WAKER";
+	#else
+	return "écoute continue";
+	#endif
+}
+
+#if WOR_ROLE == WOR_ROLE_SLEEPER
+// Noeud sur batterie : E220 en mode 2 et ESP32 en light sleep jusqu'au
+// prochain heartbeat ou à l'arrivée d'une trame (AUX bas)
+static void sleepIfIdle() {
+	// Joignable en continu tant que l'appairage n'est pas établi
+	if (!pairingManager->isPaired() || discoveryManager->isPairingMode() || pairingManager->hasPendingBind()) return;
+	if (fragmentManager->isTransmitting() || fragmentManager->hasPendingMessages() || !loraModule->isTxIdle()) {
+		lastRadioActivityMs = millis();
+		return;
+	}
+	if (millis() - lastRadioActivityMs < WOR_AWAKE_WINDOW_MS) return;
+	
+	const unsigned long sleepMs = heartbeatManager->msUntilNextHeartbeat();
+	if (sleepMs < WOR_MIN_SLEEP_MS) return;
+	if (!loraModule->enterWorReceive()) return;
+	powerMeter->setRadioState(RADIO_PWR_WOR);
+	
+	Serial.flush();
+	powerMeter->lightSleep(PIN_LORA_AUX, sleepMs);
+	// Retour immédiat en mode 0 : en mode 2, le module n'émettrait pas la
+	// réponse et resterait sourd aux trames sans préambule de réveil
+	loraModule->setMode(MODE_0_NORMAL);
+	powerMeter->setRadioState(RADIO_PWR_RX);
+	// Fenêtre d'écoute après le réveil : trame entrante, ou réponse au heartbeat qui part
+	lastRadioActivityMs = millis();
+}
+#endif
+#endif
+
 void setup() {
+  BootProfiler boot;
   Serial.begin(115200);
   while (!Serial) {}
+  Log::begin();
+  boot.mark("Série");
 
   Serial.println();
+  #ifdef SECURE_RADIO_E220
   Serial.println("==== Demo LoRa ESP32 (E220-900T22D LLCC68) ====");
-  #if E220_PIN_MODE == MODE_MINIMAL
+  #else
+  Serial.println("==== Demo LoRa ESP32 (XL1278-SMT SX1278, 433 MHz) ====");
+  #endif
+  #if !defined(SECURE_RADIO_E220)
+  Serial.println("Pile sécurisée sur 433 MHz (SF7)");
+  #elif E220_PIN_MODE == MODE_MINIMAL
   Serial.println("Mode pins: MINIMAL (RX+TX seulement)");
   #elif E220_PIN_MODE == MODE_RECOMMANDE
   Serial.println("Mode pins: RECOMMANDE (RX+TX+AUX)");
   #elif E220_PIN_MODE == MODE_COMPLET
   Serial.println("Mode pins: COMPLET (RX+TX+AUX+M0+M1)");
   #endif
-  
+	
 	// Initialiser les managers
 	nvsManager = new NVSManager();
 	securityManager = new SecurityManager();
-	loraModule = new LoRaModule();
+	loraModule = new SecureRadio();
 	
 	// Initialiser le SecurityManager
 	if (!securityManager->init()) {
 		Serial.println("[SEC] ERREUR: Echec init SecurityManager");
 		while (true) delay(1000);
 	}
+	boot.mark("Sécurité (RNG + clés ECDH)");
 	
 	// Charger ou générer le Device ID
 	if (!nvsManager->loadDeviceId(deviceId)) {
@@ -55,42 +132,80 @@ void setup() {
 	
 	Serial.print("Device ID: 0x");
 	Serial.println(deviceId, HEX);
+	boot.mark("NVS Device ID");
+	
+	// Adresse radio dérivée du Device ID (transmission fixe E220, voir Config.h)
+	loraModule->setLocalAddress(radioAddressOf(deviceId));
 	
 	// Initialiser le module LoRa
-	if (!loraModule->begin()) {
+	if (!loraModule->begin(nvsManager)) {
 		Serial.println("[LoRa] ERREUR: Echec init LoRa");
 		while (true) delay(1000);
 	}
+	boot.mark("Radio");
 	
 	// Initialiser les autres managers
-	pairingManager = new PairingManager(securityManager, loraModule, nvsManager);
+	pairingManager = new PairingManager<SecureRadio>(securityManager, loraModule, nvsManager);
 	pairingManager->setDeviceId(deviceId);
 	
-	fragmentManager = new FragmentManager(securityManager, loraModule);
-	heartbeatManager = new HeartbeatManager(securityManager, loraModule);
-	discoveryManager = new DiscoveryManager(loraModule);
-	packetHandler = new PacketHandler(pairingManager, fragmentManager, 
-	                                  heartbeatManager, discoveryManager);
+	fragmentManager = new FragmentManager<SecureRadio>(securityManager, loraModule);
+	heartbeatManager = new HeartbeatManager<SecureRadio>(securityManager, loraModule);
+	discoveryManager = new DiscoveryManager<SecureRadio>(loraModule);
+	linkQuality = new LinkQualityTable();
+	heartbeatManager->setLinkQualityTable(linkQuality);
+	discoveryManager->setLinkQualityTable(linkQuality);
+	packetHandler = new PacketHandler<SecureRadio>(pairingManager, fragmentManager, 
+	                                               heartbeatManager, discoveryManager);
+	rateController = new AdaptiveRateController<SecureRadio>(securityManager, loraModule, fragmentManager,
+	                                                         nvsManager);
+	packetHandler->setRateController(rateController);
+	powerController = new TransmitPowerController<SecureRadio>(loraModule, fragmentManager, heartbeatManager);
 	
 	// Charger l'état d'appairage
 	pairingManager->loadPairingState();
 	
+	#ifdef SECURE_RADIO_E220
+	powerMeter = new PowerMeter();
+	#if WOR_ROLE != WOR_ROLE_NONE
+	// Heartbeats alignés sur la période de réveil ; le noeud WAKER ne fait que répondre
+	heartbeatManager->setInterval(WOR_HEARTBEAT_INTERVAL_MS);
+	heartbeatManager->setReplyOnly(WOR_ROLE == WOR_ROLE_WAKER);
+	#endif
+	Serial.print("[POWER] Profil: ");
+	Serial.println(worRoleName());
+	#endif
+	
 	Serial.print("[NVS] État d'appairage au démarrage: ");
 	Serial.println(pairingManager->isPaired() ? "Appairé" : "Non appairé");
+	boot.mark("Managers + état d'appairage");
 	
 	Serial.println("Mode: BIDIRECTIONNEL (RX/TX)");
+	boot.print();
 }
 
 void loop() {
+	#if defined(SECURE_RADIO_E220) && WOR_ROLE == WOR_ROLE_WAKER
+	// Pair entendu il y a moins d'une fenêtre d'écoute : encore éveillé, pas de préambule long
+	loraModule->setWakePreamble(millis() - lastRadioActivityMs >= WOR_AWAKE_WINDOW_MS);
+	#endif
+	
+	// Émission des paquets en file (dès que AUX indique le module libre)
+	loraModule->processTxQueue();
+	
 	// Réception de paquets
-	if (loraModule->available()) {
-		std::vector<uint8_t> buffer;
-		if (loraModule->receiveMessage(buffer)) {
-			packetHandler->handlePacket(buffer, deviceId, 
-			                           pairingManager->isPaired(),
-			                           pairingManager->getSessionKey(),
-			                           pairingManager);
-		}
+	// La trame reste dans le buffer du module : aucune allocation jusqu'au dispatch
+	ByteView frame;
+	if (loraModule->receiveFrame(frame)) {
+		#ifdef SECURE_RADIO_E220
+		lastRadioActivityMs = millis();
+		#if WOR_ROLE == WOR_ROLE_WAKER
+		loraModule->setWakePreamble(false);
+		#endif
+		#endif
+		packetHandler->handlePacket(frame, deviceId, 
+		                           pairingManager->isPaired(),
+		                           pairingManager->getSessionKey(),
+		                           pairingManager);
 	}
 	
 	// Envoi de beacons (si mode pairing activé)
@@ -109,14 +224,31 @@ void loop() {
 	fragmentManager->purgeOldFragments();
 	fragmentManager->processPendingRetries();
 	
+	// Adaptation du débit (négociée avec le pair)
+	rateController->process(deviceId, pairingManager->getSessionKey(),
+	                        pairingManager->isPaired(),
+	                        heartbeatManager->isPairedDeviceOnline());
+	
+	// Puissance d'émission (retour RSSI du pair dans ses heartbeats)
+	powerController->process(pairingManager->isPaired(),
+	                         heartbeatManager->isPairedDeviceOnline(),
+	                         pairingManager->getPairedDeviceId());
+	
 	// Mise à jour de l'état en ligne
 	heartbeatManager->updateAndSendOnlineStatus(pairingManager->isPaired(),
 	                                           pairingManager->getPairedDeviceId());
 	
+	#ifdef SECURE_RADIO_E220
+	powerMeter->setRadioState(loraModule->isWorReceiving() ? RADIO_PWR_WOR : RADIO_PWR_RX);
+	powerMeter->setTxAirtimeTotalUs(loraModule->getTxAirtimeTotalUs());
+	#endif
+	
 	// Commandes série
 	if (Serial.available()) {
 		String line = Serial.readStringUntil('\n');
 		line.trim();
+		// Réponses en Serial.print directs : un bloc, sans ligne du journal au milieu
+		LogSerialLock serialLock;
 		
 		if (line.equalsIgnoreCase("ID")) {
 			Serial.print("DeviceId: 0x");
@@ -160,6 +292,7 @@ void loop() {
 		} 
 		else if (line.equalsIgnoreCase("LIST")) {
 			discoveryManager->printDiscoveredIfDue();
+			linkQuality->print();
 		} 
 		else if (line.length() > 2 && (line[0] == 'S' || line[0] == 's') && line[1] == ' ') {
 			// S <message> - Envoyer un message sécurisé
@@ -170,6 +303,49 @@ void loop() {
 				Serial.println("[SEC] Non appairé.");
 			}
 		} 
+		else if (line.equalsIgnoreCase("RATE ON")) {
+			rateController->setEnabled(true);
+			Serial.println("[RATE] Adaptation automatique: ON");
+		} 
+		else if (line.equalsIgnoreCase("RATE OFF")) {
+			rateController->setEnabled(false);
+			Serial.println("[RATE] Adaptation automatique: OFF");
+		} 
+		else if (line.length() > 5 && line.substring(0, 5).equalsIgnoreCase("RATE ")) {
+			// RATE <index> - Négocier un débit (0 = le plus robuste)
+			int index = line.substring(5).toInt();
+			if (!pairingManager->isPaired()) {
+				Serial.println("[RATE] Non appairé.");
+			} else if (!rateController->requestRate((uint8_t)index)) {
+				Serial.println("[RATE] Demande refusée (index invalide, identique ou négociation en cours)");
+			}
+		} 
+		else if (line.equalsIgnoreCase("FEC ON")) {
+			// Parité Reed-Solomon sur les messages fragmentés (à activer sur les deux pairs)
+			fragmentManager->setFecEnabled(true);
+			Serial.println("[FEC] Code correcteur: ON");
+		} 
+		else if (line.equalsIgnoreCase("FEC OFF")) {
+			fragmentManager->setFecEnabled(false);
+			Serial.println("[FEC] Code correcteur: OFF");
+		} 
+		else if (line.length() > 7 && line.substring(0, 7).equalsIgnoreCase("WINDOW ")) {
+			// WINDOW <n> - Fragments émis sans attendre leur ACK (1 = arrêt et attente)
+			int size = line.substring(7).toInt();
+			if (size < 1) size = 1;
+			if (size > FragmentManager<SecureRadio>::MAX_WINDOW_SIZE) size = FragmentManager<SecureRadio>::MAX_WINDOW_SIZE;
+			fragmentManager->setWindowSize((uint8_t)size);
+			Serial.print("[FRAG] Fenêtre d'émission: ");
+			Serial.println(fragmentManager->getWindowSize());
+		} 
+		else if (line.equalsIgnoreCase("TPC ON")) {
+			powerController->setEnabled(true);
+			Serial.println("[TPC] Contrôle de puissance: ON");
+		} 
+		else if (line.equalsIgnoreCase("TPC OFF")) {
+			powerController->setEnabled(false);
+			Serial.println("[TPC] Contrôle de puissance: OFF (puissance nominale)");
+		} 
 		else if (line.equalsIgnoreCase("UNPAIR")) {
 			pairingManager->clearPairingState();
 		} 
@@ -178,6 +354,10 @@ void loop() {
 			Serial.println(pairingManager->isPaired() ? "Appairé" : "Non appairé");
 			Serial.print("[STATUS] Device ID: 0x");
 			Serial.println(deviceId, HEX);
+			Serial.print("[STATUS] Adresse radio: 0x");
+			Serial.print(loraModule->getLocalAddress(), HEX);
+			Serial.print(", pair: 0x");
+			Serial.println(loraModule->getPeerAddress(), HEX);
 			Serial.print("[STATUS] Mode pairing: ");
 			Serial.println(discoveryManager->isPairingMode() ? "ON" : "OFF");
 			if (pairingManager->isPaired()) {
@@ -189,6 +369,38 @@ void loop() {
 					Serial.println(pairingManager->getPairedDeviceId(), HEX);
 				}
 			}
+			Serial.print("[STATUS] File TX ");
+			Serial.print(loraModule->bandName());
+			Serial.print(": ");
+			Serial.print(loraModule->getTxQueueDepth());
+			Serial.print("/");
+			Serial.print(SecureRadio::TX_QUEUE_CAPACITY);
+			Serial.print(" (max ");
+			Serial.print(loraModule->getTxQueueHighWatermark());
+			Serial.print(", envoyés ");
+			Serial.print(loraModule->getTxSentCount());
+			Serial.print(", perdus ");
+			Serial.print(loraModule->getTxDroppedCount());
+			Serial.print(", hors budget ");
+			Serial.print(loraModule->getTxBudgetDroppedCount());
+			Serial.print(", différés ");
+			Serial.print(loraModule->getTxDeferredCount());
+			Serial.println(")");
+			loraModule->getDutyCycle().print(loraModule->bandName());
+			rateController->printStatus();
+			powerController->printStatus();
+			fragmentManager->printStatus();
+			Serial.print("[STATUS] Journal: file max ");
+			Serial.print(Log::getHighWatermark());
+			Serial.print("/");
+			Serial.print(LOG_RING_SLOTS);
+			Serial.print(", perdus ");
+			Serial.println(Log::getDroppedCount());
+		} 
+#ifdef SECURE_RADIO_E220
+		else if (line.equalsIgnoreCase("POWER")) {
+			// POWER - Courant moyen estimé depuis le démarrage
+			powerMeter->print(worRoleName());
 		} 
 		else if (line.equalsIgnoreCase("CONFIG")) {
 			// CONFIG - Forcer la configuration du module
@@ -205,6 +417,11 @@ void loop() {
 			Serial.println("[LoRa] Commande RESET disponible uniquement en mode COMPLET");
 			#endif
 		}
+#endif
 	}
+	
+	#if defined(SECURE_RADIO_E220) && WOR_ROLE == WOR_ROLE_SLEEPER
+	sleepIfIdle();
+	#endif
 }
 
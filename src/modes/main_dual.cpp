@@ -1,10 +1,8 @@
 #include <Arduino.h>
-#include <HardwareSerial.h>
-#include <SPI.h>
-#include <LoRa.h>
-#include <LoRa_E220.h>
 #include "../lora/LoRaConfig.h"
 #include "../lora/LoRaConfig_XL1278.h"
+#include "../lora/DualBandRadio.h"
+#include "../utils/Log.h"
 
 #ifdef USE_CUSTOM_PROTOCOL
 #include "../protocol/MessageProtocol.h"
@@ -20,16 +18,11 @@
 // E220-900T22D (900 MHz) sur UART
 // XL1278-SMT (433 MHz) sur SPI
 
-// HardwareSerial pour E220 (UART2 sur ESP32)
-HardwareSerial SerialE220(2);
-
-// Objet LoRa_E220 avec tous les pins
-LoRa_E220 e220ttl(&SerialE220, PIN_LORA_AUX, PIN_LORA_M0, PIN_LORA_M1);
-
-// Variables globales pour XL1278
-uint8_t receivedBuffer433[PROTOCOL_MAX_MSG_SIZE];
-int receivedBytes433 = 0;
-bool messageReceived433 = false;
+// Drivers radio : chacun est piloté par sa propre tâche FreeRTOS (DualBandRadio),
+// loop() ne fait que soumettre des trames et lire la file de réception commune
+LoRaModule* module900 = nullptr;
+XL1278Module* module433 = nullptr;
+DualBandRadio* dualRadio = nullptr;
 
 // Variables pour gestion PING/PONG
 uint32_t lastPingTimestamp900 = 0;
@@ -37,108 +30,44 @@ bool waitingForPong900 = false;
 uint32_t lastPingTimestamp433 = 0;
 bool waitingForPong433 = false;
 
-// Callback pour réception de messages sur XL1278 (433 MHz)
-void onReceive433(int packetSize) {
-    if (packetSize == 0) return;
-    
-    // Lire les octets bruts dans le buffer
-    receivedBytes433 = 0;
-    while (LoRa.available() && receivedBytes433 < PROTOCOL_MAX_MSG_SIZE) {
-        receivedBuffer433[receivedBytes433++] = (uint8_t)LoRa.read();
-    }
-    messageReceived433 = true;
-}
+#ifdef USE_CUSTOM_PROTOCOL
+// Trames radar compactes reçues sur les deux bandes : références des deltas, par source
+SensorFrameDecoder sensorFrameDecoder;
 
-void configureE220() {
-    Serial.println("[900MHz] Configuration du module E220...");
+void trackSensorFrame(const ProtocolMessageView& msg, const char* prefix) {
+    if (!MessageProtocol::isCompactSensorData(msg)) return;
     
-    // Mettre en mode configuration
-    e220ttl.setMode(MODE_3_CONFIGURATION);
-    delay(300);
-    
-    // Lire la configuration actuelle
-    ResponseStructContainer c = e220ttl.getConfiguration();
-    if (c.status.getResponseDescription() == "Success") {
-        Configuration configuration = *(Configuration*)c.data;
-        
-        // Afficher la configuration actuelle
-        float currentFreq = calculateFrequency900MHz(configuration.CHAN);
-        Serial.print("[900MHz] Configuration actuelle: CHAN=");
-        Serial.print(configuration.CHAN);
-        Serial.print(" -> ");
-        Serial.print(currentFreq, 3);
-        Serial.println(" MHz");
-        
-        // Configurer pour mode transparent
-        configuration.ADDH = CONFIG_ADDH;
-        configuration.ADDL = CONFIG_ADDL;
-        configuration.CHAN = CONFIG_CHAN;
-        configuration.SPED.airDataRate = AIR_DATA_RATE_010_24;
-        configuration.SPED.uartBaudRate = UART_BPS_9600;
-        configuration.SPED.uartParity = MODE_00_8N1;
-        configuration.OPTION.transmissionPower = POWER_22;
-        configuration.OPTION.RSSIAmbientNoise = RSSI_AMBIENT_NOISE_DISABLED;
-        configuration.TRANSMISSION_MODE.fixedTransmission = FT_TRANSPARENT_TRANSMISSION;
-        configuration.TRANSMISSION_MODE.enableRSSI = RSSI_DISABLED;
-        configuration.TRANSMISSION_MODE.enableLBT = LBT_DISABLED;
-        configuration.TRANSMISSION_MODE.WORPeriod = WOR_2000_011;
-        
-        // Afficher la nouvelle fréquence configurée
-        float newFreq = calculateFrequency900MHz(CONFIG_CHAN);
-        Serial.print("[900MHz] Nouvelle config: CHAN=");
-        Serial.print(CONFIG_CHAN);
-        Serial.print(" -> ");
-        Serial.print(newFreq, 3);
-        Serial.println(" MHz");
-        
-        // Sauvegarder la configuration
-        ResponseStatus rs = e220ttl.setConfiguration(configuration, WRITE_CFG_PWR_DWN_SAVE);
-        if (rs.getResponseDescription() == "Success") {
-            Serial.println("[900MHz] Configuration sauvegardée avec succès!");
-        } else {
-            Serial.print("[900MHz] Erreur sauvegarde: ");
-            Serial.println(rs.getResponseDescription());
-        }
-        
-        c.close();
-    } else {
-        Serial.println("[900MHz] Erreur lecture configuration");
+    SensorFrame frame;
+    if (!sensorFrameDecoder.decode(msg, frame)) {
+        LOG_INFO(LOG_CAT_PROTO, "%tDelta radar sans référence, attente de la prochaine keyframe", LogData(prefix));
+        return;
+    }
+    // Les keyframes sont déjà affichées en clair par printMessage
+    if (!MessageProtocol::isSensorKeyframe(msg)) {
+        LOG_INFO(LOG_CAT_PROTO, "%tCibles reconstruites : %u", LogData(prefix), frame.count);
+        MessageProtocol::printSensorTargets(frame, prefix);
     }
-    
-    // Revenir en mode normal
-    e220ttl.setMode(MODE_0_NORMAL);
-    delay(200);
-    Serial.println("[900MHz] Module en mode normal");
 }
 
-void configureXL1278() {
-    Serial.println("[433MHz] Configuration du module XL1278...");
-    
-    // Configuration des paramètres LoRa
-    LoRa.setSignalBandwidth(LORA_BANDWIDTH);
-    LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR);
-    LoRa.setCodingRate4(LORA_CODING_RATE);
-    LoRa.setTxPower(LORA_TX_POWER_XL);
-    LoRa.setSyncWord(LORA_SYNC_WORD);
-    
-    Serial.println("[433MHz] Paramètres configurés:");
-    Serial.print("  - Fréquence: ");
-    Serial.print(LORA_FREQUENCY / 1E6);
-    Serial.println(" MHz");
-    Serial.print("  - Bande passante: ");
-    Serial.print(LORA_BANDWIDTH / 1E3);
-    Serial.println(" kHz");
-    Serial.print("  - Spreading Factor: SF");
-    Serial.println(LORA_SPREADING_FACTOR);
-    Serial.print("  - Puissance TX: ");
-    Serial.print(LORA_TX_POWER_XL);
-    Serial.println(" dBm");
-    Serial.println("[433MHz] Module configuré avec succès!");
+// Deltas radar, y compris ceux groupés dans un lot
+void trackSensorFrames(const ProtocolMessageView& msg, const char* prefix) {
+    if (msg.type() != MSG_TYPE_BATCH) {
+        trackSensorFrame(msg, prefix);
+        return;
+    }
+    ProtocolBatchReader reader(msg);
+    ProtocolMessageView record;
+    uint16_t ageDs;
+    while (reader.next(record, ageDs)) {
+        trackSensorFrame(record, prefix);
+    }
 }
+#endif
 
 void setup() {
     Serial.begin(115200);
     while (!Serial) {}
+    Log::begin();
     
     Serial.println();
     Serial.println("========================================");
@@ -151,19 +80,15 @@ void setup() {
     // ====================================
     Serial.println();
     Serial.println("[900MHz] === Initialisation E220-900T22D ===");
-    SerialE220.begin(9600, SERIAL_8N1, PIN_LORA_RX, PIN_LORA_TX);
-    SerialE220.setTimeout(600);
-    delay(500);
-    
-    Serial.println("[900MHz] Initialisation...");
-    if (!e220ttl.begin()) {
+    module900 = new LoRaModule();
+    // Pas de pair unique : adresse 0xFFFF, le module reçoit toutes les trames
+    module900->setLocalAddress(RADIO_ADDR_BROADCAST);
+    if (!module900->begin()) {
         Serial.println("[900MHz] ERREUR: Echec initialisation!");
         Serial.println("[900MHz] Le système continuera avec le module 433 MHz uniquement");
+        delete module900;
+        module900 = nullptr;
     } else {
-        Serial.println("[900MHz] Module initialisé");
-        delay(300);
-        configureE220();
-        
         float finalFreq = calculateFrequency900MHz(CONFIG_CHAN);
         Serial.print("[900MHz] Fréquence finale: ");
         Serial.print(finalFreq, 3);
@@ -175,25 +100,20 @@ void setup() {
     // ====================================
     Serial.println();
     Serial.println("[433MHz] === Initialisation XL1278-SMT ===");
-    SPI.begin(PIN_LORA_SCLK, PIN_LORA_MISO, PIN_LORA_MOSI, PIN_LORA_SS);
-    LoRa.setPins(PIN_LORA_SS, PIN_LORA_RST, PIN_LORA_DIO0);
-    
-    Serial.println("[433MHz] Initialisation...");
-    if (!LoRa.begin(LORA_FREQUENCY)) {
+    module433 = new XL1278Module();
+    if (!module433->begin()) {
         Serial.println("[433MHz] ERREUR: Échec initialisation!");
         Serial.println("[433MHz] Le système continuera avec le module 900 MHz uniquement");
-    } else {
-        Serial.println("[433MHz] Module initialisé");
-        delay(300);
-        configureXL1278();
-        
-        // Activer le callback de réception
-        LoRa.onReceive(onReceive433);
-        LoRa.receive();
-        
-        Serial.print("[433MHz] Fréquence finale: ");
-        Serial.print(LORA_FREQUENCY / 1E6);
-        Serial.println(" MHz");
+        delete module433;
+        module433 = nullptr;
+    }
+    
+    // ====================================
+    // Une tâche par radio : émission et réception simultanées sur les deux bandes
+    // ====================================
+    dualRadio = new DualBandRadio(module900, module433);
+    if (!dualRadio->begin()) {
+        Serial.println("[DUAL] ERREUR: Aucune radio disponible");
     }
     
     // ====================================
@@ -219,6 +139,7 @@ void setup() {
     Serial.println("  433 <message>  - Envoyer sur 433 MHz");
     Serial.println("  ALL <message>  - Envoyer sur les deux");
 #endif
+    Serial.println("  STATUS               - Files et duty cycle par bande");
     Serial.println();
     Serial.println("Les messages reçus indiquent leur provenance:");
     Serial.println("  [RX-900MHz] ou [RX-433MHz]");
@@ -227,27 +148,22 @@ void setup() {
 }
 
 void loop() {
+    // Une trame par tour, reçue par la tâche de sa bande
+    RadioFrame rxFrame;
+    const bool frameReceived = dualRadio->receive(rxFrame);
+    
     // ====================================
     // Vérifier réception sur E220 (900 MHz)
     // ====================================
-    if (e220ttl.available() > 0) {
-        // Lire directement les octets bruts pour éviter la troncature
-        uint8_t buffer[PROTOCOL_MAX_MSG_SIZE];
-        int bytesRead = 0;
-        
-        // Attendre un peu pour que tous les octets arrivent
-        delay(50);
-        
-        // Lire tous les octets disponibles
-        while (SerialE220.available() && bytesRead < PROTOCOL_MAX_MSG_SIZE) {
-            buffer[bytesRead++] = SerialE220.read();
-        }
+    if (frameReceived && rxFrame.band == RADIO_BAND_900) {
+        uint8_t* buffer = rxFrame.data;
+        int bytesRead = rxFrame.len;
         
         if (bytesRead > 0) {
 #ifdef USE_CUSTOM_PROTOCOL
             // Vérifier le magic number
             if (bytesRead < 4) {
-                Serial.println("[900MHz] Message trop court, ignoré");
+                LOG_WARN(LOG_CAT_RADIO, "[900MHz] Message trop court, ignoré");
                 return;
             }
             
@@ -255,120 +171,80 @@ void loop() {
             uint8_t* messageData = buffer + 1; // Données après le magic number
             uint16_t messageLen = bytesRead - 1;
             
+            // Reste en portée tant que msg, une vue sur ces octets, est utilisé
+            uint8_t decryptedBuffer900[PROTOCOL_MAX_MSG_SIZE];
             uint8_t* dataToProcess900 = messageData;
             uint16_t dataLen900 = messageLen;
             
             // DEBUG: Afficher les données brutes reçues
-            Serial.print("[900MHz DEBUG] Magic: 0x");
-            if (magicNum < 0x10) Serial.print("0");
-            Serial.print(magicNum, HEX);
-            Serial.print(" | Données (HEX): ");
-            for (int i = 0; i < messageLen && i < 16; i++) {
-                if (messageData[i] < 0x10) Serial.print("0");
-                Serial.print(messageData[i], HEX);
-                Serial.print(" ");
-            }
-            Serial.println();
+            LOG_DEBUG(LOG_CAT_RADIO, "[900MHz DEBUG] Magic: 0x%02X | Données (HEX): %h", magicNum,
+                      LogData(messageData, messageLen < 16 ? messageLen : 16));
             
             if (magicNum == MAGIC_NUM_ENCRYPTED) {
                 // Message chiffré - déchiffrer
-                Serial.println("[900MHz] Message CHIFFRÉ détecté");
-                uint8_t decryptedBuffer900[PROTOCOL_MAX_MSG_SIZE];
+                LOG_INFO(LOG_CAT_RADIO, "[900MHz] Message CHIFFRÉ détecté");
                 uint16_t decryptedLen900;
                 
                 if (Encryption::decrypt(messageData, messageLen, decryptedBuffer900, &decryptedLen900)) {
                     dataToProcess900 = decryptedBuffer900;
                     dataLen900 = decryptedLen900;
-                    Serial.print("[900MHz ENCRYPTION] Déchiffré (");
-                    Serial.print(messageLen);
-                    Serial.print(" → ");
-                    Serial.print(decryptedLen900);
-                    Serial.println(" bytes)");
+                    LOG_INFO(LOG_CAT_RADIO, "[900MHz ENCRYPTION] Déchiffré (%u → %u bytes)", messageLen, decryptedLen900);
                     
                     // DEBUG: Afficher les données déchiffrées
-                    Serial.print("[900MHz DEBUG] Déchiffré (HEX): ");
-                    for (int i = 0; i < decryptedLen900 && i < 16; i++) {
-                        if (decryptedBuffer900[i] < 0x10) Serial.print("0");
-                        Serial.print(decryptedBuffer900[i], HEX);
-                        Serial.print(" ");
-                    }
-                    Serial.println();
+                    LOG_DEBUG(LOG_CAT_RADIO, "[900MHz DEBUG] Déchiffré (HEX): %h",
+                              LogData(decryptedBuffer900, decryptedLen900 < 16 ? decryptedLen900 : 16));
                 } else {
-                    Serial.println("[900MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
-                    Serial.println("[900MHz] Message ignoré (clé ou mode incompatible)");
+                    LOG_WARN(LOG_CAT_RADIO, "[900MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
+                    LOG_WARN(LOG_CAT_RADIO, "[900MHz] Message ignoré (clé ou mode incompatible)");
                     return;
                 }
             } else if (magicNum == MAGIC_NUM_CLEAR) {
                 // Message en clair
-                Serial.println("[900MHz] Message EN CLAIR détecté");
+                LOG_INFO(LOG_CAT_RADIO, "[900MHz] Message EN CLAIR détecté");
             } else {
                 // Magic number inconnu - peut-être ancien format sans magic number
-                Serial.print("[900MHz] Magic number inconnu (0x");
-                if (magicNum < 0x10) Serial.print("0");
-                Serial.print(magicNum, HEX);
-                Serial.println(") - tentative de décodage direct");
+                LOG_WARN(LOG_CAT_RADIO, "[900MHz] Magic number inconnu (0x%02X) - tentative de décodage direct", magicNum);
                 // Essayer de décoder le message complet (avec le magic number)
                 dataToProcess900 = buffer;
                 dataLen900 = bytesRead;
             }
             
-            ProtocolMessage msg;
-            if (MessageProtocol::decodeMessage(dataToProcess900, dataLen900, &msg)) {
-                Serial.print("[RX-900MHz] Message protocole (");
-                Serial.print(bytesRead);
-                Serial.println(" bytes):");
-                MessageProtocol::printMessage(&msg, "[RX-900MHz]   ");
+            ProtocolMessageView msg;
+            if (MessageProtocol::decodeMessage(dataToProcess900, dataLen900, msg)) {
+                LOG_INFO(LOG_CAT_PROTO, "[RX-900MHz] Message protocole (%d bytes):", bytesRead);
+                MessageProtocol::printMessage(msg, "[RX-900MHz]   ");
+                trackSensorFrames(msg, "[RX-900MHz]   ");
                 
                 // Gestion automatique PING/PONG
-                if (msg.type == MSG_TYPE_PING && msg.dataSize >= 4) {
+                if (msg.type() == MSG_TYPE_PING && msg.dataSize() >= 4) {
                     uint8_t pongBuffer[PROTOCOL_MAX_MSG_SIZE];
-                    uint16_t pongSize = MessageProtocol::encodePongMessage(DEVICE_ID, msg.data, pongBuffer);
+                    uint16_t pongSize = MessageProtocol::encodePongMessage(DEVICE_ID, msg.data(), pongBuffer);
                     
 #ifdef USE_ENCRYPTION
                     // Chiffrer le PONG avant envoi
                     uint8_t encryptedPong900[PROTOCOL_MAX_MSG_SIZE];
                     uint16_t encryptedPongLen900;
                     if (Encryption::encrypt(pongBuffer, pongSize, encryptedPong900, &encryptedPongLen900)) {
-                        ResponseStatus rs = e220ttl.sendMessage(encryptedPong900, encryptedPongLen900);
-                        if (rs.getResponseDescription() == "Success") {
-                            Serial.println("[900MHz PING/PONG] Réponse PONG chiffrée envoyée");
+                        if (dualRadio->submit(RADIO_BAND_900, encryptedPong900, encryptedPongLen900, TX_PRIO_HIGH)) {
+                            LOG_INFO(LOG_CAT_RADIO, "[900MHz PING/PONG] Réponse PONG chiffrée envoyée");
                         }
                     }
 #else
-                    ResponseStatus rs = e220ttl.sendMessage(pongBuffer, pongSize);
-                    if (rs.getResponseDescription() == "Success") {
-                        Serial.println("[900MHz PING/PONG] Réponse PONG envoyée");
+                    if (dualRadio->submit(RADIO_BAND_900, pongBuffer, pongSize, TX_PRIO_HIGH)) {
+                        LOG_INFO(LOG_CAT_RADIO, "[900MHz PING/PONG] Réponse PONG envoyée");
                     }
 #endif
-                } else if (msg.type == MSG_TYPE_PONG && msg.dataSize >= 4 && waitingForPong900) {
-                    uint32_t originalTimestamp = msg.data[0] | (msg.data[1] << 8) | (msg.data[2] << 16) | (msg.data[3] << 24);
+                } else if (msg.type() == MSG_TYPE_PONG && msg.dataSize() >= 4 && waitingForPong900) {
+                    uint32_t originalTimestamp = MessageProtocol::decodeTimestamp(msg);
                     uint32_t rtt = millis() - originalTimestamp;
-                    Serial.print("[900MHz PING/PONG] RTT: ");
-                    Serial.print(rtt);
-                    Serial.println(" ms");
+                    LOG_INFO(LOG_CAT_RADIO, "[900MHz PING/PONG] RTT: %u ms", rtt);
                     waitingForPong900 = false;
                 }
             } else {
-                Serial.print("[RX-900MHz] Message brut: ");
-                for (int i = 0; i < bytesRead; i++) {
-                    if (buffer[i] >= 32 && buffer[i] < 127) {
-                        Serial.print((char)buffer[i]);
-                    } else {
-                        Serial.print(".");
-                    }
-                }
-                Serial.print(" (");
-                Serial.print(bytesRead);
-                Serial.println(" bytes)");
+                LOG_INFO(LOG_CAT_RADIO, "[RX-900MHz] Message brut: %p (%d bytes)", LogData(buffer, bytesRead), bytesRead);
             }
 #else
-            Serial.print("[RX-900MHz] ");
-            for (int i = 0; i < bytesRead; i++) {
-                Serial.print((char)buffer[i]);
-            }
-            Serial.print(" (");
-            Serial.print(bytesRead);
-            Serial.println(" chars)");
+            LOG_INFO(LOG_CAT_RADIO, "[RX-900MHz] %t (%d chars)", LogData(buffer, bytesRead), bytesRead);
 #endif
         }
     }
@@ -376,17 +252,16 @@ void loop() {
     // ====================================
     // Vérifier réception sur XL1278 (433 MHz)
     // ====================================
-    if (messageReceived433) {
-        messageReceived433 = false;
-        
-        int rssi = LoRa.packetRssi();
-        float snr = LoRa.packetSnr();
+    if (frameReceived && rxFrame.band == RADIO_BAND_433) {
+        uint8_t* receivedBuffer433 = rxFrame.data;
+        int receivedBytes433 = rxFrame.len;
+        int rssi = rxFrame.rssi;
+        float snr = rxFrame.snr;
         
 #ifdef USE_CUSTOM_PROTOCOL
         // Vérifier le magic number
         if (receivedBytes433 < 4) {
-            Serial.println("[433MHz] Message trop court, ignoré");
-            LoRa.receive();
+            LOG_WARN(LOG_CAT_RADIO, "[433MHz] Message trop court, ignoré");
             return;
         }
         
@@ -394,143 +269,84 @@ void loop() {
         uint8_t* messageData = receivedBuffer433 + 1; // Données après le magic number
         uint16_t messageLen = receivedBytes433 - 1;
         
+        // Reste en portée tant que msg, une vue sur ces octets, est utilisé
+        uint8_t decryptedBuffer433[PROTOCOL_MAX_MSG_SIZE];
         uint8_t* dataToProcess433 = messageData;
         uint16_t dataLen433 = messageLen;
         
         // DEBUG: Afficher les données brutes reçues
-        Serial.print("[433MHz DEBUG] Magic: 0x");
-        if (magicNum < 0x10) Serial.print("0");
-        Serial.print(magicNum, HEX);
-        Serial.print(" | Données (HEX): ");
-        for (int i = 0; i < messageLen && i < 16; i++) {
-            if (messageData[i] < 0x10) Serial.print("0");
-            Serial.print(messageData[i], HEX);
-            Serial.print(" ");
-        }
-        Serial.println();
+        LOG_DEBUG(LOG_CAT_RADIO, "[433MHz DEBUG] Magic: 0x%02X | Données (HEX): %h", magicNum,
+                  LogData(messageData, messageLen < 16 ? messageLen : 16));
         
         if (magicNum == MAGIC_NUM_ENCRYPTED) {
             // Message chiffré - déchiffrer
-            Serial.println("[433MHz] Message CHIFFRÉ détecté");
-            uint8_t decryptedBuffer433[PROTOCOL_MAX_MSG_SIZE];
+            LOG_INFO(LOG_CAT_RADIO, "[433MHz] Message CHIFFRÉ détecté");
             uint16_t decryptedLen433;
             
             if (Encryption::decrypt(messageData, messageLen, decryptedBuffer433, &decryptedLen433)) {
                 dataToProcess433 = decryptedBuffer433;
                 dataLen433 = decryptedLen433;
-                Serial.print("[433MHz ENCRYPTION] Déchiffré (");
-                Serial.print(messageLen);
-                Serial.print(" → ");
-                Serial.print(decryptedLen433);
-                Serial.println(" bytes)");
+                LOG_INFO(LOG_CAT_RADIO, "[433MHz ENCRYPTION] Déchiffré (%u → %u bytes)", messageLen, decryptedLen433);
                 
                 // DEBUG: Afficher les données déchiffrées
-                Serial.print("[433MHz DEBUG] Déchiffré (HEX): ");
-                for (int i = 0; i < decryptedLen433 && i < 16; i++) {
-                    if (decryptedBuffer433[i] < 0x10) Serial.print("0");
-                    Serial.print(decryptedBuffer433[i], HEX);
-                    Serial.print(" ");
-                }
-                Serial.println();
+                LOG_DEBUG(LOG_CAT_RADIO, "[433MHz DEBUG] Déchiffré (HEX): %h",
+                          LogData(decryptedBuffer433, decryptedLen433 < 16 ? decryptedLen433 : 16));
             } else {
-                Serial.println("[433MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
-                Serial.println("[433MHz] Message ignoré (clé ou mode incompatible)");
-                LoRa.receive();
+                LOG_WARN(LOG_CAT_RADIO, "[433MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
+                LOG_WARN(LOG_CAT_RADIO, "[433MHz] Message ignoré (clé ou mode incompatible)");
                 return;
             }
         } else if (magicNum == MAGIC_NUM_CLEAR) {
             // Message en clair
-            Serial.println("[433MHz] Message EN CLAIR détecté");
+            LOG_INFO(LOG_CAT_RADIO, "[433MHz] Message EN CLAIR détecté");
         } else {
             // Magic number inconnu - peut-être ancien format sans magic number
-            Serial.print("[433MHz] Magic number inconnu (0x");
-            if (magicNum < 0x10) Serial.print("0");
-            Serial.print(magicNum, HEX);
-            Serial.println(") - tentative de décodage direct");
+            LOG_WARN(LOG_CAT_RADIO, "[433MHz] Magic number inconnu (0x%02X) - tentative de décodage direct", magicNum);
             // Essayer de décoder le message complet (avec le magic number)
             dataToProcess433 = receivedBuffer433;
             dataLen433 = receivedBytes433;
         }
         
-        ProtocolMessage msg;
-        if (MessageProtocol::decodeMessage(dataToProcess433, dataLen433, &msg)) {
-            Serial.print("[RX-433MHz] Message protocole (");
-            Serial.print(receivedBytes433);
-            Serial.print(" bytes, RSSI: ");
-            Serial.print(rssi);
-            Serial.print(" dBm, SNR: ");
-            Serial.print(snr);
-            Serial.println(" dB):");
-            MessageProtocol::printMessage(&msg, "[RX-433MHz]   ");
+        ProtocolMessageView msg;
+        if (MessageProtocol::decodeMessage(dataToProcess433, dataLen433, msg)) {
+            LOG_INFO(LOG_CAT_PROTO, "[RX-433MHz] Message protocole (%d bytes, RSSI: %d dBm, SNR: %.2f dB):",
+                     receivedBytes433, rssi, snr);
+            MessageProtocol::printMessage(msg, "[RX-433MHz]   ");
+            trackSensorFrames(msg, "[RX-433MHz]   ");
             
             // Gestion automatique PING/PONG
-            if (msg.type == MSG_TYPE_PING && msg.dataSize >= 4) {
+            if (msg.type() == MSG_TYPE_PING && msg.dataSize() >= 4) {
                 uint8_t pongBuffer[PROTOCOL_MAX_MSG_SIZE];
-                uint16_t pongSize = MessageProtocol::encodePongMessage(DEVICE_ID, msg.data, pongBuffer);
+                uint16_t pongSize = MessageProtocol::encodePongMessage(DEVICE_ID, msg.data(), pongBuffer);
                 
 #ifdef USE_ENCRYPTION
                 // Chiffrer le PONG avant envoi
                 uint8_t encryptedPong433[PROTOCOL_MAX_MSG_SIZE];
                 uint16_t encryptedPongLen433;
                 if (Encryption::encrypt(pongBuffer, pongSize, encryptedPong433, &encryptedPongLen433)) {
-                    LoRa.beginPacket();
-                    LoRa.write(encryptedPong433, encryptedPongLen433);
-                    bool success = LoRa.endPacket();
-                    if (success) {
-                        Serial.println("[433MHz PING/PONG] Réponse PONG chiffrée envoyée");
+                    if (dualRadio->submit(RADIO_BAND_433, encryptedPong433, encryptedPongLen433, TX_PRIO_HIGH)) {
+                        LOG_INFO(LOG_CAT_RADIO, "[433MHz PING/PONG] Réponse PONG chiffrée envoyée");
                     }
-                    LoRa.receive();
                 }
 #else
-                LoRa.beginPacket();
-                LoRa.write(pongBuffer, pongSize);
-                bool success = LoRa.endPacket();
-                if (success) {
-                    Serial.println("[433MHz PING/PONG] Réponse PONG envoyée");
+                if (dualRadio->submit(RADIO_BAND_433, pongBuffer, pongSize, TX_PRIO_HIGH)) {
+                    LOG_INFO(LOG_CAT_RADIO, "[433MHz PING/PONG] Réponse PONG envoyée");
                 }
-                LoRa.receive();
 #endif
-            } else if (msg.type == MSG_TYPE_PONG && msg.dataSize >= 4 && waitingForPong433) {
-                uint32_t originalTimestamp = msg.data[0] | (msg.data[1] << 8) | (msg.data[2] << 16) | (msg.data[3] << 24);
+            } else if (msg.type() == MSG_TYPE_PONG && msg.dataSize() >= 4 && waitingForPong433) {
+                uint32_t originalTimestamp = MessageProtocol::decodeTimestamp(msg);
                 uint32_t rtt = millis() - originalTimestamp;
-                Serial.print("[433MHz PING/PONG] RTT: ");
-                Serial.print(rtt);
-                Serial.println(" ms");
+                LOG_INFO(LOG_CAT_RADIO, "[433MHz PING/PONG] RTT: %u ms", rtt);
                 waitingForPong433 = false;
             }
         } else {
-            Serial.print("[RX-433MHz] Message brut: ");
-            for (int i = 0; i < receivedBytes433; i++) {
-                if (receivedBuffer433[i] >= 32 && receivedBuffer433[i] < 127) {
-                    Serial.print((char)receivedBuffer433[i]);
-                } else {
-                    Serial.print(".");
-                }
-            }
-            Serial.print(" (");
-            Serial.print(receivedBytes433);
-            Serial.print(" bytes, RSSI: ");
-            Serial.print(rssi);
-            Serial.print(" dBm, SNR: ");
-            Serial.print(snr);
-            Serial.println(" dB)");
+            LOG_INFO(LOG_CAT_RADIO, "[RX-433MHz] Message brut: %p (%d bytes, RSSI: %d dBm, SNR: %.2f dB)",
+                     LogData(receivedBuffer433, receivedBytes433), receivedBytes433, rssi, snr);
         }
 #else
-        Serial.print("[RX-433MHz] ");
-        for (int i = 0; i < receivedBytes433; i++) {
-            Serial.print((char)receivedBuffer433[i]);
-        }
-        Serial.print(" (");
-        Serial.print(receivedBytes433);
-        Serial.print(" chars, RSSI: ");
-        Serial.print(rssi);
-        Serial.print(" dBm, SNR: ");
-        Serial.print(snr);
-        Serial.println(" dB)");
+        LOG_INFO(LOG_CAT_RADIO, "[RX-433MHz] %t (%d chars, RSSI: %d dBm, SNR: %.2f dB)",
+                 LogData(receivedBuffer433, receivedBytes433), receivedBytes433, rssi, snr);
 #endif
-        
-        // Retourner en mode réception
-        LoRa.receive();
     }
     
     // ====================================
@@ -539,6 +355,13 @@ void loop() {
     if (Serial.available()) {
         String line = Serial.readStringUntil('\n');
         line.trim();
+        // Réponses en Serial.print directs : un bloc, sans ligne du journal au milieu
+        LogSerialLock serialLock;
+        
+        if (line.equalsIgnoreCase("STATUS")) {
+            dualRadio->printStatus();
+            return;
+        }
         
         if (line.length() > 0) {
             // Extraire la commande et le message
@@ -670,14 +493,12 @@ void loop() {
                         Serial.print(encryptedLen900);
                         Serial.print(" bytes | ");
                         
-                        ResponseStatus rs = e220ttl.sendMessage(finalBuffer900, finalLen900);
-                        if (rs.getResponseDescription() == "Success") {
+                        if (dualRadio->submit(RADIO_BAND_900, finalBuffer900, finalLen900)) {
                             Serial.print("OK (");
                             Serial.print(finalLen900);
                             Serial.println(" bytes totaux)");
                         } else {
-                            Serial.print("ERREUR: ");
-                            Serial.println(rs.getResponseDescription());
+                            Serial.println("ERREUR: file pleine ou bande indisponible");
                         }
                     } else {
                         Serial.println("[ENCRYPTION] ERREUR chiffrement!");
@@ -689,25 +510,21 @@ void loop() {
                     finalLen900 = 1 + msgSize;
                     
                     Serial.print("[CLAIR] ");
-                    ResponseStatus rs = e220ttl.sendMessage(finalBuffer900, finalLen900);
-                    if (rs.getResponseDescription() == "Success") {
+                    if (dualRadio->submit(RADIO_BAND_900, finalBuffer900, finalLen900)) {
                         Serial.print("OK (");
                         Serial.print(finalLen900);
                         Serial.println(" bytes)");
                     } else {
-                        Serial.print("ERREUR: ");
-                        Serial.println(rs.getResponseDescription());
+                        Serial.println("ERREUR: file pleine ou bande indisponible");
                     }
 #endif
                 }
 #else
                 Serial.println(message);
-                ResponseStatus rs = e220ttl.sendMessage(message);
-                if (rs.getResponseDescription() == "Success") {
+                if (dualRadio->submit(RADIO_BAND_900, (const uint8_t*)message.c_str(), message.length())) {
                     Serial.println("OK");
                 } else {
-                    Serial.print("ERREUR: ");
-                    Serial.println(rs.getResponseDescription());
+                    Serial.println("ERREUR: file pleine ou bande indisponible");
                 }
 #endif
                 
@@ -737,10 +554,7 @@ void loop() {
                         Serial.print(encryptedLen433);
                         Serial.print(" bytes | ");
                         
-                        LoRa.beginPacket();
-                        LoRa.write(finalBuffer433, finalLen433);
-                        bool success = LoRa.endPacket();
-                        if (success) {
+                        if (dualRadio->submit(RADIO_BAND_433, finalBuffer433, finalLen433)) {
                             Serial.print("OK (");
                             Serial.print(finalLen433);
                             Serial.println(" bytes totaux)");
@@ -757,10 +571,7 @@ void loop() {
                     finalLen433 = 1 + msgSize;
                     
                     Serial.print("[CLAIR] ");
-                    LoRa.beginPacket();
-                    LoRa.write(finalBuffer433, finalLen433);
-                    bool success = LoRa.endPacket();
-                    if (success) {
+                    if (dualRadio->submit(RADIO_BAND_433, finalBuffer433, finalLen433)) {
                         Serial.print("OK (");
                         Serial.print(finalLen433);
                         Serial.println(" bytes)");
@@ -771,16 +582,12 @@ void loop() {
                 }
 #else
                 Serial.println(message);
-                LoRa.beginPacket();
-                LoRa.print(message);
-                bool success = LoRa.endPacket();
-                if (success) {
+                if (dualRadio->submit(RADIO_BAND_433, (const uint8_t*)message.c_str(), message.length())) {
                     Serial.println("OK");
                 } else {
                     Serial.println("ERREUR");
                 }
 #endif
-                LoRa.receive();
                 
             } else if (cmd == "ALL") {
                 // Envoyer sur les deux bandes
@@ -808,9 +615,11 @@ void loop() {
                         Serial.print(encryptedLenAll);
                         Serial.print(" bytes | ");
                         
+                        // Soumis aux deux tâches radio : les deux bandes émettent en parallèle
+                        const uint8_t accepted = dualRadio->submit(RADIO_BAND_ALL, finalBufferAll, finalLenAll);
+                        
                         // 900 MHz
-                        ResponseStatus rs900 = e220ttl.sendMessage(finalBufferAll, finalLenAll);
-                        if (rs900.getResponseDescription() == "Success") {
+                        if (accepted & RADIO_BAND_900) {
                             Serial.print("900MHz OK (");
                             Serial.print(finalLenAll);
                             Serial.print(" bytes) | ");
@@ -819,10 +628,7 @@ void loop() {
                         }
                         
                         // 433 MHz
-                        LoRa.beginPacket();
-                        LoRa.write(finalBufferAll, finalLenAll);
-                        bool success433 = LoRa.endPacket();
-                        if (success433) {
+                        if (accepted & RADIO_BAND_433) {
                             Serial.print("433MHz OK (");
                             Serial.print(finalLenAll);
                             Serial.println(" bytes)");
@@ -840,9 +646,11 @@ void loop() {
                     
                     Serial.print("[CLAIR] ");
                     
+                    // Soumis aux deux tâches radio : les deux bandes émettent en parallèle
+                    const uint8_t accepted = dualRadio->submit(RADIO_BAND_ALL, finalBufferAll, finalLenAll);
+                    
                     // 900 MHz
-                    ResponseStatus rs900 = e220ttl.sendMessage(finalBufferAll, finalLenAll);
-                    if (rs900.getResponseDescription() == "Success") {
+                    if (accepted & RADIO_BAND_900) {
                         Serial.print("900MHz OK (");
                         Serial.print(finalLenAll);
                         Serial.print(" bytes) | ");
@@ -851,10 +659,7 @@ void loop() {
                     }
                     
                     // 433 MHz
-                    LoRa.beginPacket();
-                    LoRa.write(finalBufferAll, finalLenAll);
-                    bool success433 = LoRa.endPacket();
-                    if (success433) {
+                    if (accepted & RADIO_BAND_433) {
                         Serial.print("433MHz OK (");
                         Serial.print(finalLenAll);
                         Serial.println(" bytes)");
@@ -865,25 +670,22 @@ void loop() {
                 }
 #else
                 Serial.println(message);
+                // Soumis aux deux tâches radio : les deux bandes émettent en parallèle
+                const uint8_t accepted = dualRadio->submit(RADIO_BAND_ALL, (const uint8_t*)message.c_str(), message.length());
+                
                 // 900 MHz
-                ResponseStatus rs900 = e220ttl.sendMessage(message);
-                if (rs900.getResponseDescription() == "Success") {
+                if (accepted & RADIO_BAND_900) {
                     Serial.println("900MHz OK");
                 } else {
-                    Serial.print("900MHz ERREUR: ");
-                    Serial.println(rs900.getResponseDescription());
+                    Serial.println("900MHz ERREUR");
                 }
                 // 433 MHz
-                LoRa.beginPacket();
-                LoRa.print(message);
-                bool success433 = LoRa.endPacket();
-                if (success433) {
+                if (accepted & RADIO_BAND_433) {
                     Serial.println("433MHz OK");
                 } else {
                     Serial.println("433MHz ERREUR");
                 }
 #endif
-                LoRa.receive();
                 
             } else {
                 Serial.println("[ERREUR] Commande inconnue. Utilisez: 900, 433, ou ALL");
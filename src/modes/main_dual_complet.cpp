@@ -1,10 +1,8 @@
 #include <Arduino.h>
-#include <HardwareSerial.h>
-#include <SPI.h>
-#include <LoRa.h>
-#include <LoRa_E220.h>
 #include "../lora/LoRaConfig.h"
 #include "../lora/LoRaConfig_XL1278.h"
+#include "../lora/DualBandRadio.h"
+#include "../utils/Log.h"
 #include "../protocol/MessageProtocol.h"
 #include "../security/Encryption.h"
 
@@ -24,16 +22,11 @@
 //
 // TODO: Intégrer les managers du mode complet pour une sécurité complète
 
-// HardwareSerial pour E220 (UART2 sur ESP32)
-HardwareSerial SerialE220(2);
-
-// Objet LoRa_E220
-LoRa_E220 e220ttl(&SerialE220, PIN_LORA_AUX, PIN_LORA_M0, PIN_LORA_M1);
-
-// Variables globales pour XL1278
-uint8_t receivedBuffer433[PROTOCOL_MAX_MSG_SIZE];
-int receivedBytes433 = 0;
-bool messageReceived433 = false;
+// Drivers radio : chacun est piloté par sa propre tâche FreeRTOS (DualBandRadio),
+// loop() ne fait que soumettre des trames et lire la file de réception commune
+LoRaModule* module900 = nullptr;
+XL1278Module* module433 = nullptr;
+DualBandRadio* dualRadio = nullptr;
 
 // Mode d'opération E220 (pour extensions futures)
 enum E220Mode {
@@ -43,108 +36,44 @@ enum E220Mode {
 
 E220Mode e220Mode = E220_MODE_BROADCAST;
 
-// Callback pour réception de messages sur XL1278 (433 MHz)
-void onReceive433(int packetSize) {
-    if (packetSize == 0) return;
-    
-    // Lire les octets bruts dans le buffer
-    receivedBytes433 = 0;
-    while (LoRa.available() && receivedBytes433 < PROTOCOL_MAX_MSG_SIZE) {
-        receivedBuffer433[receivedBytes433++] = (uint8_t)LoRa.read();
-    }
-    messageReceived433 = true;
-}
+#ifdef USE_CUSTOM_PROTOCOL
+// Trames radar compactes reçues sur les deux bandes : références des deltas, par source
+SensorFrameDecoder sensorFrameDecoder;
 
-void configureE220() {
-    Serial.println("[900MHz] Configuration du module E220...");
+void trackSensorFrame(const ProtocolMessageView& msg, const char* prefix) {
+    if (!MessageProtocol::isCompactSensorData(msg)) return;
     
-    // Mettre en mode configuration
-    e220ttl.setMode(MODE_3_CONFIGURATION);
-    delay(300);
-    
-    // Lire la configuration actuelle
-    ResponseStructContainer c = e220ttl.getConfiguration();
-    if (c.status.getResponseDescription() == "Success") {
-        Configuration configuration = *(Configuration*)c.data;
-        
-        // Afficher la configuration actuelle
-        float currentFreq = calculateFrequency900MHz(configuration.CHAN);
-        Serial.print("[900MHz] Configuration actuelle: CHAN=");
-        Serial.print(configuration.CHAN);
-        Serial.print(" -> ");
-        Serial.print(currentFreq, 3);
-        Serial.println(" MHz");
-        
-        // Configurer pour mode transparent
-        configuration.ADDH = CONFIG_ADDH;
-        configuration.ADDL = CONFIG_ADDL;
-        configuration.CHAN = CONFIG_CHAN;
-        configuration.SPED.airDataRate = AIR_DATA_RATE_010_24;
-        configuration.SPED.uartBaudRate = UART_BPS_9600;
-        configuration.SPED.uartParity = MODE_00_8N1;
-        configuration.OPTION.transmissionPower = POWER_22;
-        configuration.OPTION.RSSIAmbientNoise = RSSI_AMBIENT_NOISE_DISABLED;
-        configuration.TRANSMISSION_MODE.fixedTransmission = FT_TRANSPARENT_TRANSMISSION;
-        configuration.TRANSMISSION_MODE.enableRSSI = RSSI_DISABLED;
-        configuration.TRANSMISSION_MODE.enableLBT = LBT_DISABLED;
-        configuration.TRANSMISSION_MODE.WORPeriod = WOR_2000_011;
-        
-        // Afficher la nouvelle fréquence configurée
-        float newFreq = calculateFrequency900MHz(CONFIG_CHAN);
-        Serial.print("[900MHz] Nouvelle config: CHAN=");
-        Serial.print(CONFIG_CHAN);
-        Serial.print(" -> ");
-        Serial.print(newFreq, 3);
-        Serial.println(" MHz");
-        
-        // Sauvegarder la configuration
-        ResponseStatus rs = e220ttl.setConfiguration(configuration, WRITE_CFG_PWR_DWN_SAVE);
-        if (rs.getResponseDescription() == "Success") {
-            Serial.println("[900MHz] Configuration sauvegardée avec succès!");
-        } else {
-            Serial.print("[900MHz] Erreur sauvegarde: ");
-            Serial.println(rs.getResponseDescription());
-        }
-        
-        c.close();
-    } else {
-        Serial.println("[900MHz] Erreur lecture configuration");
+    SensorFrame frame;
+    if (!sensorFrameDecoder.decode(msg, frame)) {
+        LOG_INFO(LOG_CAT_PROTO, "%tDelta radar sans référence, attente de la prochaine keyframe", LogData(prefix));
+        return;
+    }
+    // Les keyframes sont déjà affichées en clair par printMessage
+    if (!MessageProtocol::isSensorKeyframe(msg)) {
+        LOG_INFO(LOG_CAT_PROTO, "%tCibles reconstruites : %u", LogData(prefix), frame.count);
+        MessageProtocol::printSensorTargets(frame, prefix);
     }
-    
-    // Revenir en mode normal
-    e220ttl.setMode(MODE_0_NORMAL);
-    delay(200);
-    Serial.println("[900MHz] Module en mode normal (mode complet)");
 }
 
-void configureXL1278() {
-    Serial.println("[433MHz] Configuration du module XL1278...");
-    
-    // Configuration des paramètres LoRa
-    LoRa.setSignalBandwidth(LORA_BANDWIDTH);
-    LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR);
-    LoRa.setCodingRate4(LORA_CODING_RATE);
-    LoRa.setTxPower(LORA_TX_POWER_XL);
-    LoRa.setSyncWord(LORA_SYNC_WORD);
-    
-    Serial.println("[433MHz] Paramètres configurés:");
-    Serial.print("  - Fréquence: ");
-    Serial.print(LORA_FREQUENCY / 1E6);
-    Serial.println(" MHz");
-    Serial.print("  - Bande passante: ");
-    Serial.print(LORA_BANDWIDTH / 1E3);
-    Serial.println(" kHz");
-    Serial.print("  - Spreading Factor: SF");
-    Serial.println(LORA_SPREADING_FACTOR);
-    Serial.print("  - Puissance TX: ");
-    Serial.print(LORA_TX_POWER_XL);
-    Serial.println(" dBm");
-    Serial.println("[433MHz] Module configuré avec succès!");
+// Deltas radar, y compris ceux groupés dans un lot
+void trackSensorFrames(const ProtocolMessageView& msg, const char* prefix) {
+    if (msg.type() != MSG_TYPE_BATCH) {
+        trackSensorFrame(msg, prefix);
+        return;
+    }
+    ProtocolBatchReader reader(msg);
+    ProtocolMessageView record;
+    uint16_t ageDs;
+    while (reader.next(record, ageDs)) {
+        trackSensorFrame(record, prefix);
+    }
 }
+#endif
 
 void setup() {
     Serial.begin(115200);
     while (!Serial) {}
+    Log::begin();
     
     Serial.println();
     Serial.println("========================================");
@@ -163,19 +92,15 @@ void setup() {
     // Initialiser le module E220 (900 MHz)
     // ====================================
     Serial.println("[900MHz] === Initialisation E220-900T22D ===");
-    SerialE220.begin(9600, SERIAL_8N1, PIN_LORA_RX, PIN_LORA_TX);
-    SerialE220.setTimeout(600);
-    delay(500);
-    
-    Serial.println("[900MHz] Initialisation...");
-    if (!e220ttl.begin()) {
+    module900 = new LoRaModule();
+    // Pas de pair unique : adresse 0xFFFF, le module reçoit toutes les trames
+    module900->setLocalAddress(RADIO_ADDR_BROADCAST);
+    if (!module900->begin()) {
         Serial.println("[900MHz] ERREUR: Echec initialisation!");
         Serial.println("[900MHz] Le système continuera avec le module 433 MHz uniquement");
+        delete module900;
+        module900 = nullptr;
     } else {
-        Serial.println("[900MHz] Module initialisé");
-        delay(300);
-        configureE220();
-        
         float finalFreq = calculateFrequency900MHz(CONFIG_CHAN);
         Serial.print("[900MHz] Fréquence finale: ");
         Serial.print(finalFreq, 3);
@@ -187,25 +112,20 @@ void setup() {
     // ====================================
     Serial.println();
     Serial.println("[433MHz] === Initialisation XL1278-SMT ===");
-    SPI.begin(PIN_LORA_SCLK, PIN_LORA_MISO, PIN_LORA_MOSI, PIN_LORA_SS);
-    LoRa.setPins(PIN_LORA_SS, PIN_LORA_RST, PIN_LORA_DIO0);
-    
-    Serial.println("[433MHz] Initialisation...");
-    if (!LoRa.begin(LORA_FREQUENCY)) {
+    module433 = new XL1278Module();
+    if (!module433->begin()) {
         Serial.println("[433MHz] ERREUR: Échec initialisation!");
         Serial.println("[433MHz] Le système continuera avec le module 900 MHz uniquement");
-    } else {
-        Serial.println("[433MHz] Module initialisé");
-        delay(300);
-        configureXL1278();
-        
-        // Activer le callback de réception
-        LoRa.onReceive(onReceive433);
-        LoRa.receive();
-        
-        Serial.print("[433MHz] Fréquence finale: ");
-        Serial.print(LORA_FREQUENCY / 1E6);
-        Serial.println(" MHz");
+        delete module433;
+        module433 = nullptr;
+    }
+    
+    // ====================================
+    // Une tâche par radio : émission et réception simultanées sur les deux bandes
+    // ====================================
+    dualRadio = new DualBandRadio(module900, module433);
+    if (!dualRadio->begin()) {
+        Serial.println("[DUAL] ERREUR: Aucune radio disponible");
     }
     
     // ====================================
@@ -219,6 +139,7 @@ void setup() {
     Serial.println("  900 <message>  - Envoyer sur 900 MHz");
     Serial.println("  433 <message>  - Envoyer sur 433 MHz");
     Serial.println("  ALL <message>  - Envoyer sur les deux");
+    Serial.println("  STATUS         - Files et duty cycle par bande");
     Serial.println();
     Serial.println("Commandes futures (TODO) :");
     Serial.println("  PAIR ON/OFF    - Mode appairage (900 MHz)");
@@ -233,25 +154,22 @@ void setup() {
 }
 
 void loop() {
+    // Une trame par tour, reçue par la tâche de sa bande
+    RadioFrame rxFrame;
+    const bool frameReceived = dualRadio->receive(rxFrame);
+    
     // ====================================
     // Vérifier réception sur E220 (900 MHz)
     // ====================================
-    if (e220ttl.available() > 0) {
-        // Lire directement les octets bruts
-        uint8_t buffer[PROTOCOL_MAX_MSG_SIZE];
-        int bytesRead = 0;
-        
-        delay(50);
-        
-        while (SerialE220.available() && bytesRead < PROTOCOL_MAX_MSG_SIZE) {
-            buffer[bytesRead++] = SerialE220.read();
-        }
+    if (frameReceived && rxFrame.band == RADIO_BAND_900) {
+        uint8_t* buffer = rxFrame.data;
+        int bytesRead = rxFrame.len;
         
         if (bytesRead > 0) {
 #ifdef USE_CUSTOM_PROTOCOL
             // Vérifier le magic number
             if (bytesRead < 4) {
-                Serial.println("[900MHz] Message trop court, ignoré");
+                LOG_WARN(LOG_CAT_RADIO, "[900MHz] Message trop court, ignoré");
                 return;
             }
             
@@ -259,69 +177,48 @@ void loop() {
             uint8_t* messageData = buffer + 1;
             uint16_t messageLen = bytesRead - 1;
             
+#ifdef USE_ENCRYPTION
+            // Reste en portée tant que msg, une vue sur ces octets, est utilisé
+            uint8_t decryptedBuffer900[PROTOCOL_MAX_MSG_SIZE];
+#endif
             uint8_t* dataToProcess900 = messageData;
             uint16_t dataLen900 = messageLen;
             
             if (magicNum == MAGIC_NUM_ENCRYPTED) {
-                Serial.println("[900MHz] Message CHIFFRÉ détecté");
+                LOG_INFO(LOG_CAT_RADIO, "[900MHz] Message CHIFFRÉ détecté");
 #ifdef USE_ENCRYPTION
-                uint8_t decryptedBuffer900[PROTOCOL_MAX_MSG_SIZE];
                 uint16_t decryptedLen900;
                 
                 if (Encryption::decrypt(messageData, messageLen, decryptedBuffer900, &decryptedLen900)) {
                     dataToProcess900 = decryptedBuffer900;
                     dataLen900 = decryptedLen900;
-                    Serial.print("[900MHz ENCRYPTION] Déchiffré (");
-                    Serial.print(messageLen);
-                    Serial.print(" → ");
-                    Serial.print(decryptedLen900);
-                    Serial.println(" bytes)");
+                    LOG_INFO(LOG_CAT_RADIO, "[900MHz ENCRYPTION] Déchiffré (%u → %u bytes)", messageLen, decryptedLen900);
                 } else {
-                    Serial.println("[900MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
+                    LOG_WARN(LOG_CAT_RADIO, "[900MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
                     return;
                 }
 #else
-                Serial.println("[900MHz] ERREUR: Message chiffré reçu mais encryption non activée!");
+                LOG_WARN(LOG_CAT_RADIO, "[900MHz] ERREUR: Message chiffré reçu mais encryption non activée!");
                 return;
 #endif
             } else if (magicNum == MAGIC_NUM_CLEAR) {
-                Serial.println("[900MHz] Message EN CLAIR détecté");
+                LOG_INFO(LOG_CAT_RADIO, "[900MHz] Message EN CLAIR détecté");
             } else {
-                Serial.print("[900MHz] Magic number inconnu (0x");
-                if (magicNum < 0x10) Serial.print("0");
-                Serial.print(magicNum, HEX);
-                Serial.println(") - tentative de décodage direct");
+                LOG_WARN(LOG_CAT_RADIO, "[900MHz] Magic number inconnu (0x%02X) - tentative de décodage direct", magicNum);
                 dataToProcess900 = buffer;
                 dataLen900 = bytesRead;
             }
             
-            ProtocolMessage msg;
-            if (MessageProtocol::decodeMessage(dataToProcess900, dataLen900, &msg)) {
-                Serial.print("[RX-900MHz] Message protocole (");
-                Serial.print(bytesRead);
-                Serial.println(" bytes):");
-                MessageProtocol::printMessage(&msg, "[RX-900MHz]   ");
+            ProtocolMessageView msg;
+            if (MessageProtocol::decodeMessage(dataToProcess900, dataLen900, msg)) {
+                LOG_INFO(LOG_CAT_PROTO, "[RX-900MHz] Message protocole (%d bytes):", bytesRead);
+                MessageProtocol::printMessage(msg, "[RX-900MHz]   ");
+                trackSensorFrames(msg, "[RX-900MHz]   ");
             } else {
-                Serial.print("[RX-900MHz] Message brut: ");
-                for (int i = 0; i < bytesRead; i++) {
-                    if (buffer[i] >= 32 && buffer[i] < 127) {
-                        Serial.print((char)buffer[i]);
-                    } else {
-                        Serial.print(".");
-                    }
-                }
-                Serial.print(" (");
-                Serial.print(bytesRead);
-                Serial.println(" bytes)");
+                LOG_INFO(LOG_CAT_RADIO, "[RX-900MHz] Message brut: %p (%d bytes)", LogData(buffer, bytesRead), bytesRead);
             }
 #else
-            Serial.print("[RX-900MHz] ");
-            for (int i = 0; i < bytesRead; i++) {
-                Serial.print((char)buffer[i]);
-            }
-            Serial.print(" (");
-            Serial.print(bytesRead);
-            Serial.println(" chars)");
+            LOG_INFO(LOG_CAT_RADIO, "[RX-900MHz] %t (%d chars)", LogData(buffer, bytesRead), bytesRead);
 #endif
         }
     }
@@ -329,17 +226,16 @@ void loop() {
     // ====================================
     // Vérifier réception sur XL1278 (433 MHz)
     // ====================================
-    if (messageReceived433) {
-        messageReceived433 = false;
-        
-        int rssi = LoRa.packetRssi();
-        float snr = LoRa.packetSnr();
+    if (frameReceived && rxFrame.band == RADIO_BAND_433) {
+        uint8_t* receivedBuffer433 = rxFrame.data;
+        int receivedBytes433 = rxFrame.len;
+        int rssi = rxFrame.rssi;
+        float snr = rxFrame.snr;
         
 #ifdef USE_CUSTOM_PROTOCOL
         // Vérifier le magic number
         if (receivedBytes433 < 4) {
-            Serial.println("[433MHz] Message trop court, ignoré");
-            LoRa.receive();
+            LOG_WARN(LOG_CAT_RADIO, "[433MHz] Message trop court, ignoré");
             return;
         }
         
@@ -347,87 +243,52 @@ void loop() {
         uint8_t* messageData = receivedBuffer433 + 1;
         uint16_t messageLen = receivedBytes433 - 1;
         
+#ifdef USE_ENCRYPTION
+        // Reste en portée tant que msg, une vue sur ces octets, est utilisé
+        uint8_t decryptedBuffer433[PROTOCOL_MAX_MSG_SIZE];
+#endif
         uint8_t* dataToProcess433 = messageData;
         uint16_t dataLen433 = messageLen;
         
         if (magicNum == MAGIC_NUM_ENCRYPTED) {
-            Serial.println("[433MHz] Message CHIFFRÉ détecté");
+            LOG_INFO(LOG_CAT_RADIO, "[433MHz] Message CHIFFRÉ détecté");
 #ifdef USE_ENCRYPTION
-            uint8_t decryptedBuffer433[PROTOCOL_MAX_MSG_SIZE];
             uint16_t decryptedLen433;
             
             if (Encryption::decrypt(messageData, messageLen, decryptedBuffer433, &decryptedLen433)) {
                 dataToProcess433 = decryptedBuffer433;
                 dataLen433 = decryptedLen433;
-                Serial.print("[433MHz ENCRYPTION] Déchiffré (");
-                Serial.print(messageLen);
-                Serial.print(" → ");
-                Serial.print(decryptedLen433);
-                Serial.println(" bytes)");
+                LOG_INFO(LOG_CAT_RADIO, "[433MHz ENCRYPTION] Déchiffré (%u → %u bytes)", messageLen, decryptedLen433);
             } else {
-                Serial.println("[433MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
-                LoRa.receive();
+                LOG_WARN(LOG_CAT_RADIO, "[433MHz ENCRYPTION] ERREUR: Échec déchiffrement!");
                 return;
             }
 #else
-            Serial.println("[433MHz] ERREUR: Message chiffré reçu mais encryption non activée!");
-            LoRa.receive();
+            LOG_WARN(LOG_CAT_RADIO, "[433MHz] ERREUR: Message chiffré reçu mais encryption non activée!");
             return;
 #endif
         } else if (magicNum == MAGIC_NUM_CLEAR) {
-            Serial.println("[433MHz] Message EN CLAIR détecté");
+            LOG_INFO(LOG_CAT_RADIO, "[433MHz] Message EN CLAIR détecté");
         } else {
-            Serial.print("[433MHz] Magic number inconnu (0x");
-            if (magicNum < 0x10) Serial.print("0");
-            Serial.print(magicNum, HEX);
-            Serial.println(") - tentative de décodage direct");
+            LOG_WARN(LOG_CAT_RADIO, "[433MHz] Magic number inconnu (0x%02X) - tentative de décodage direct", magicNum);
             dataToProcess433 = receivedBuffer433;
             dataLen433 = receivedBytes433;
         }
         
-        ProtocolMessage msg;
-        if (MessageProtocol::decodeMessage(dataToProcess433, dataLen433, &msg)) {
-            Serial.print("[RX-433MHz] Message protocole (");
-            Serial.print(receivedBytes433);
-            Serial.print(" bytes, RSSI: ");
-            Serial.print(rssi);
-            Serial.print(" dBm, SNR: ");
-            Serial.print(snr);
-            Serial.println(" dB):");
-            MessageProtocol::printMessage(&msg, "[RX-433MHz]   ");
+        ProtocolMessageView msg;
+        if (MessageProtocol::decodeMessage(dataToProcess433, dataLen433, msg)) {
+            LOG_INFO(LOG_CAT_PROTO, "[RX-433MHz] Message protocole (%d bytes, RSSI: %d dBm, SNR: %.2f dB):",
+                     receivedBytes433, rssi, snr);
+            MessageProtocol::printMessage(msg, "[RX-433MHz]   ");
+            trackSensorFrames(msg, "[RX-433MHz]   ");
         } else {
-            Serial.print("[RX-433MHz] Message brut: ");
-            for (int i = 0; i < receivedBytes433; i++) {
-                if (receivedBuffer433[i] >= 32 && receivedBuffer433[i] < 127) {
-                    Serial.print((char)receivedBuffer433[i]);
-                } else {
-                    Serial.print(".");
-                }
-            }
-            Serial.print(" (");
-            Serial.print(receivedBytes433);
-            Serial.print(" bytes, RSSI: ");
-            Serial.print(rssi);
-            Serial.print(" dBm, SNR: ");
-            Serial.print(snr);
-            Serial.println(" dB)");
+            LOG_INFO(LOG_CAT_RADIO, "[RX-433MHz] Message brut: %p (%d bytes, RSSI: %d dBm, SNR: %.2f dB)",
+                     LogData(receivedBuffer433, receivedBytes433), receivedBytes433, rssi, snr);
         }
 #else
-        Serial.print("[RX-433MHz] ");
-        for (int i = 0; i < receivedBytes433; i++) {
-            Serial.print((char)receivedBuffer433[i]);
-        }
-        Serial.print(" (");
-        Serial.print(receivedBytes433);
-        Serial.print(" chars, RSSI: ");
-        Serial.print(rssi);
-        Serial.print(" dBm, SNR: ");
-        Serial.print(snr);
-        Serial.println(" dB)");
+        LOG_INFO(LOG_CAT_RADIO, "[RX-433MHz] %t (%d chars, RSSI: %d dBm, SNR: %.2f dB)",
+                 LogData(receivedBuffer433, receivedBytes433), receivedBytes433, rssi, snr);
 #endif
-        
-        // Retourner en mode réception
-        LoRa.receive();
     }
     
     // ====================================
@@ -436,6 +297,13 @@ void loop() {
     if (Serial.available()) {
         String line = Serial.readStringUntil('\n');
         line.trim();
+        // Réponses en Serial.print directs : un bloc, sans ligne du journal au milieu
+        LogSerialLock serialLock;
+        
+        if (line.equalsIgnoreCase("STATUS")) {
+            dualRadio->printStatus();
+            return;
+        }
         
         if (line.length() > 0) {
             // Extraire la commande et le message
@@ -481,22 +349,18 @@ void loop() {
                     finalLen = 1 + msgSize;
                     Serial.print("[CLAIR] ");
 #endif
-                    ResponseStatus rs = e220ttl.sendMessage(finalBuffer, finalLen);
-                    if (rs.getResponseDescription() == "Success") {
+                    if (dualRadio->submit(RADIO_BAND_900, finalBuffer, finalLen)) {
                         Serial.println("OK");
                     } else {
-                        Serial.print("ERREUR: ");
-                        Serial.println(rs.getResponseDescription());
+                        Serial.println("ERREUR: file pleine ou bande indisponible");
                     }
                 }
 #else
                 Serial.println(message);
-                ResponseStatus rs = e220ttl.sendMessage(message);
-                if (rs.getResponseDescription() == "Success") {
+                if (dualRadio->submit(RADIO_BAND_900, (const uint8_t*)message.c_str(), message.length())) {
                     Serial.println("OK");
                 } else {
-                    Serial.print("ERREUR: ");
-                    Serial.println(rs.getResponseDescription());
+                    Serial.println("ERREUR: file pleine ou bande indisponible");
                 }
 #endif
                 
@@ -522,7 +386,6 @@ void loop() {
                         Serial.print("[CHIFFRÉ] ");
                     } else {
                         Serial.println("[ENCRYPTION] ERREUR!");
-                        LoRa.receive();
                         return;
                     }
 #else
@@ -531,10 +394,7 @@ void loop() {
                     finalLen = 1 + msgSize;
                     Serial.print("[CLAIR] ");
 #endif
-                    LoRa.beginPacket();
-                    LoRa.write(finalBuffer, finalLen);
-                    bool success = LoRa.endPacket();
-                    if (success) {
+                    if (dualRadio->submit(RADIO_BAND_433, finalBuffer, finalLen)) {
                         Serial.println("OK");
                     } else {
                         Serial.println("ERREUR");
@@ -542,16 +402,12 @@ void loop() {
                 }
 #else
                 Serial.println(message);
-                LoRa.beginPacket();
-                LoRa.print(message);
-                bool success = LoRa.endPacket();
-                if (success) {
+                if (dualRadio->submit(RADIO_BAND_433, (const uint8_t*)message.c_str(), message.length())) {
                     Serial.println("OK");
                 } else {
                     Serial.println("ERREUR");
                 }
 #endif
-                LoRa.receive();
                 
             } else if (cmd == "ALL") {
                 // Envoyer sur les deux bandes
@@ -583,19 +439,18 @@ void loop() {
                     finalLen = 1 + msgSize;
                     Serial.print("[CLAIR] ");
 #endif
+                    // Soumis aux deux tâches radio : les deux bandes émettent en parallèle
+                    const uint8_t accepted = dualRadio->submit(RADIO_BAND_ALL, finalBuffer, finalLen);
+                    
                     // 900 MHz
-                    ResponseStatus rs900 = e220ttl.sendMessage(finalBuffer, finalLen);
-                    if (rs900.getResponseDescription() == "Success") {
+                    if (accepted & RADIO_BAND_900) {
                         Serial.print("900MHz OK | ");
                     } else {
                         Serial.print("900MHz ERREUR | ");
                     }
                     
                     // 433 MHz
-                    LoRa.beginPacket();
-                    LoRa.write(finalBuffer, finalLen);
-                    bool success433 = LoRa.endPacket();
-                    if (success433) {
+                    if (accepted & RADIO_BAND_433) {
                         Serial.println("433MHz OK");
                     } else {
                         Serial.println("433MHz ERREUR");
@@ -603,25 +458,22 @@ void loop() {
                 }
 #else
                 Serial.println(message);
+                // Soumis aux deux tâches radio : les deux bandes émettent en parallèle
+                const uint8_t accepted = dualRadio->submit(RADIO_BAND_ALL, (const uint8_t*)message.c_str(), message.length());
+                
                 // 900 MHz
-                ResponseStatus rs900 = e220ttl.sendMessage(message);
-                if (rs900.getResponseDescription() == "Success") {
+                if (accepted & RADIO_BAND_900) {
                     Serial.println("900MHz OK");
                 } else {
-                    Serial.print("900MHz ERREUR: ");
-                    Serial.println(rs900.getResponseDescription());
+                    Serial.println("900MHz ERREUR");
                 }
                 // 433 MHz
-                LoRa.beginPacket();
-                LoRa.print(message);
-                bool success433 = LoRa.endPacket();
-                if (success433) {
+                if (accepted & RADIO_BAND_433) {
                     Serial.println("433MHz OK");
                 } else {
                     Serial.println("433MHz ERREUR");
                 }
 #endif
-                LoRa.receive();
                 
             } else {
                 Serial.println("[INFO] Commande non reconnue: " + cmd);
@@ -2,7 +2,9 @@
 #include <HardwareSerial.h>
 #include <LoRa_E220.h>
 #include "../lora/LoRaConfig.h"
+#include "../lora/FrameAssembler.h"
 #include "../protocol/MessageProtocol.h"
+#include "../utils/Log.h"
 
 #ifdef USE_ENCRYPTION
 #include "../security/Encryption.h"
@@ -10,6 +12,8 @@
 
 #ifdef USE_HUMAN_SENSOR_24GHZ
 #include "../sensors/HumanSensor24GHz.h"
+#include "../utils/AirTime.h"
+#include "../utils/DutyCycleBudget.h"
 #endif
 
 // HardwareSerial pour E220 (UART2 sur ESP32)
@@ -19,6 +23,9 @@ HardwareSerial SerialE220(2);
 // Les pins sont définis dans LoRaConfig.h
 LoRa_E220 e220ttl(&SerialE220, PIN_LORA_AUX, PIN_LORA_M0, PIN_LORA_M1);
 
+// Délimitation des trames reçues (AUX + silence UART)
+FrameAssembler frameAssembler(&SerialE220, PIN_LORA_AUX, 9600);
+
 // Les constantes de configuration sont définies dans LoRaConfig.h
 // CONFIG_ADDH, CONFIG_ADDL, CONFIG_CHAN sont déjà définis
 
@@ -26,6 +33,24 @@ LoRa_E220 e220ttl(&SerialE220, PIN_LORA_AUX, PIN_LORA_M0, PIN_LORA_M1);
 uint32_t lastPingTimestamp = 0;
 bool waitingForPong = false;
 
+// Trames radar compactes reçues : références des deltas, par source
+SensorFrameDecoder sensorFrameDecoder;
+
+void trackSensorFrame(const ProtocolMessageView& msg) {
+	if (!MessageProtocol::isCompactSensorData(msg)) return;
+	
+	SensorFrame frame;
+	if (!sensorFrameDecoder.decode(msg, frame)) {
+		LOG_INFO(LOG_CAT_PROTO, "[RX] Delta radar sans référence, attente de la prochaine keyframe");
+		return;
+	}
+	// Les keyframes sont déjà affichées en clair par printMessage
+	if (!MessageProtocol::isSensorKeyframe(msg)) {
+		LOG_INFO(LOG_CAT_PROTO, "[RX] Cibles reconstruites : %u", frame.count);
+		MessageProtocol::printSensorTargets(frame, "[RX]   ");
+	}
+}
+
 #ifdef USE_HUMAN_SENSOR_24GHZ
 // HardwareSerial pour le capteur humain (UART1 sur ESP32)
 HardwareSerial SerialSensor(1);
@@ -39,19 +64,136 @@ uint8_t lastSentHumanCount = 255; // Valeur invalide pour forcer le premier envo
 
 // Flag pour activer/désactiver l'envoi automatique
 bool autoSendEnabled = (HUMAN_SENSOR_AUTO_SEND_INTERVAL > 0);
+
+// Duty cycle de l'envoi automatique (priorité basse : envoi sauté si le budget est serré)
+static const uint32_t SIMPLE_AIR_RATE_BPS = 2400; // débit imposé par configureModule()
+DutyCycleBudget sensorDutyCycle(DUTY_CYCLE_PERMILLE_E220);
+bool sensorBudgetExhausted = false;
+
+#ifdef SENSOR_COMPACT_ENCODING
+SensorFrameEncoder sensorFrameEncoder(SENSOR_KEYFRAME_INTERVAL);
+#endif
+
+// Trame capteur non émise (budget, chiffrement ou module) : si c'était une
+// keyframe, le récepteur ne pourrait plus décoder les deltas qui la suivent
+void sensorFrameNotSent() {
+#ifdef SENSOR_COMPACT_ENCODING
+	sensorFrameEncoder.requestKeyframe();
+#endif
+}
+
+bool sensorSendWithinBudget(uint16_t len) {
+	const uint32_t airtimeUs = AirTime::e220Us(len, SIMPLE_AIR_RATE_BPS);
+	if (!sensorDutyCycle.allows(airtimeUs, TX_PRIO_LOW)) {
+		if (!sensorBudgetExhausted) {
+			sensorBudgetExhausted = true;
+			Serial.println("[AUTO] Budget duty cycle atteint, envois automatiques suspendus");
+			sensorDutyCycle.print("900MHz");
+		}
+		return false;
+	}
+	if (sensorBudgetExhausted) {
+		sensorBudgetExhausted = false;
+		Serial.println("[AUTO] Budget duty cycle disponible, reprise des envois");
+	}
+	sensorDutyCycle.spend(airtimeUs);
+	return true;
+}
+
+// Budget puis émission ; un refus ne saute que cet envoi, la réception de loop() continue
+bool sendSensorFrame(const uint8_t* finalBuffer, uint16_t finalLen) {
+	if (!sensorSendWithinBudget(finalLen)) return false;
+	ResponseStatus rs = e220ttl.sendMessage(finalBuffer, finalLen);
+	return rs.getResponseDescription() == "Success";
+}
+
+#ifdef BATCH_SENSOR_READINGS
+// Lectures groupées : un en-tête, un chiffrement et un préambule pour tout le lot
+ProtocolBatchWriter sensorBatch(DEVICE_ID, BATCH_MAX_FRAME_SIZE, BATCH_MAX_AGE_MS, BATCH_MIN_FREE_BYTES);
+
+// @return false si le lot n'a pas pu partir (ses lectures sont perdues)
+bool flushSensorBatch() {
+	const uint8_t records = sensorBatch.getRecordCount();
+	uint8_t buffer[PROTOCOL_MAX_MSG_SIZE];
+	uint16_t msgSize = sensorBatch.finish(millis(), buffer);
+	if (msgSize == 0) return true;
+	
+	uint8_t finalBuffer[PROTOCOL_MAX_MSG_SIZE];
+	uint16_t finalLen = 0;
+	
+#ifdef USE_ENCRYPTION
+	uint8_t encryptedBuffer[PROTOCOL_MAX_MSG_SIZE];
+	uint16_t encryptedLen;
+	if (!Encryption::encrypt(buffer, msgSize, encryptedBuffer, &encryptedLen)) {
+		sensorFrameNotSent();
+		return false;
+	}
+	finalBuffer[0] = MAGIC_NUM_ENCRYPTED;
+	memcpy(finalBuffer + 1, encryptedBuffer, encryptedLen);
+	finalLen = 1 + encryptedLen;
+#else
+	finalBuffer[0] = MAGIC_NUM_CLEAR;
+	memcpy(finalBuffer + 1, buffer, msgSize);
+	finalLen = 1 + msgSize;
+#endif
+	
+	// Lot refusé par le budget : les lectures sont perdues, les suivantes repartent à zéro
+	if (!sendSensorFrame(finalBuffer, finalLen)) {
+		sensorFrameNotSent();
+		return false;
+	}
+	LOG_INFO(LOG_CAT_SENSOR, "[AUTO] 📡 Lot capteur: %u %s | %u bytes",
+	         records, records > 1 ? "lectures" : "lecture", finalLen);
+	return true;
+}
+#endif
 #endif
 
+// Lecture de la configuration à un seul débit UART, trois essais
+// (comme LoRaModule::probeConfiguration)
+bool readModuleConfigurationAt(unsigned long baud, Configuration& config) {
+	SerialE220.flush();
+	SerialE220.updateBaudRate(baud);
+	for (int i = 0; i < 3; i++) {
+		ResponseStructContainer c = e220ttl.getConfiguration();
+		const bool ok = (c.status.getResponseDescription() == "Success");
+		if (ok) {
+			config = *(Configuration*)c.data;
+		}
+		c.close();
+		if (ok) return true;
+		if (i < 2) delay(200);
+	}
+	return false;
+}
+
+// Module en mode configuration : il répond à 9600 bauds. Le débit du mode
+// normal n'aboutit que si le module n'a pas quitté le mode normal (M0/M1
+// sans effet) ; SerialE220 reste au débit qui a répondu
+bool readModuleConfiguration(Configuration& config) {
+	const unsigned long rates[] = { E220_CONFIG_BAUD, e220UartBaud(UART_BAUD) };
+	for (uint8_t r = 0; r < 2; r++) {
+		if (r > 0 && rates[r] == rates[0]) break;
+		if (readModuleConfigurationAt(rates[r], config)) return true;
+	}
+	SerialE220.flush();
+	SerialE220.updateBaudRate(E220_CONFIG_BAUD);
+	return false;
+}
+
 void configureModule() {
 	Serial.println("[LoRa] Configuration du module...");
 	
-	// Mettre en mode configuration
+	// Débit UART du mode normal, adopté seulement si le module y répond en mode normal
+	unsigned long normalModeBaud = E220_CONFIG_BAUD;
+	
+	// Mettre en mode configuration (toujours à 9600 bauds)
 	e220ttl.setMode(MODE_3_CONFIGURATION);
 	delay(300);
 	
 	// Lire la configuration actuelle
-	ResponseStructContainer c = e220ttl.getConfiguration();
-	if (c.status.getResponseDescription() == "Success") {
-		Configuration configuration = *(Configuration*)c.data;
+	Configuration configuration;
+	if (readModuleConfiguration(configuration)) {
 		
 		// Afficher la configuration actuelle
 		float currentFreq = calculateFrequency900MHz(configuration.CHAN);
@@ -66,7 +208,7 @@ void configureModule() {
 	configuration.ADDL = CONFIG_ADDL;
 	configuration.CHAN = CONFIG_CHAN_E220; // Canal configuré
 		configuration.SPED.airDataRate = AIR_DATA_RATE_010_24; // 2.4kbps
-		configuration.SPED.uartBaudRate = UART_BPS_9600;   // 9600 bauds
+		configuration.SPED.uartBaudRate = UART_BAUD;       // Liaison rapide (Config.h)
 		configuration.SPED.uartParity = MODE_00_8N1;           // 8N1
 		configuration.OPTION.transmissionPower = POWER_22;      // 22dBm (max)
 		configuration.OPTION.RSSIAmbientNoise = RSSI_AMBIENT_NOISE_DISABLED;
@@ -87,25 +229,56 @@ void configureModule() {
 		ResponseStatus rs = e220ttl.setConfiguration(configuration, WRITE_CFG_PWR_DWN_SAVE);
 		if (rs.getResponseDescription() == "Success") {
 			Serial.println("[LoRa] Configuration sauvegardée avec succès!");
+			
+			// Relecture à 9600 bauds : le débit enregistré, pas encore la liaison à ce débit
+			Configuration check;
+			if (readModuleConfiguration(check) && check.SPED.uartBaudRate == UART_BAUD) {
+				normalModeBaud = e220UartBaud(UART_BAUD);
+			} else {
+				Serial.println("[LoRa] ATTENTION: Débit UART non confirmé, repli à 9600 bauds");
+				configuration.SPED.uartBaudRate = UART_BPS_9600;
+				e220ttl.setConfiguration(configuration, WRITE_CFG_PWR_DWN_SAVE);
+			}
 		} else {
 			Serial.print("[LoRa] Erreur sauvegarde: ");
 			Serial.println(rs.getResponseDescription());
 		}
-		
-		c.close();
 	} else {
-		Serial.println("[LoRa] Erreur lecture configuration");
+		Serial.println("[LoRa] Erreur lecture configuration (9600 bauds et débit du mode normal)");
 	}
 	
-	// Revenir en mode normal
+	// Revenir en mode normal, puis passer la liaison UART au débit enregistré
 	e220ttl.setMode(MODE_0_NORMAL);
 	delay(200);
-	Serial.println("[LoRa] Module en mode normal (prêt à envoyer/recevoir)");
+	
+	// Débit rapide gardé seulement si un échange y aboutit une fois en mode normal
+	Configuration linkCheck;
+	if (normalModeBaud != E220_CONFIG_BAUD && !readModuleConfigurationAt(normalModeBaud, linkCheck)) {
+		Serial.print("[LoRa] ATTENTION: Pas de réponse du module à ");
+		Serial.print(normalModeBaud);
+		Serial.println(" bauds en mode normal, repli à 9600 bauds");
+		SerialE220.flush();
+		SerialE220.updateBaudRate(E220_CONFIG_BAUD);
+		e220ttl.setMode(MODE_3_CONFIGURATION);
+		delay(300);
+		configuration.SPED.uartBaudRate = UART_BPS_9600;
+		e220ttl.setConfiguration(configuration, WRITE_CFG_PWR_DWN_SAVE);
+		e220ttl.setMode(MODE_0_NORMAL);
+		delay(200);
+		normalModeBaud = E220_CONFIG_BAUD;
+	}
+	SerialE220.flush();
+	SerialE220.updateBaudRate(normalModeBaud);
+	frameAssembler.setBaud(normalModeBaud);
+	Serial.print("[LoRa] Module en mode normal (prêt à envoyer/recevoir), UART ");
+	Serial.print(normalModeBaud);
+	Serial.println(" bauds");
 }
 
 void setup() {
 	Serial.begin(115200);
 	while (!Serial) {}
+	Log::begin();
 	
 	Serial.println();
 	Serial.println("========================================");
@@ -192,6 +365,7 @@ void loop() {
 			lastSensorSendTime = millis();
 			
 			uint8_t currentCount = humanSensor.getHumanCount();
+			const bool countChanged = (currentCount != lastSentHumanCount);
 			lastSentHumanCount = currentCount;
 			
 			// Récupérer toutes les données des cibles
@@ -201,10 +375,42 @@ void loop() {
 			
 			// Encoder le message avec toutes les données
 			uint8_t buffer[PROTOCOL_MAX_MSG_SIZE];
+#ifdef SENSOR_COMPACT_ENCODING
+			SensorFrame frame;
+			frame.count = currentCount;
+			for (uint8_t i = 0; i < currentCount && i < SENSOR_DATA_MAX_TARGETS; i++) {
+				frame.x[i] = x[i];
+				frame.y[i] = y[i];
+				frame.speed[i] = speed[i];
+				frame.resolution[i] = resolution[i];
+			}
+			uint16_t msgSize = sensorFrameEncoder.encode(DEVICE_ID, frame, buffer);
+#else
 			uint16_t msgSize = MessageProtocol::encodeSensorDataMessage(
 				DEVICE_ID, currentCount, x, y, speed, resolution, buffer
 			);
+#endif
 			
+#ifdef BATCH_SENSOR_READINGS
+			// Lot plein : on l'envoie avant d'y placer la nouvelle lecture
+			if (!sensorBatch.addMessage(buffer, msgSize, lastSensorSendTime)) {
+				const bool flushed = flushSensorBatch();
+#ifdef SENSOR_COMPACT_ENCODING
+				// Lot perdu : la lecture, encodée avant, référence peut-être une keyframe qu'il contenait
+				if (!flushed) {
+					msgSize = sensorFrameEncoder.encode(DEVICE_ID, frame, buffer);
+				}
+#else
+				(void)flushed;
+#endif
+				sensorBatch.addMessage(buffer, msgSize, lastSensorSendTime);
+			}
+			// Un changement de présence part tout de suite, les lectures stables attendent le lot
+			if (countChanged) {
+				flushSensorBatch();
+			}
+#else
+			(void)countChanged;
 			// Créer le buffer final avec magic number
 			uint8_t finalBuffer[PROTOCOL_MAX_MSG_SIZE];
 			uint16_t finalLen = 0;
@@ -217,54 +423,49 @@ void loop() {
 				memcpy(finalBuffer + 1, encryptedBuffer, encryptedLen);
 				finalLen = 1 + encryptedLen;
 				
-				ResponseStatus rs = e220ttl.sendMessage(finalBuffer, finalLen);
-				if (rs.getResponseDescription() == "Success") {
-					Serial.print("[AUTO] 📡 Capteur: ");
-					Serial.print(currentCount);
-					Serial.print(currentCount > 1 ? " cibles" : (currentCount == 1 ? " cible" : " cible"));
-					Serial.print(" détaillées | ");
-					Serial.print(finalLen);
-					Serial.println(" bytes");
+				if (sendSensorFrame(finalBuffer, finalLen)) {
+					LOG_INFO(LOG_CAT_SENSOR, "[AUTO] 📡 Capteur: %u %s détaillées | %u bytes",
+					         currentCount, currentCount > 1 ? "cibles" : "cible", finalLen);
+				} else {
+					sensorFrameNotSent();
 				}
+			} else {
+				sensorFrameNotSent();
 			}
 #else
 			finalBuffer[0] = MAGIC_NUM_CLEAR;
 			memcpy(finalBuffer + 1, buffer, msgSize);
 			finalLen = 1 + msgSize;
 			
-			ResponseStatus rs = e220ttl.sendMessage(finalBuffer, finalLen);
-			if (rs.getResponseDescription() == "Success") {
-				Serial.print("[AUTO] 📡 Capteur: ");
-				Serial.print(currentCount);
-				Serial.print(currentCount > 1 ? " cibles" : (currentCount == 1 ? " cible" : " cible"));
-				Serial.print(" détaillées | ");
-				Serial.print(finalLen);
-				Serial.println(" bytes");
+			if (sendSensorFrame(finalBuffer, finalLen)) {
+				LOG_INFO(LOG_CAT_SENSOR, "[AUTO] 📡 Capteur: %u %s détaillées | %u bytes",
+				         currentCount, currentCount > 1 ? "cibles" : "cible", finalLen);
+			} else {
+				sensorFrameNotSent();
 			}
+#endif
 #endif
 		}
 	}
+	
+#ifdef BATCH_SENSOR_READINGS
+	if (sensorBatch.shouldFlush(millis())) {
+		flushSensorBatch();
+	}
+#endif
 #endif
 
 	// Vérifier si on reçoit un message
-	if (e220ttl.available() > 0) {
-		// Lire directement les octets bruts pour éviter la troncature sur les octets nuls
-		uint8_t buffer[PROTOCOL_MAX_MSG_SIZE];
-		int bytesRead = 0;
-		
-		// Attendre un peu pour que tous les octets arrivent
-		delay(50);
-		
-		// Lire tous les octets disponibles
-		while (SerialE220.available() && bytesRead < PROTOCOL_MAX_MSG_SIZE) {
-			buffer[bytesRead++] = SerialE220.read();
-		}
+	if (frameAssembler.poll()) {
+		// Trame complète dès que le module a fini de la sortir (pas de delay, pas de troncature)
+		uint8_t* buffer = frameAssembler.data();
+		int bytesRead = (int)frameAssembler.length();
 		
 		if (bytesRead > 0) {
 #ifdef USE_CUSTOM_PROTOCOL
 			// Vérifier le magic number
 			if (bytesRead < 4) {
-				Serial.println("[RX] Message trop court, ignoré");
+				LOG_WARN(LOG_CAT_RADIO, "[RX] Message trop court, ignoré");
 				return;
 			}
 			
@@ -272,76 +473,67 @@ void loop() {
 			uint8_t* messageData = buffer + 1; // Données après le magic number
 			uint16_t messageLen = bytesRead - 1;
 			
+			// Reste en portée tant que msg, une vue sur ces octets, est utilisé
+			uint8_t decryptedBuffer[PROTOCOL_MAX_MSG_SIZE];
 			uint8_t* dataToProcess = messageData;
 			uint16_t dataLen = messageLen;
 			
 			// DEBUG: Afficher les données brutes reçues
-			Serial.print("[DEBUG] Magic: 0x");
-			if (magicNum < 0x10) Serial.print("0");
-			Serial.print(magicNum, HEX);
-			Serial.print(" | Données (HEX): ");
-			for (int i = 0; i < messageLen && i < 16; i++) {
-				if (messageData[i] < 0x10) Serial.print("0");
-				Serial.print(messageData[i], HEX);
-				Serial.print(" ");
-			}
-			Serial.println();
+			LOG_DEBUG(LOG_CAT_RADIO, "[DEBUG] Magic: 0x%02X | Données (HEX): %h", magicNum,
+			          LogData(messageData, messageLen < 16 ? messageLen : 16));
 			
 			if (magicNum == MAGIC_NUM_ENCRYPTED) {
 				// Message chiffré - déchiffrer
-				Serial.println("[RX] Message CHIFFRÉ détecté");
-				uint8_t decryptedBuffer[PROTOCOL_MAX_MSG_SIZE];
+				LOG_INFO(LOG_CAT_RADIO, "[RX] Message CHIFFRÉ détecté");
 				uint16_t decryptedLen;
 				
 				if (Encryption::decrypt(messageData, messageLen, decryptedBuffer, &decryptedLen)) {
 					dataToProcess = decryptedBuffer;
 					dataLen = decryptedLen;
-					Serial.print("[ENCRYPTION] Déchiffré (");
-					Serial.print(messageLen);
-					Serial.print(" → ");
-					Serial.print(decryptedLen);
-					Serial.println(" bytes)");
+					LOG_INFO(LOG_CAT_RADIO, "[ENCRYPTION] Déchiffré (%u → %u bytes)", messageLen, decryptedLen);
 					
 					// DEBUG: Afficher les données déchiffrées
-					Serial.print("[DEBUG] Déchiffré (HEX): ");
-					for (int i = 0; i < decryptedLen && i < 16; i++) {
-						if (decryptedBuffer[i] < 0x10) Serial.print("0");
-						Serial.print(decryptedBuffer[i], HEX);
-						Serial.print(" ");
-					}
-					Serial.println();
+					LOG_DEBUG(LOG_CAT_RADIO, "[DEBUG] Déchiffré (HEX): %h",
+					          LogData(decryptedBuffer, decryptedLen < 16 ? decryptedLen : 16));
 				} else {
-					Serial.println("[ENCRYPTION] ERREUR: Échec du déchiffrement!");
-					Serial.println("[INFO] Message ignoré (clé ou mode incompatible)");
+					LOG_WARN(LOG_CAT_RADIO, "[ENCRYPTION] ERREUR: Échec du déchiffrement!");
+					LOG_WARN(LOG_CAT_RADIO, "[INFO] Message ignoré (clé ou mode incompatible)");
 					return;
 				}
 			} else if (magicNum == MAGIC_NUM_CLEAR) {
 				// Message en clair
-				Serial.println("[RX] Message EN CLAIR détecté");
+				LOG_INFO(LOG_CAT_RADIO, "[RX] Message EN CLAIR détecté");
 			} else {
 				// Magic number inconnu - peut-être ancien format sans magic number
-				Serial.print("[RX] Magic number inconnu (0x");
-				if (magicNum < 0x10) Serial.print("0");
-				Serial.print(magicNum, HEX);
-				Serial.println(") - tentative de décodage direct");
+				LOG_WARN(LOG_CAT_RADIO, "[RX] Magic number inconnu (0x%02X) - tentative de décodage direct", magicNum);
 				// Essayer de décoder le message complet (avec le magic number)
 				dataToProcess = buffer;
 				dataLen = bytesRead;
 			}
 			
 			// Décoder le message avec le protocole
-			ProtocolMessage msg;
-			if (MessageProtocol::decodeMessage(dataToProcess, dataLen, &msg)) {
-				Serial.print("[RX] Message protocole reçu (");
-				Serial.print(bytesRead);
-				Serial.println(" bytes):");
-				MessageProtocol::printMessage(&msg, "[RX]   ");
+			ProtocolMessageView msg;
+			if (MessageProtocol::decodeMessage(dataToProcess, dataLen, msg)) {
+				LOG_INFO(LOG_CAT_PROTO, "[RX] Message protocole reçu (%d bytes):", bytesRead);
+				MessageProtocol::printMessage(msg, "[RX]   ");
+				
+				// Deltas radar : reconstruits contre la référence de leur source
+				if (msg.type() == MSG_TYPE_BATCH) {
+					ProtocolBatchReader reader(msg);
+					ProtocolMessageView record;
+					uint16_t ageDs;
+					while (reader.next(record, ageDs)) {
+						trackSensorFrame(record);
+					}
+				} else {
+					trackSensorFrame(msg);
+				}
 				
 			// Gestion automatique PING/PONG
-			if (msg.type == MSG_TYPE_PING && msg.dataSize >= 4) {
+			if (msg.type() == MSG_TYPE_PING && msg.dataSize() >= 4) {
 				// Répondre automatiquement avec un PONG
 				uint8_t pongBuffer[PROTOCOL_MAX_MSG_SIZE];
-				uint16_t pongSize = MessageProtocol::encodePongMessage(DEVICE_ID, msg.data, pongBuffer);
+				uint16_t pongSize = MessageProtocol::encodePongMessage(DEVICE_ID, msg.data(), pongBuffer);
 				
 				// Créer le buffer final avec magic number
 				uint8_t finalPongBuffer[PROTOCOL_MAX_MSG_SIZE];
@@ -359,7 +551,7 @@ void loop() {
 					
 					ResponseStatus rs = e220ttl.sendMessage(finalPongBuffer, finalPongLen);
 					if (rs.getResponseDescription() == "Success") {
-						Serial.println("[PING/PONG] Réponse PONG chiffrée envoyée");
+						LOG_INFO(LOG_CAT_RADIO, "[PING/PONG] Réponse PONG chiffrée envoyée");
 					}
 				}
 #else
@@ -370,41 +562,23 @@ void loop() {
 				
 				ResponseStatus rs = e220ttl.sendMessage(finalPongBuffer, finalPongLen);
 				if (rs.getResponseDescription() == "Success") {
-					Serial.println("[PING/PONG] Réponse PONG envoyée");
+					LOG_INFO(LOG_CAT_RADIO, "[PING/PONG] Réponse PONG envoyée");
 				}
 #endif
-				} else if (msg.type == MSG_TYPE_PONG && msg.dataSize >= 4 && waitingForPong) {
+				} else if (msg.type() == MSG_TYPE_PONG && msg.dataSize() >= 4 && waitingForPong) {
 					// Calculer le RTT
-					uint32_t originalTimestamp = msg.data[0] | (msg.data[1] << 8) | (msg.data[2] << 16) | (msg.data[3] << 24);
+					uint32_t originalTimestamp = MessageProtocol::decodeTimestamp(msg);
 					uint32_t rtt = millis() - originalTimestamp;
-					Serial.print("[PING/PONG] RTT: ");
-					Serial.print(rtt);
-					Serial.println(" ms");
+					LOG_INFO(LOG_CAT_RADIO, "[PING/PONG] RTT: %u ms", rtt);
 					waitingForPong = false;
 				}
 			} else {
 				// Message non protocole ou invalide
-				Serial.print("[RX] Message brut: ");
-				for (int i = 0; i < bytesRead; i++) {
-					if (buffer[i] >= 32 && buffer[i] < 127) {
-						Serial.print((char)buffer[i]);
-					} else {
-						Serial.print(".");
-					}
-				}
-				Serial.print(" (");
-				Serial.print(bytesRead);
-				Serial.println(" bytes)");
+				LOG_INFO(LOG_CAT_RADIO, "[RX] Message brut: %p (%d bytes)", LogData(buffer, bytesRead), bytesRead);
 			}
 #else
 			// Mode texte brut
-			Serial.print("[RX] Broadcast reçu: ");
-			for (int i = 0; i < bytesRead; i++) {
-				Serial.print((char)buffer[i]);
-			}
-			Serial.print(" (");
-			Serial.print(bytesRead);
-			Serial.println(" caractères)");
+			LOG_INFO(LOG_CAT_RADIO, "[RX] Broadcast reçu: %t (%d caractères)", LogData(buffer, bytesRead), bytesRead);
 #endif
 		}
 	}
@@ -413,6 +587,8 @@ void loop() {
 	if (Serial.available()) {
 		String line = Serial.readStringUntil('\n');
 		line.trim();
+		// Réponses en Serial.print directs : un bloc, sans ligne du journal au milieu
+		LogSerialLock serialLock;
 		
 		if (line.length() > 0) {
 #ifdef USE_CUSTOM_PROTOCOL
@@ -2,20 +2,41 @@
 #include <SPI.h>
 #include <LoRa.h>
 #include "../lora/LoRaConfig_XL1278.h"
+#include "../utils/SpscRing.h"
 
-// Variables globales
-String receivedMessage = "";
-bool messageReceived = false;
+// Trame reçue, remplie dans l'interruption DIO0
+struct RxPacket {
+    uint32_t timestampMs;
+    int16_t rssi;
+    float snr;
+    uint16_t len;
+    uint8_t data[MAX_PACKET_SIZE];
+};
 
-// Callback pour réception de messages
+// File sans verrou interruption -> loop() : une rafale n'écrase plus la trame précédente
+SpscRing<RxPacket, XL1278_RX_RING_SLOTS> rxRing;
+uint32_t reportedRxOverflows = 0;
+
+// Callback pour réception de messages (contexte interruption : pas d'allocation)
 void onReceive(int packetSize) {
     if (packetSize == 0) return;
     
-    receivedMessage = "";
-    while (LoRa.available()) {
-        receivedMessage += (char)LoRa.read();
+    RxPacket* pkt = rxRing.reserve();
+    if (!pkt) {
+        // File pleine : vider la FIFO radio, la trame est comptée en débordement
+        while (LoRa.available()) LoRa.read();
+        return;
+    }
+    
+    uint16_t n = 0;
+    while (LoRa.available() && n < MAX_PACKET_SIZE) {
+        pkt->data[n++] = (uint8_t)LoRa.read();
     }
-    messageReceived = true;
+    pkt->len = n;
+    pkt->rssi = (int16_t)LoRa.packetRssi();
+    pkt->snr = LoRa.packetSnr();
+    pkt->timestampMs = millis();
+    rxRing.commit();
 }
 
 void configureModule() {
@@ -25,7 +46,7 @@ void configureModule() {
     LoRa.setSignalBandwidth(LORA_BANDWIDTH);
     LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR);
     LoRa.setCodingRate4(LORA_CODING_RATE);
-    LoRa.setTxPower(LORA_TX_POWER);
+    LoRa.setTxPower(LORA_TX_POWER_XL);
     LoRa.setSyncWord(LORA_SYNC_WORD);
     
     Serial.println("[LoRa] Paramètres configurés:");
@@ -40,7 +61,7 @@ void configureModule() {
     Serial.print("  - Coding Rate: 4/");
     Serial.println(LORA_CODING_RATE);
     Serial.print("  - Puissance TX: ");
-    Serial.print(LORA_TX_POWER);
+    Serial.print(LORA_TX_POWER_XL);
     Serial.println(" dBm");
     Serial.println("[LoRa] Module configuré avec succès!");
 }
@@ -120,26 +141,31 @@ void setup() {
 }
 
 void loop() {
-    // Vérifier si un message a été reçu
-    if (messageReceived) {
-        messageReceived = false;
-        
-        // Obtenir le RSSI du dernier paquet
-        int rssi = LoRa.packetRssi();
-        float snr = LoRa.packetSnr();
-        
+    // Vider les trames reçues (RSSI/SNR mesurés dans l'interruption, avec la trame)
+    RxPacket* pkt;
+    while ((pkt = rxRing.front()) != nullptr) {
         Serial.print("[RX] Broadcast reçu: ");
-        Serial.print(receivedMessage);
+        for (uint16_t i = 0; i < pkt->len; i++) {
+            Serial.print((char)pkt->data[i]);
+        }
         Serial.print(" (");
-        Serial.print(receivedMessage.length());
+        Serial.print(pkt->len);
         Serial.print(" caractères, RSSI: ");
-        Serial.print(rssi);
+        Serial.print(pkt->rssi);
         Serial.print(" dBm, SNR: ");
-        Serial.print(snr);
-        Serial.println(" dB)");
-        
-        // Retourner en mode réception
-        LoRa.receive();
+        Serial.print(pkt->snr);
+        Serial.print(" dB, il y a ");
+        Serial.print(millis() - pkt->timestampMs);
+        Serial.println(" ms)");
+        rxRing.pop();
+    }
+    
+    const uint32_t rxOverflows = rxRing.getOverflowCount();
+    if (rxOverflows != reportedRxOverflows) {
+        Serial.print("[RX] ATTENTION: ");
+        Serial.print(rxOverflows - reportedRxOverflows);
+        Serial.println(" trame(s) perdue(s), file de réception pleine");
+        reportedRxOverflows = rxOverflows;
     }
     
     // Gérer les commandes série pour l'envoi
@@ -0,0 +1,335 @@
+#include "../protocol/AdaptiveRateController.h"
+#ifdef RADIO_SIM
+#include "../sim/SimRadio.h"
+#else
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#endif
+#include "../utils/Log.h"
+#include <cstring>
+
+template <class Radio>
+AdaptiveRateController<Radio>::AdaptiveRateController(SecurityManager* security, Radio* lora,
+                                                       FragmentManager<Radio>* fragment, NVSManager* nvs)
+	: security(security), lora(lora), fragment(fragment), nvs(nvs), enabled(true), state(RATE_IDLE),
+	  targetIndex(0), previousIndex(0), attempts(0), goodWindows(0), ctrlSeq(0), pendingSeq(0),
+	  lastReqSender(0), lastReqSeq(0),
+	  stateSinceMs(0), lastDowngradeMs(0), deviceId(0), sessionKey(nullptr) {
+	snapshot = fragment->getLinkStats();
+	// Une montée reste possible dès le démarrage
+	lastDowngradeMs = millis() - HOLD_AFTER_DOWNGRADE_MS;
+	// Anti-rejeu restauré avec l'état d'appairage (absent : aucun REQ accepté)
+	nvs->loadRateReqGuard(lastReqSender, lastReqSeq);
+}
+
+template <class Radio>
+void AdaptiveRateController<Radio>::enterState(State s) {
+	state = s;
+	stateSinceMs = millis();
+}
+
+template <class Radio>
+void AdaptiveRateController<Radio>::sendControl(uint8_t op, uint32_t seq, uint8_t index) {
+	if (!sessionKey) return;
+	
+	uint8_t pkt[1 + 1 + 4 + 4 + 1 + 16];
+	size_t n = 0;
+	pkt[n++] = (uint8_t)PKT_RATE_CTRL;
+	pkt[n++] = op;
+	pkt[n++] = (deviceId >> 24) & 0xFF;
+	pkt[n++] = (deviceId >> 16) & 0xFF;
+	pkt[n++] = (deviceId >> 8) & 0xFF;
+	pkt[n++] = deviceId & 0xFF;
+	pkt[n++] = (seq >> 24) & 0xFF;
+	pkt[n++] = (seq >> 16) & 0xFF;
+	pkt[n++] = (seq >> 8) & 0xFF;
+	pkt[n++] = seq & 0xFF;
+	pkt[n++] = index;
+	
+	security->hmacSha256Trunc16(sessionKey, 16, pkt, n, pkt + n);
+	n += 16;
+	
+	lora->sendPacket(pkt, n, TX_PRIO_HIGH, lora->getPeerAddress());
+}
+
+template <class Radio>
+bool AdaptiveRateController<Radio>::requestRate(uint8_t index) {
+	if (state != RATE_IDLE || !sessionKey) {
+		return false;
+	}
+	if (index >= lora->getRateCount() || index == lora->getRateIndex()) {
+		return false;
+	}
+	
+	targetIndex = index;
+	pendingSeq = ++ctrlSeq;
+	attempts = 1;
+	enterState(RATE_WAIT_ACK);
+	
+	LogSerialLock lock;
+	Serial.print("[RATE] Demande ");
+	Serial.print(lora->getRateName(lora->getRateIndex()));
+	Serial.print(" -> ");
+	Serial.println(lora->getRateName(index));
+	sendControl(OP_REQ, pendingSeq, index);
+	return true;
+}
+
+template <class Radio>
+void AdaptiveRateController<Radio>::commit() {
+	LogSerialLock lock;
+	Serial.print("[RATE] Débit confirmé avec le pair: ");
+	Serial.println(lora->getRateName(lora->getRateIndex()));
+	snapshot = fragment->getLinkStats();
+	goodWindows = 0;
+	enterState(RATE_IDLE);
+}
+
+template <class Radio>
+void AdaptiveRateController<Radio>::revert(const char* reason) {
+	{
+		LogSerialLock lock;
+		Serial.print("[RATE] ");
+		Serial.print(reason);
+		Serial.print(", retour à ");
+		Serial.println(lora->getRateName(previousIndex));
+	}
+	// Hors verrou : setRateIndex() vide la file TX avant de basculer
+	lora->setRateIndex(previousIndex);
+	snapshot = fragment->getLinkStats();
+	goodWindows = 0;
+	lastDowngradeMs = millis();
+	enterState(RATE_IDLE);
+}
+
+template <class Radio>
+void AdaptiveRateController<Radio>::process(uint32_t deviceId, const uint8_t* sessionKey,
+                                            bool isPaired, bool peerOnline) {
+	this->deviceId = deviceId;
+	this->sessionKey = sessionKey;
+	
+	if (!isPaired) {
+		if (state != RATE_IDLE) enterState(RATE_IDLE);
+		return;
+	}
+	
+	const unsigned long now = millis();
+	
+	switch (state) {
+		case RATE_WAIT_ACK:
+			if (now - stateSinceMs < HANDSHAKE_TIMEOUT_MS) break;
+			if (attempts < MAX_ATTEMPTS) {
+				attempts++;
+				stateSinceMs = now;
+				sendControl(OP_REQ, pendingSeq, targetIndex);
+			} else {
+				Serial.println("[RATE] Pas de réponse du pair, débit inchangé");
+				enterState(RATE_IDLE);
+			}
+			break;
+			
+		case RATE_PROBING:
+			if (now - stateSinceMs < PROBE_INTERVAL_MS) break;
+			if (attempts < MAX_ATTEMPTS) {
+				attempts++;
+				stateSinceMs = now;
+				sendControl(OP_PROBE, pendingSeq, targetIndex);
+			} else {
+				revert("Pair muet au nouveau débit");
+			}
+			break;
+			
+		case RATE_PROBATION:
+			if (now - stateSinceMs >= PROBATION_MS) {
+				revert("Aucune sonde reçue au nouveau débit");
+			}
+			break;
+			
+		case RATE_IDLE:
+			// Lien perdu : les deux noeuds se retrouvent au débit de base
+			if (!peerOnline && lora->getRateIndex() != lora->getBaseRateIndex()) {
+				Serial.println("[RATE] Pair hors ligne, retour au débit de base");
+				lora->setRateIndex(lora->getBaseRateIndex());
+				snapshot = fragment->getLinkStats();
+				goodWindows = 0;
+				break;
+			}
+			if (enabled) {
+				evaluate(now);
+			}
+			break;
+	}
+}
+
+template <class Radio>
+void AdaptiveRateController<Radio>::evaluate(unsigned long now) {
+	const LinkStats& st = fragment->getLinkStats();
+	const uint32_t firstTry = st.ackedFirstTry - snapshot.ackedFirstTry;
+	const uint32_t afterRetry = st.ackedAfterRetry - snapshot.ackedAfterRetry;
+	const uint32_t failures = st.failures - snapshot.failures;
+	const uint32_t samples = firstTry + afterRetry + failures;
+	
+	if (samples < EVAL_MIN_SAMPLES) return;
+	snapshot = st;
+	
+	const uint32_t firstTryPct = firstTry * 100 / samples;
+	const uint8_t current = lora->getRateIndex();
+	
+	if (failures > 0 || firstTryPct < DOWNGRADE_MAX_FIRST_TRY_PCT) {
+		goodWindows = 0;
+		lastDowngradeMs = now;
+		if (current > 0) {
+			requestRate(current - 1);
+		}
+	} else if (firstTryPct >= UPGRADE_MIN_FIRST_TRY_PCT) {
+		goodWindows++;
+		if (goodWindows >= UPGRADE_GOOD_WINDOWS && current + 1 < lora->getRateCount() &&
+		    now - lastDowngradeMs >= HOLD_AFTER_DOWNGRADE_MS) {
+			goodWindows = 0;
+			requestRate(current + 1);
+		}
+	} else {
+		goodWindows = 0;
+	}
+}
+
+template <class Radio>
+bool AdaptiveRateController<Radio>::handleRateControl(const ByteView& packet, const uint8_t* sessionKey,
+                                                      uint32_t deviceId) {
+	if (packet.size() < 1 + 1 + 4 + 4 + 1 + 16) {
+		return false;
+	}
+	
+	const size_t macOffset = packet.size() - 16;
+	uint8_t macCalc[16];
+	security->hmacSha256Trunc16(sessionKey, 16, packet.data(), macOffset, macCalc);
+	if (memcmp(&packet[macOffset], macCalc, 16) != 0) {
+		Serial.println("[RATE] MAC invalide, contrôle rejeté");
+		return false;
+	}
+	
+	const uint8_t op = packet[1];
+	const uint32_t senderId = ((uint32_t)packet[2] << 24) | ((uint32_t)packet[3] << 16) |
+	                          ((uint32_t)packet[4] << 8) | packet[5];
+	const uint32_t seq = ((uint32_t)packet[6] << 24) | ((uint32_t)packet[7] << 16) |
+	                     ((uint32_t)packet[8] << 8) | packet[9];
+	const uint8_t index = packet[10];
+	
+	if (senderId == deviceId || index >= lora->getRateCount()) {
+		return false;
+	}
+	
+	this->deviceId = deviceId;
+	this->sessionKey = sessionKey;
+	
+	switch (op) {
+		case OP_REQ:
+			// Demandes croisées : l'ID le plus grand garde l'initiative
+			if (state == RATE_WAIT_ACK && deviceId > senderId) {
+				return true;
+			}
+			if (state == RATE_PROBING || state == RATE_PROBATION) {
+				return false;
+			}
+			// Anti-rejeu : un REQ capturé et réémis forcerait à nouveau la bascule
+			if (senderId == lastReqSender && (int32_t)(seq - lastReqSeq) <= 0) {
+				Serial.println("[RATE] REQ rejoué ou périmé, rejeté");
+				sendControl(OP_REQ_STALE, lastReqSeq, lora->getRateIndex());
+				return false;
+			}
+			lastReqSender = senderId;
+			lastReqSeq = seq;
+			nvs->saveRateReqGuard(senderId, seq);
+			// L'ACK part à l'ancien débit : setRateIndex() vide la file avant de basculer
+			sendControl(OP_ACK, seq, index);
+			previousIndex = lora->getRateIndex();
+			pendingSeq = seq;
+			targetIndex = index;
+			if (lora->setRateIndex(index)) {
+				enterState(RATE_PROBATION);
+			} else {
+				// L'initiateur reviendra de lui-même faute de réponse aux sondes
+				enterState(RATE_IDLE);
+			}
+			return true;
+			
+		case OP_ACK:
+			if (state != RATE_WAIT_ACK || seq != pendingSeq) {
+				return false;
+			}
+			previousIndex = lora->getRateIndex();
+			if (lora->setRateIndex(targetIndex)) {
+				// Première sonde après PROBE_INTERVAL_MS : le pair a le temps de basculer
+				attempts = 0;
+				enterState(RATE_PROBING);
+			} else {
+				enterState(RATE_IDLE);
+			}
+			return true;
+			
+		case OP_PROBE:
+			if (index != lora->getRateIndex()) {
+				return false;
+			}
+			sendControl(OP_PROBE_ACK, seq, index);
+			if (state == RATE_PROBATION && seq == pendingSeq) {
+				commit();
+			}
+			return true;
+			
+		case OP_PROBE_ACK:
+			if (state != RATE_PROBING || seq != pendingSeq) {
+				return false;
+			}
+			commit();
+			return true;
+			
+		case OP_REQ_STALE:
+			// Compteur en retard sur ce que le pair a déjà vu (redémarrage) : repartir au-delà
+			if ((int32_t)(seq - ctrlSeq) > 0) {
+				ctrlSeq = seq;
+			}
+			if (state == RATE_WAIT_ACK && (int32_t)(seq - pendingSeq) >= 0) {
+				pendingSeq = ++ctrlSeq;
+				stateSinceMs = millis();
+				sendControl(OP_REQ, pendingSeq, targetIndex);
+			}
+			return true;
+			
+		default:
+			return false;
+	}
+}
+
+template <class Radio>
+void AdaptiveRateController<Radio>::printStatus() const {
+	const LinkStats& st = fragment->getLinkStats();
+	Serial.print("[RATE] Débit ");
+	Serial.print(lora->bandName());
+	Serial.print(": ");
+	Serial.print(lora->getRateName(lora->getRateIndex()));
+	Serial.print(" (base ");
+	Serial.print(lora->getRateName(lora->getBaseRateIndex()));
+	Serial.print(", auto ");
+	Serial.print(enabled ? "ON" : "OFF");
+	Serial.println(")");
+	Serial.print("[RATE] Fragments: ");
+	Serial.print(st.fragmentsSent);
+	Serial.print(" envoyés, ");
+	Serial.print(st.ackedFirstTry);
+	Serial.print(" ACK direct, ");
+	Serial.print(st.ackedAfterRetry);
+	Serial.print(" ACK après retry, ");
+	Serial.print(st.retransmissions);
+	Serial.print(" retransmissions, ");
+	Serial.print(st.failures);
+	Serial.println(" échecs");
+}
+
+// Instanciations explicites : une par driver radio
+#ifdef RADIO_SIM
+template class AdaptiveRateController<SimRadio>;
+#else
+template class AdaptiveRateController<LoRaModule>;
+template class AdaptiveRateController<XL1278Module>;
+#endif
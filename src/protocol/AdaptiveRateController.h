@@ -0,0 +1,110 @@
+#ifndef ADAPTIVE_RATE_CONTROLLER_H
+#define ADAPTIVE_RATE_CONTROLLER_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "../Config.h"
+#include "../protocol/PacketTypes.h"
+#include "../protocol/FragmentManager.h"
+#include "../security/SecurityManager.h"
+#include "../storage/NVSManager.h"
+#include "../lora/RadioDriver.h"
+
+/**
+ * Adaptation du débit air à partir des statistiques d'ACK de FragmentManager
+ *
+ * Évaluation par fenêtre d'au moins EVAL_MIN_SAMPLES fragments conclus (ACK ou abandon) :
+ *  - montée d'un cran après UPGRADE_GOOD_WINDOWS fenêtres sans perte et
+ *    au moins UPGRADE_MIN_FIRST_TRY_PCT % d'ACK du premier coup
+ *  - descente d'un cran dès qu'une fenêtre contient une perte ou moins de
+ *    DOWNGRADE_MAX_FIRST_TRY_PCT % d'ACK du premier coup
+ *
+ * Le changement est négocié avec le pair (PKT_RATE_CTRL, HMAC avec la clé de session) :
+ *   REQ puis ACK à l'ancien débit, les deux noeuds basculent,
+ *   PROBE puis PROBE_ACK au nouveau débit ; sans réponse, chacun revient au débit précédent.
+ * Pair muet pendant HEARTBEAT_TIMEOUT_MS : retour au débit de base (rendez-vous commun).
+ * Un REQ dont la séquence n'est pas plus récente que le dernier accepté du même pair
+ * (trame rejouée) est refusé ; la réponse REQ_STALE porte cette séquence, et
+ * l'initiateur légitime (redémarré, compteur reparti de zéro) repart au-delà.
+ * Ce dernier REQ est conservé en NVS comme la clé de session, qui survit au
+ * redémarrage : un REQ capturé reste refusé après un reboot du répondeur.
+ */
+template <class Radio>
+class AdaptiveRateController {
+public:
+	static const uint8_t EVAL_MIN_SAMPLES = 8;
+	static const uint8_t UPGRADE_GOOD_WINDOWS = 2;
+	static const uint8_t UPGRADE_MIN_FIRST_TRY_PCT = 90;
+	static const uint8_t DOWNGRADE_MAX_FIRST_TRY_PCT = 60;
+	static const unsigned long HOLD_AFTER_DOWNGRADE_MS = 60000;
+	static const unsigned long HANDSHAKE_TIMEOUT_MS = 3000;
+	static const unsigned long PROBE_INTERVAL_MS = 1500;
+	static const uint8_t MAX_ATTEMPTS = 3;
+	// Le répondeur attend plus longtemps que la fenêtre de sondes de l'initiateur
+	static const unsigned long PROBATION_MS = (MAX_ATTEMPTS + 2) * PROBE_INTERVAL_MS;
+	
+	AdaptiveRateController(SecurityManager* security, Radio* lora, FragmentManager<Radio>* fragment,
+	                       NVSManager* nvs);
+	
+	// Adaptation automatique (la négociation reste active pour répondre au pair)
+	void setEnabled(bool on) { enabled = on; }
+	bool isEnabled() const { return enabled; }
+	
+	// À appeler à chaque tour de loop()
+	void process(uint32_t deviceId, const uint8_t* sessionKey, bool isPaired, bool peerOnline);
+	
+	// Demande explicite d'un débit (négociée avec le pair)
+	bool requestRate(uint8_t index);
+	
+	// Réception d'un paquet PKT_RATE_CTRL
+	bool handleRateControl(const ByteView& packet, const uint8_t* sessionKey, uint32_t deviceId);
+	
+	void printStatus() const;
+	
+private:
+	enum State : uint8_t {
+		RATE_IDLE,
+		RATE_WAIT_ACK,   // initiateur : REQ envoyé, attente de l'ACK
+		RATE_PROBING,    // initiateur : basculé, sondes au nouveau débit
+		RATE_PROBATION   // répondeur : basculé, attente d'une sonde
+	};
+	
+	enum Op : uint8_t {
+		OP_REQ = 1,
+		OP_ACK = 2,
+		OP_PROBE = 3,
+		OP_PROBE_ACK = 4,
+		OP_REQ_STALE = 5   // REQ refusé : seq = dernier REQ accepté de l'émetteur
+	};
+	
+	SecurityManager* security;
+	Radio* lora;
+	FragmentManager<Radio>* fragment;
+	NVSManager* nvs;
+	
+	bool enabled;
+	State state;
+	uint8_t targetIndex;
+	uint8_t previousIndex;
+	uint8_t attempts;
+	uint8_t goodWindows;
+	uint32_t ctrlSeq;
+	uint32_t pendingSeq;
+	uint32_t lastReqSender;   // pair dont vient le dernier REQ accepté (0 : aucun)
+	uint32_t lastReqSeq;
+	unsigned long stateSinceMs;
+	unsigned long lastDowngradeMs;
+	LinkStats snapshot;
+	
+	// Contexte du dernier process() (pour les envois hors loop)
+	uint32_t deviceId;
+	const uint8_t* sessionKey;
+	
+	void evaluate(unsigned long now);
+	void sendControl(uint8_t op, uint32_t seq, uint8_t index);
+	void revert(const char* reason);
+	void commit();
+	void enterState(State s);
+};
+
+#endif // ADAPTIVE_RATE_CONTROLLER_H
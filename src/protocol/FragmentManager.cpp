@@ -1,13 +1,57 @@
 #include "../protocol/FragmentManager.h"
+#ifdef RADIO_SIM
+#include "../sim/SimRadio.h"
+#else
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#endif
+#include "../utils/ErasureCode.h"
+#include "../utils/Log.h"
 #include <cstring>
 
-FragmentManager::FragmentManager(SecurityManager* security, LoRaModule* lora)
-	: security(security), lora(lora) {
+static_assert(MAX_MESSAGE_FRAGMENTS <= ErasureCode::MAX_SYMBOLS, "MAX_MESSAGE_FRAGMENTS > symboles FEC");
+
+template <class Radio> constexpr float FragmentManager<Radio>::LOSS_EWMA_ALPHA;
+template <class Radio> constexpr float FragmentManager<Radio>::FEC_MIN_LOSS;
+template <class Radio> constexpr float FragmentManager<Radio>::FEC_MAX_LOSS;
+
+template <class Radio>
+FragmentManager<Radio>::FragmentManager(SecurityManager* security, Radio* lora)
+	: security(security), lora(lora), rxSessionKey(nullptr),
+	  fecEnabled(false), lossEwma(0.0f),
+	  windowSize(DEFAULT_WINDOW_SIZE), nextFragmentMs(0), sendOrderCounter(0) {
+	memset(&linkStats, 0, sizeof(linkStats));
+}
+
+template <class Radio>
+void FragmentManager<Radio>::setWindowSize(uint8_t size) {
+	if (size < 1) size = 1;
+	if (size > MAX_WINDOW_SIZE) size = MAX_WINDOW_SIZE;
+	windowSize = size;
+}
+
+template <class Radio>
+void FragmentManager<Radio>::recordFragmentOutcome(bool lost) {
+	lossEwma += LOSS_EWMA_ALPHA * ((lost ? 1.0f : 0.0f) - lossEwma);
+}
+
+template <class Radio>
+uint16_t FragmentManager<Radio>::fecParityFor(uint16_t dataFrags) const {
+	if (lossEwma < FEC_MIN_LOSS) return 0;
+	const float p = (lossEwma > FEC_MAX_LOSS) ? FEC_MAX_LOSS : lossEwma;
+	// Reçus attendus (k + m)(1 - p) >= k
+	uint16_t parity = (uint16_t)ceilf((float)dataFrags * p / (1.0f - p));
+	if (parity > dataFrags) parity = dataFrags;
+	if (dataFrags + parity > MAX_MESSAGE_FRAGMENTS) {
+		parity = (dataFrags < MAX_MESSAGE_FRAGMENTS) ? MAX_MESSAGE_FRAGMENTS - dataFrags : 0;
+	}
+	return parity;
 }
 
-void FragmentManager::sendAck(uint32_t seq, uint16_t fragId, const uint8_t* sessionKey) {
+template <class Radio>
+void FragmentManager<Radio>::sendAck(uint32_t seq, uint16_t fragId, const uint8_t* sessionKey) {
 	std::vector<uint8_t> pkt;
-	pkt.reserve(1 + 4 + 2 + 16);
+	pkt.reserve(ACK_PACKET_SIZE);
 	pkt.push_back((uint8_t)PKT_ACK);
 	pkt.push_back((seq >> 24) & 0xFF);
 	pkt.push_back((seq >> 16) & 0xFF);
@@ -20,69 +64,252 @@ void FragmentManager::sendAck(uint32_t seq, uint16_t fragId, const uint8_t* sess
 	security->hmacSha256Trunc16(sessionKey, 16, pkt.data(), pkt.size(), mac16);
 	pkt.insert(pkt.end(), mac16, mac16 + 16);
 	
-	Serial.print("[ACK] Envoi ACK pour seq=");
-	Serial.print(seq);
-	Serial.print(" frag=");
-	Serial.println(fragId);
+	LOG_DEBUG(LOG_CAT_FRAG, "[ACK] Envoi ACK pour seq=%u frag=%u", seq, fragId);
 	
-	lora->sendPacket(pkt);
+	lora->sendPacket(pkt, TX_PRIO_HIGH, lora->getPeerAddress());
+	linkStats.acksSent++;
 }
 
-void FragmentManager::sendSecureMessageFragment(const uint8_t* cipherData, size_t cipherLen,
-                                                uint32_t seq, uint16_t fragId, uint16_t totalFrags,
-                                                const uint8_t iv[16], const uint8_t* sessionKey) {
-	const bool includeIv = (fragId == 0);
-	std::vector<uint8_t> pkt;
-	pkt.reserve(1 + 4 + 2 + 2 + (includeIv ? 16 : 0) + cipherLen + 16);
-	pkt.push_back((uint8_t)PKT_DATA);
-	pkt.push_back((seq >> 24) & 0xFF);
-	pkt.push_back((seq >> 16) & 0xFF);
-	pkt.push_back((seq >> 8) & 0xFF);
-	pkt.push_back(seq & 0xFF);
-	pkt.push_back((fragId >> 8) & 0xFF);
-	pkt.push_back(fragId & 0xFF);
-	pkt.push_back((totalFrags >> 8) & 0xFF);
-	pkt.push_back(totalFrags & 0xFF);
-	
-	if (includeIv) {
-		pkt.insert(pkt.end(), iv, iv + 16);
+template <class Radio>
+void FragmentManager<Radio>::sendSack(FragmentBuffer& fb, const uint8_t* sessionKey) {
+	uint16_t cumulative = 0;
+	while (cumulative < fb.totalFrags && fb.lens[cumulative] != 0) {
+		cumulative++;
+	}
+	uint8_t bitmap[SACK_BITMAP_BYTES];
+	memset(bitmap, 0, sizeof(bitmap));
+	for (uint16_t i = 0; i < SACK_BITMAP_BITS && cumulative + i < fb.totalFrags; ++i) {
+		if (fb.lens[cumulative + i] != 0) {
+			bitmap[i >> 3] |= (uint8_t)(1 << (i & 7));
+		}
 	}
-	pkt.insert(pkt.end(), cipherData, cipherData + cipherLen);
+	
+	std::vector<uint8_t> pkt;
+	pkt.reserve(SACK_PACKET_SIZE);
+	pkt.push_back((uint8_t)PKT_SACK);
+	pkt.push_back((fb.seq >> 24) & 0xFF);
+	pkt.push_back((fb.seq >> 16) & 0xFF);
+	pkt.push_back((fb.seq >> 8) & 0xFF);
+	pkt.push_back(fb.seq & 0xFF);
+	pkt.push_back((cumulative >> 8) & 0xFF);
+	pkt.push_back(cumulative & 0xFF);
+	pkt.push_back(fb.complete ? SACK_FLAG_COMPLETE : 0);
+	pkt.insert(pkt.end(), bitmap, bitmap + SACK_BITMAP_BYTES);
 	
 	uint8_t mac16[16];
 	security->hmacSha256Trunc16(sessionKey, 16, pkt.data(), pkt.size(), mac16);
 	pkt.insert(pkt.end(), mac16, mac16 + 16);
 	
-	lora->sendPacket(pkt);
+	LOG_DEBUG(LOG_CAT_FRAG, "[ACK] Envoi SACK pour seq=%u (%u fragments contigus%s)", fb.seq, cumulative,
+	          fb.complete ? ", complet" : "");
 	
-	PendingPacket pp;
+	fb.sinceSack = 0;
+	fb.sackPending = false;
+	lora->sendPacket(pkt, TX_PRIO_HIGH, lora->getPeerAddress());
+	linkStats.acksSent++;
+}
+
+template <class Radio>
+void FragmentManager<Radio>::acknowledgeFragment(FragmentBuffer& fb, size_t frameLen, const uint8_t* sessionKey) {
+	// Message complet ou fenêtre de l'émetteur pleine : il attend, répondre tout de suite
+	if (fb.complete || fb.sinceSack >= windowSize) {
+		sendSack(fb, sessionKey);
+		return;
+	}
+	// Sinon au silence qui suit le dernier fragment : le suivant arrive après son temps d'antenne
+	fb.sackDueMs = millis() + lora->timeOnAirUs(frameLen) / 1000 + 2 * INTER_FRAGMENT_GAP_MS + SACK_DELAY_MS;
+	fb.sackPending = true;
+}
+
+template <class Radio>
+void FragmentManager<Radio>::flushDueSacks(unsigned long now) {
+	if (!rxSessionKey) return;
+	for (FragmentBuffer* fb = fragmentBuffers.oldest(); fb; fb = fragmentBuffers.next(fb)) {
+		if (fb->sackPending && (long)(now - fb->sackDueMs) >= 0) {
+			sendSack(*fb, rxSessionKey);
+		}
+	}
+}
+
+template <class Radio>
+unsigned long FragmentManager<Radio>::ackWindowMs(size_t frameLen, unsigned long floorMs) const {
+	// Aller (toute la fenêtre passe avant le SACK) + retour au débit courant : à
+	// 2.4 kbps un fragment plein occupe déjà plusieurs centaines de ms
+	return floorMs + (windowSize * lora->timeOnAirUs(frameLen) + lora->timeOnAirUs(SACK_PACKET_SIZE)) / 1000;
+}
+
+template <class Radio>
+void FragmentManager<Radio>::queueDataFragment(const uint8_t* cipherData, size_t cipherLen,
+                                               uint32_t seq, uint16_t fragId, uint16_t totalFrags,
+                                               const uint8_t iv[16], const uint8_t* sessionKey) {
+	PendingPacket* pp = addPending(seq, fragId, totalFrags, totalFrags);
+	if (!pp) return;
+	
+	// Trame construite directement dans son slot : c'est elle qui sera renvoyée
+	uint8_t* pkt = slotPool.data(pp->slot);
+	size_t len = 0;
+	pkt[len++] = (uint8_t)PKT_DATA;
+	pkt[len++] = (seq >> 24) & 0xFF;
+	pkt[len++] = (seq >> 16) & 0xFF;
+	pkt[len++] = (seq >> 8) & 0xFF;
+	pkt[len++] = seq & 0xFF;
+	pkt[len++] = (fragId >> 8) & 0xFF;
+	pkt[len++] = fragId & 0xFF;
+	pkt[len++] = (totalFrags >> 8) & 0xFF;
+	pkt[len++] = totalFrags & 0xFF;
+	
+	if (fragId == 0) {
+		memcpy(pkt + len, iv, 16);
+		len += 16;
+	}
+	memcpy(pkt + len, cipherData, cipherLen);
+	len += cipherLen;
+	
+	security->hmacSha256Trunc16(sessionKey, 16, pkt, len, pkt + len);
+	pp->len = (uint8_t)(len + 16);
+}
+
+template <class Radio>
+void FragmentManager<Radio>::queueFecFragment(const uint8_t* symbol, size_t symLen, uint32_t seq,
+                                              uint16_t fragId, uint16_t totalFrags, uint16_t dataFrags,
+                                              const uint8_t* sessionKey) {
+	PendingPacket* pp = addPending(seq, fragId, totalFrags, dataFrags);
+	if (!pp) return;
+	
+	uint8_t* pkt = slotPool.data(pp->slot);
+	size_t len = 0;
+	pkt[len++] = (uint8_t)PKT_DATA_FEC;
+	pkt[len++] = (seq >> 24) & 0xFF;
+	pkt[len++] = (seq >> 16) & 0xFF;
+	pkt[len++] = (seq >> 8) & 0xFF;
+	pkt[len++] = seq & 0xFF;
+	pkt[len++] = (fragId >> 8) & 0xFF;
+	pkt[len++] = fragId & 0xFF;
+	pkt[len++] = (totalFrags >> 8) & 0xFF;
+	pkt[len++] = totalFrags & 0xFF;
+	pkt[len++] = (dataFrags >> 8) & 0xFF;
+	pkt[len++] = dataFrags & 0xFF;
+	memcpy(pkt + len, symbol, symLen);
+	len += symLen;
+	
+	security->hmacSha256Trunc16(sessionKey, 16, pkt, len, pkt + len);
+	pp->len = (uint8_t)(len + 16);
+}
+
+template <class Radio>
+PendingPacket* FragmentManager<Radio>::addPending(uint32_t seq, uint16_t fragId, uint16_t totalFrags,
+                                                  uint16_t dataFrags) {
+	const PeerSeqKey key = keyOf(seq);
+	PendingMessage* pm = pendingMessages.find(key);
+	if (!pm) {
+		// Place vérifiée par sendSecureMessage avant le découpage
+		pm = pendingMessages.insert(key);
+		if (!pm) return nullptr;
+		pm->seq = seq;
+		pm->totalFrags = totalFrags;
+		pm->dataFrags = dataFrags;
+		pm->packetCount = 0;
+		pm->firstSentMs = millis();
+	}
+	
+	const uint16_t slot = slotPool.alloc();
+	if (slot == POOL_SLOT_NONE || pm->packetCount >= MAX_MESSAGE_FRAGMENTS) {
+		slotPool.release(slot);
+		return nullptr;
+	}
+	
+	PendingPacket& pp = pm->packets[pm->packetCount++];
 	pp.seq = seq;
 	pp.fragId = fragId;
-	pp.packetData = pkt;
-	pp.lastSentMs = millis();
+	pp.slot = slot;
+	pp.len = 0;
+	pp.lastSentMs = 0;
+	pp.sendOrder = 0;
 	pp.retryCount = 0;
+	pp.sent = false;
 	pp.acked = false;
+	pp.missing = false;
+	return &pp;
+}
+
+template <class Radio>
+void FragmentManager<Radio>::releasePending(PendingMessage& pm) {
+	for (uint16_t j = 0; j < pm.packetCount; ++j) {
+		slotPool.release(pm.packets[j].slot);
+	}
+	pendingMessages.erase(&pm);
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::isInFlight(const PendingPacket& pp, unsigned long now) const {
+	return pp.sent && !pp.acked && !pp.missing &&
+	       now - pp.lastSentMs < ackWindowMs(pp.len, ACK_TIMEOUT_MS);
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::canSendFragment(uint16_t inFlight, unsigned long now) const {
+	return inFlight < windowSize && (long)(now - nextFragmentMs) >= 0;
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::transmitFragment(PendingPacket& pp, const PendingMessage& pm, uint16_t inFlight,
+                                              unsigned long now) {
+	if (!lora->sendPacket(slotPool.data(pp.slot), pp.len, TX_PRIO_NORMAL, lora->getPeerAddress())) return false;
 	
-	PendingMessage* pm = nullptr;
-	for (auto &p : pendingMessages) {
-		if (p.seq == seq) {
-			pm = &p;
-			break;
-		}
+	// Le pair répond après un renvoi, le k-ième fragment (message complet) ou une fenêtre pleine
+	const bool ackExpected = pp.sent || pp.fragId + 1 >= pm.dataFrags || inFlight + 1 >= windowSize;
+	if (!pp.sent) {
+		pp.sent = true;
+		linkStats.fragmentsSent++;
+		if (pp.fragId >= pm.dataFrags) linkStats.fecParitySent++;
+		LOG_DEBUG(LOG_CAT_FRAG, "[SEC] Fragment %u/%u envoyé (seq=%u)", pp.fragId + 1, pm.totalFrags, pp.seq);
+	} else {
+		pp.retryCount++;
+		pp.missing = false;
+		linkStats.retransmissions++;
+		recordFragmentOutcome(true);
+		LOG_INFO(LOG_CAT_FRAG, "[RETRY] seq=%u frag=%u tentative %u/%u",
+		         pp.seq, pp.fragId, pp.retryCount, (unsigned)MAX_RETRIES);
 	}
+	pp.lastSentMs = now;
+	pp.sendOrder = ++sendOrderCounter;
 	
-	if (!pm) {
-		PendingMessage newPm;
-		newPm.seq = seq;
-		newPm.totalFrags = totalFrags;
-		newPm.firstSentMs = millis();
-		pendingMessages.push_back(newPm);
-		pm = &pendingMessages.back();
-	}
-	pm->packets.push_back(pp);
+	// Fragment suivant après celui-ci, et après le SACK du pair s'il doit répondre :
+	// le canal reste semi-duplex
+	unsigned long airUs = lora->timeOnAirUs(pp.len);
+	if (ackExpected) airUs += lora->timeOnAirUs(SACK_PACKET_SIZE);
+	nextFragmentMs = now + airUs / 1000 + INTER_FRAGMENT_GAP_MS;
+	return true;
 }
 
-bool FragmentManager::sendSecureMessage(const String& text, const uint8_t* sessionKey, uint32_t& seqNumber) {
+template <class Radio>
+void FragmentManager<Radio>::queueFecMessage(const uint8_t* cipher, size_t cipherLen, const uint8_t iv[16],
+                                             uint32_t seq, uint16_t dataFrags, uint16_t parityFrags,
+                                             const uint8_t* sessionKey) {
+	// Bloc codé = IV + chiffré, complété par des zéros jusqu'à k symboles égaux :
+	// l'IV est protégé comme le reste (fragment 0 perdu = reconstruit)
+	const size_t symLen = (16 + cipherLen + dataFrags - 1) / dataFrags;
+	std::vector<uint8_t> block((size_t)dataFrags * symLen, 0);
+	memcpy(block.data(), iv, 16);
+	memcpy(block.data() + 16, cipher, cipherLen);
+	
+	const uint16_t totalFrags = dataFrags + parityFrags;
+	LOG_INFO(LOG_CAT_FRAG, "[SEC] Fragmentation FEC: %u + %u fragments de parité (perte estimée %.1f %%)",
+	         dataFrags, parityFrags, lossEwma * 100.0f);
+	
+	std::vector<uint8_t> parity(symLen);
+	for (uint16_t fragId = 0; fragId < totalFrags; ++fragId) {
+		const uint8_t* symbol = block.data() + (size_t)fragId * symLen;
+		if (fragId >= dataFrags) {
+			ErasureCode::encodeParity(block.data(), dataFrags, symLen, fragId - dataFrags, parity.data());
+			symbol = parity.data();
+		}
+		queueFecFragment(symbol, symLen, seq, fragId, totalFrags, dataFrags, sessionKey);
+	}
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::sendSecureMessage(const String& text, const uint8_t* sessionKey, uint32_t& seqNumber) {
 	std::vector<uint8_t> plain;
 	plain.reserve(2 + text.length());
 	uint16_t tlen = (uint16_t)text.length();
@@ -98,57 +325,57 @@ bool FragmentManager::sendSecureMessage(const String& text, const uint8_t* sessi
 	std::vector<uint8_t> cipher(plain.size());
 	security->aesCtrCrypt(sessionKey, iv, plain.data(), cipher.data(), cipher.size());
 	
-	uint32_t s = seqNumber++;
-	
 	size_t cipherLen = cipher.size();
 	uint16_t totalFrags = (cipherLen + MAX_FRAGMENT_PAYLOAD - 1) / MAX_FRAGMENT_PAYLOAD;
+	// En FEC, l'IV fait partie du bloc codé
+	const uint16_t fecDataFrags = (16 + cipherLen + MAX_FRAGMENT_PAYLOAD - 1) / MAX_FRAGMENT_PAYLOAD;
+	const uint16_t fecParityFrags = (fecEnabled && totalFrags > 1) ? fecParityFor(fecDataFrags) : 0;
+	const uint16_t framesNeeded = (fecParityFrags > 0) ? fecDataFrags + fecParityFrags : totalFrags;
+	
+	// Toutes les trames du message dans le pool dès maintenant, ou aucune
+	if (framesNeeded > MAX_MESSAGE_FRAGMENTS) {
+		LOG_WARN(LOG_CAT_FRAG, "[SEC] Message trop long: %u fragments (max %u)", framesNeeded,
+		         (unsigned)MAX_MESSAGE_FRAGMENTS);
+		return false;
+	}
+	if (pendingMessages.full()) {
+		LOG_WARN(LOG_CAT_FRAG, "[SEC] Trop de messages en attente d'ACK (%u), message refusé",
+		         (unsigned)MAX_PENDING_MESSAGES);
+		return false;
+	}
+	if (!slotPool.reserveCheck(framesNeeded)) {
+		LOG_WARN(LOG_CAT_FRAG, "[SEC] Pool de fragments plein (%u slots libres, %u nécessaires), message refusé",
+		         slotPool.getFreeCount(), framesNeeded);
+		return false;
+	}
+	
+	uint32_t s = seqNumber++;
 	
 	if (totalFrags == 1) {
-		sendSecureMessageFragment(cipher.data(), cipherLen, s, 0, 1, iv, sessionKey);
-		Serial.print("[SEC] Envoi chiffré: ");
-		Serial.println(text);
-		if (waitForAck(s, 0, ACK_FAST_WINDOW_MS)) {
-			Serial.println("[SEC] ACK rapide reçu");
-		} else {
-			Serial.println("[SEC] ACK différé (gestion asynchrone)");
-		}
+		queueDataFragment(cipher.data(), cipherLen, s, 0, 1, iv, sessionKey);
+		LOG_INFO(LOG_CAT_FRAG, "[SEC] Envoi chiffré: %t", LogData(text.c_str(), text.length()));
+	} else if (fecParityFrags > 0) {
+		queueFecMessage(cipher.data(), cipherLen, iv, s, fecDataFrags, fecParityFrags, sessionKey);
 	} else {
-		Serial.print("[SEC] Fragmentation: ");
-		Serial.print(totalFrags);
-		Serial.print(" fragments pour ");
-		Serial.print(text.length());
-		Serial.println(" caractères");
+		LOG_INFO(LOG_CAT_FRAG, "[SEC] Fragmentation: %u fragments pour %u caractères", totalFrags, text.length());
 		
 		for (uint16_t fragId = 0; fragId < totalFrags; ++fragId) {
 			size_t offset = fragId * MAX_FRAGMENT_PAYLOAD;
 			size_t fragLen = (offset + MAX_FRAGMENT_PAYLOAD <= cipherLen) ? 
 			                MAX_FRAGMENT_PAYLOAD : (cipherLen - offset);
-			sendSecureMessageFragment(cipher.data() + offset, fragLen, s, fragId, totalFrags, iv, sessionKey);
-			Serial.print("[SEC] Fragment ");
-			Serial.print(fragId + 1);
-			Serial.print("/");
-			Serial.print(totalFrags);
-			Serial.print(" envoyé");
-			if (waitForAck(s, fragId, ACK_FAST_WINDOW_MS)) {
-				Serial.println(" (ACK)");
-			} else {
-				Serial.println(" (ACK différé)");
-			}
-			unsigned long waitStart = millis();
-			while (millis() - waitStart < INTER_FRAGMENT_GAP_MS) {
-				delay(ACK_POLL_DELAY_MS);
-			}
+			queueDataFragment(cipher.data() + offset, fragLen, s, fragId, totalFrags, iv, sessionKey);
 		}
-		Serial.println("[SEC] Tous les fragments envoyés (ACK asynchrone)");
 	}
 	
+	// Premiers fragments de la fenêtre tout de suite, la suite au fil des ACK
+	processPendingRetries();
 	return true;
 }
 
-bool FragmentManager::handleDataPacket(const std::vector<uint8_t>& packet, const uint8_t* sessionKey) {
+template <class Radio>
+bool FragmentManager<Radio>::handleDataPacket(const ByteView& packet, const uint8_t* sessionKey) {
 	if (packet.size() < 1 + 4 + 2 + 2 + 16) {
-		Serial.print("[SEC] Paquet trop court: ");
-		Serial.println(packet.size());
+		LOG_WARN(LOG_CAT_FRAG, "[SEC] Paquet trop court: %u", packet.size());
 		return false;
 	}
 	
@@ -159,9 +386,10 @@ bool FragmentManager::handleDataPacket(const std::vector<uint8_t>& packet, const
 	security->hmacSha256Trunc16(sessionKey, 16, packet.data(), macOffset, macCalc);
 	
 	if (memcmp(macRx, macCalc, 16) != 0) {
-		Serial.println("[SEC] MAC invalide. Paquet rejeté.");
+		LOG_WARN(LOG_CAT_FRAG, "[SEC] MAC invalide. Paquet rejeté.");
 		return false;
 	}
+	rxSessionKey = sessionKey;
 	
 	uint32_t seq = ((uint32_t)packet[1] << 24) | ((uint32_t)packet[2] << 16) | 
 	               ((uint32_t)packet[3] << 8) | packet[4];
@@ -169,64 +397,64 @@ bool FragmentManager::handleDataPacket(const std::vector<uint8_t>& packet, const
 	uint16_t totalFrags = ((uint16_t)packet[7] << 8) | packet[8];
 	size_t offset = 1 + 4 + 2 + 2;
 	
+	if (packet[0] == PKT_DATA_FEC) {
+		if (macOffset <= FEC_HEADER_SIZE) {
+			LOG_WARN(LOG_CAT_FRAG, "[FEC] Paquet trop court");
+			return false;
+		}
+		const uint16_t dataFrags = ((uint16_t)packet[9] << 8) | packet[10];
+		return handleFecFragment(ByteView(packet.data() + FEC_HEADER_SIZE, macOffset - FEC_HEADER_SIZE),
+		                         seq, fragId, totalFrags, dataFrags, sessionKey);
+	}
+	
 	bool packetHasIv = (fragId == 0);
 	uint8_t ivFromPacket[16];
 	if (packetHasIv) {
 		if (macOffset < offset + 16) {
-			Serial.println("[SEC] Paquet fragment 0 trop court (IV manquant)");
+			LOG_WARN(LOG_CAT_FRAG, "[SEC] Paquet fragment 0 trop court (IV manquant)");
 			return false;
 		}
 		memcpy(ivFromPacket, &packet[offset], 16);
 		offset += 16;
 	}
 	
-	std::vector<uint8_t> cipherFrag(packet.begin() + offset, packet.begin() + macOffset);
-	
-	sendAck(seq, fragId, sessionKey);
+	const uint8_t* cipherFrag = packet.data() + offset;
+	const size_t fragLen = macOffset - offset;
 	
 	if (totalFrags == 1) {
+		sendAck(seq, fragId, sessionKey);
 		if (!packetHasIv) {
-			Serial.println("[SEC] Fragment unique sans IV, ignoré");
+			LOG_WARN(LOG_CAT_FRAG, "[SEC] Fragment unique sans IV, ignoré");
 			return false;
 		}
-		std::vector<uint8_t> plain(cipherFrag.size());
-		security->aesCtrCrypt(sessionKey, ivFromPacket, cipherFrag.data(), plain.data(), plain.size());
+		std::vector<uint8_t> plain(fragLen);
+		security->aesCtrCrypt(sessionKey, ivFromPacket, cipherFrag, plain.data(), plain.size());
 		if (plain.size() < 2) return false;
 		uint16_t tlen = ((uint16_t)plain[0] << 8) | plain[1];
 		if (plain.size() < 2 + tlen) return false;
-		String msg;
-		for (size_t i = 0; i < tlen; ++i) msg += (char)plain[2 + i];
-		Serial.print("[SEC] Reçu: ");
-		Serial.println(msg);
+		LOG_INFO(LOG_CAT_FRAG, "[SEC] Reçu: %t", LogData(plain.data() + 2, tlen));
 		return true;
 	}
 	
-	purgeOldFragments();
-	FragmentBuffer* fb = nullptr;
-	for (auto &f : fragmentBuffers) {
-		if (f.seq == seq && f.totalFrags == totalFrags) {
-			fb = &f;
-			break;
-		}
+	if (fragId >= totalFrags || totalFrags > MAX_MESSAGE_FRAGMENTS ||
+	    fragLen == 0 || fragLen > FRAGMENT_SLOT_SIZE) {
+		LOG_WARN(LOG_CAT_FRAG, "[FRAG] Erreur: fragId %u / totalFrags %u (max %u)", fragId, totalFrags,
+		         (unsigned)MAX_MESSAGE_FRAGMENTS);
+		return false;
 	}
 	
-	if (!fb) {
-		FragmentBuffer newFb;
-		newFb.seq = seq;
-		newFb.totalFrags = totalFrags;
-		memset(newFb.iv, 0, sizeof(newFb.iv));
-		newFb.fragments.resize(totalFrags);
-		newFb.firstSeenMs = millis();
-		newFb.complete = false;
-		newFb.hasIv = false;
-		fragmentBuffers.push_back(newFb);
-		fb = &fragmentBuffers.back();
+	purgeOldFragments();
+	FragmentBuffer* fb = findOrCreateBuffer(seq, totalFrags, 0);
+	if (fb->complete) {
+		// Renvoi après la fin : le SACK final s'est perdu
+		acknowledgeFragment(*fb, packet.size(), sessionKey);
+		return false;
 	}
 	
 	if (packetHasIv) {
 		if (fb->hasIv) {
 			if (memcmp(fb->iv, ivFromPacket, 16) != 0) {
-				Serial.println("[FRAG] Erreur: IV différent détecté, fragment ignoré");
+				LOG_WARN(LOG_CAT_FRAG, "[FRAG] Erreur: IV différent détecté, fragment ignoré");
 				return false;
 			}
 		} else {
@@ -235,66 +463,472 @@ bool FragmentManager::handleDataPacket(const std::vector<uint8_t>& packet, const
 		}
 	}
 	
-	if (fragId >= fb->fragments.size()) {
-		Serial.print("[FRAG] Erreur: fragId ");
-		Serial.print(fragId);
-		Serial.print(" >= totalFrags ");
-		Serial.println(fb->fragments.size());
-		return false;
-	}
-	
-	if (!fb->fragments[fragId].empty()) {
-		if (fb->fragments[fragId].size() == cipherFrag.size() &&
-		    memcmp(fb->fragments[fragId].data(), cipherFrag.data(), cipherFrag.size()) == 0) {
-			Serial.print("[FRAG] Fragment ");
-			Serial.print(fragId + 1);
-			Serial.println("/ déjà reçu, ignoré");
+	if (fb->lens[fragId] != 0) {
+		if (fb->lens[fragId] == fragLen && memcmp(slotPool.data(fb->slots[fragId]), cipherFrag, fragLen) == 0) {
+			LOG_DEBUG(LOG_CAT_FRAG, "[FRAG] Fragment %u/ déjà reçu, ignoré", fragId + 1);
+			// Renvoi : le SACK précédent s'est perdu
+			acknowledgeFragment(*fb, packet.size(), sessionKey);
+			return false;
+		}
+	} else {
+		fb->slots[fragId] = slotPool.alloc();
+		if (fb->slots[fragId] == POOL_SLOT_NONE) {
+			// Pas de SACK : l'émetteur renverra ce fragment plus tard
+			LOG_WARN(LOG_CAT_FRAG, "[FRAG] Pool de fragments plein, fragment %u/%u ignoré", fragId + 1, totalFrags);
 			return false;
 		}
 	}
 	
-	fb->fragments[fragId] = cipherFrag;
-	Serial.print("[FRAG] Reçu fragment ");
-	Serial.print(fragId + 1);
-	Serial.print("/");
-	Serial.print(totalFrags);
-	Serial.print(" (seq=");
-	Serial.print(seq);
-	Serial.println(")");
+	memcpy(slotPool.data(fb->slots[fragId]), cipherFrag, fragLen);
+	fb->lens[fragId] = (uint8_t)fragLen;
+	fb->sinceSack++;
+	LOG_DEBUG(LOG_CAT_FRAG, "[FRAG] Reçu fragment %u/%u (seq=%u)", fragId + 1, totalFrags, seq);
 	
 	bool allReceived = true;
-	for (size_t i = 0; i < fb->fragments.size(); ++i) {
-		if (fb->fragments[i].empty()) {
+	for (uint16_t i = 0; i < fb->totalFrags; ++i) {
+		if (fb->lens[i] == 0) {
 			allReceived = false;
 			break;
 		}
 	}
 	
-	if (allReceived && fb->hasIv && !fb->complete) {
-		fb->complete = true;
-		std::vector<uint8_t> cipherFull;
-		for (const auto &frag : fb->fragments) {
-			cipherFull.insert(cipherFull.end(), frag.begin(), frag.end());
-		}
-		std::vector<uint8_t> plain(cipherFull.size());
-		security->aesCtrCrypt(sessionKey, fb->iv, cipherFull.data(), plain.data(), plain.size());
-		if (plain.size() < 2) {
-			Serial.println("[FRAG] Erreur déchiffrement");
+	if (!allReceived || !fb->hasIv) {
+		acknowledgeFragment(*fb, packet.size(), sessionKey);
+		return false;
+	}
+	
+	fb->complete = true;
+	acknowledgeFragment(*fb, packet.size(), sessionKey);
+	std::vector<uint8_t> cipherFull;
+	for (uint16_t i = 0; i < fb->totalFrags; ++i) {
+		const uint8_t* frag = slotPool.data(fb->slots[i]);
+		cipherFull.insert(cipherFull.end(), frag, frag + fb->lens[i]);
+	}
+	releaseFragments(*fb);
+	return deliverCipher(cipherFull.data(), cipherFull.size(), fb->iv, sessionKey, "fragmenté");
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::handleFecFragment(const ByteView& symbol, uint32_t seq, uint16_t fragId,
+                                               uint16_t totalFrags, uint16_t dataFrags,
+                                               const uint8_t* sessionKey) {
+	if (dataFrags == 0 || dataFrags > totalFrags || totalFrags > MAX_MESSAGE_FRAGMENTS ||
+	    fragId >= totalFrags || symbol.size() > FRAGMENT_SLOT_SIZE) {
+		LOG_WARN(LOG_CAT_FRAG, "[FEC] En-tête invalide, fragment ignoré");
+		return false;
+	}
+	// SACK envoyé une fois l'état du message connu : reconstruit ou non
+	const size_t frameLen = FEC_HEADER_SIZE + symbol.size() + 16;
+	
+	purgeOldFragments();
+	FragmentBuffer* fb = findOrCreateBuffer(seq, totalFrags, dataFrags);
+	
+	// Parité arrivée après la reconstruction : le SACK suffit (il arrête l'émetteur)
+	if (fb->complete || fb->lens[fragId] != 0) {
+		acknowledgeFragment(*fb, frameLen, sessionKey);
+		return false;
+	}
+	
+	uint16_t received = 0;
+	for (uint16_t i = 0; i < fb->totalFrags; ++i) {
+		if (fb->lens[i] == 0) continue;
+		if (fb->lens[i] != symbol.size()) {
+			LOG_WARN(LOG_CAT_FRAG, "[FEC] Taille de symbole incohérente, fragment ignoré");
 			return false;
 		}
-		uint16_t tlen = ((uint16_t)plain[0] << 8) | plain[1];
-		if (plain.size() < 2 + tlen) {
-			Serial.println("[FRAG] Taille invalide");
-			return false;
+		received++;
+	}
+	
+	fb->slots[fragId] = slotPool.alloc();
+	if (fb->slots[fragId] == POOL_SLOT_NONE) {
+		LOG_WARN(LOG_CAT_FRAG, "[FEC] Pool de fragments plein, fragment %u/%u ignoré", fragId + 1, totalFrags);
+		return false;
+	}
+	memcpy(slotPool.data(fb->slots[fragId]), symbol.data(), symbol.size());
+	fb->lens[fragId] = (uint8_t)symbol.size();
+	fb->sinceSack++;
+	received++;
+	LOG_DEBUG(LOG_CAT_FRAG, "[FEC] Reçu fragment %u/%u (%u/%u nécessaires, seq=%u)",
+	          fragId + 1, totalFrags, received, dataFrags, seq);
+	
+	if (received < dataFrags) {
+		acknowledgeFragment(*fb, frameLen, sessionKey);
+		return false;
+	}
+	fb->complete = true;
+	acknowledgeFragment(*fb, frameLen, sessionKey);
+	
+	// Les k premiers symboles présents, données d'abord (moins de calcul)
+	const uint8_t* symbols[MAX_MESSAGE_FRAGMENTS];
+	uint16_t ids[MAX_MESSAGE_FRAGMENTS];
+	uint16_t found = 0;
+	for (uint16_t i = 0; i < totalFrags && found < dataFrags; ++i) {
+		if (fb->lens[i] == 0) continue;
+		symbols[found] = slotPool.data(fb->slots[i]);
+		ids[found++] = i;
+	}
+	
+	const size_t symLen = symbol.size();
+	std::vector<uint8_t> block((size_t)dataFrags * symLen);
+	const bool decoded = block.size() > 16 &&
+	                     ErasureCode::decode(symbols, ids, dataFrags, symLen, block.data());
+	releaseFragments(*fb);
+	if (!decoded) {
+		LOG_WARN(LOG_CAT_FRAG, "[FEC] Echec de reconstruction");
+		return false;
+	}
+	
+	if (ids[dataFrags - 1] >= dataFrags) {
+		linkStats.fecRecovered++;
+		LOG_INFO(LOG_CAT_FRAG, "[FEC] Fragments perdus reconstruits par la parité");
+	}
+	return deliverCipher(block.data() + 16, block.size() - 16, block.data(), sessionKey, "FEC");
+}
+
+template <class Radio>
+FragmentBuffer* FragmentManager<Radio>::findOrCreateBuffer(uint32_t seq, uint16_t totalFrags, uint16_t dataFrags) {
+	const PeerSeqKey key = keyOf(seq);
+	FragmentBuffer* fb = fragmentBuffers.find(key);
+	if (fb) {
+		if (fb->totalFrags == totalFrags && fb->dataFrags == dataFrags) {
+			return fb;
 		}
-		String msg;
-		for (size_t i = 0; i < tlen; ++i) {
-			msg += (char)plain[2 + i];
+		// Même séquence, autre découpage : le pair a repris sa numérotation
+		releaseFragments(*fb);
+		fragmentBuffers.erase(fb);
+	}
+	
+	fb = fragmentBuffers.insert(key);
+	if (!fb) {
+		// Table pleine : le plus ancien transfert, le plus proche de l'expiration, cède sa place
+		FragmentBuffer* oldest = fragmentBuffers.oldest();
+		LOG_WARN(LOG_CAT_FRAG, "[FRAG] Trop de messages en réception, seq=%u abandonné", oldest->seq);
+		releaseFragments(*oldest);
+		fragmentBuffers.erase(oldest);
+		fb = fragmentBuffers.insert(key);
+	}
+	
+	fb->seq = seq;
+	fb->totalFrags = totalFrags;
+	fb->dataFrags = dataFrags;
+	memset(fb->iv, 0, sizeof(fb->iv));
+	for (uint16_t i = 0; i < MAX_MESSAGE_FRAGMENTS; ++i) {
+		fb->slots[i] = POOL_SLOT_NONE;
+		fb->lens[i] = 0;
+	}
+	fb->firstSeenMs = millis();
+	fb->sackDueMs = 0;
+	fb->sinceSack = 0;
+	fb->sackPending = false;
+	fb->complete = false;
+	fb->hasIv = false;
+	return fb;
+}
+
+template <class Radio>
+void FragmentManager<Radio>::releaseFragments(FragmentBuffer& fb) {
+	for (uint16_t i = 0; i < fb.totalFrags; ++i) {
+		slotPool.release(fb.slots[i]);
+		fb.slots[i] = POOL_SLOT_NONE;
+	}
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::deliverCipher(const uint8_t* cipher, size_t cipherLen, const uint8_t iv[16],
+                                           const uint8_t* sessionKey, const char* label) {
+	std::vector<uint8_t> plain(cipherLen);
+	security->aesCtrCrypt(sessionKey, iv, cipher, plain.data(), plain.size());
+	if (plain.size() < 2) {
+		LOG_WARN(LOG_CAT_FRAG, "[FRAG] Erreur déchiffrement");
+		return false;
+	}
+	// Le bourrage éventuel (FEC) suit le texte : seule la longueur en tête compte
+	uint16_t tlen = ((uint16_t)plain[0] << 8) | plain[1];
+	if (plain.size() < 2 + (size_t)tlen) {
+		LOG_WARN(LOG_CAT_FRAG, "[FRAG] Taille invalide");
+		return false;
+	}
+	LOG_INFO(LOG_CAT_FRAG, "[SEC] Reçu (%s): %t", label, LogData(plain.data() + 2, tlen));
+	return true;
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::handleAck(const ByteView& packet, const uint8_t* sessionKey) {
+	if (!packet.empty() && packet[0] == PKT_SACK) {
+		return handleSack(packet, sessionKey);
+	}
+	if (packet.size() < 1 + 4 + 2 + 16) {
+		return false;
+	}
+	
+	const size_t macOffset = packet.size() - 16;
+	uint8_t macCalc[16];
+	security->hmacSha256Trunc16(sessionKey, 16, packet.data(), macOffset, macCalc);
+	
+	if (memcmp(&packet[macOffset], macCalc, 16) != 0) {
+		LOG_WARN(LOG_CAT_FRAG, "[ACK] MAC invalide, ACK rejeté");
+		return false;
+	}
+	
+	uint32_t seq = ((uint32_t)packet[1] << 24) | ((uint32_t)packet[2] << 16) | 
+	               ((uint32_t)packet[3] << 8) | packet[4];
+	uint16_t fragId = ((uint16_t)packet[5] << 8) | packet[6];
+	
+	PendingMessage* pm = pendingMessages.find(keyOf(seq));
+	if (!pm) return false;
+	
+	uint32_t ackedOrder = 0;
+	for (uint16_t j = 0; j < pm->packetCount; ++j) {
+		PendingPacket& pp = pm->packets[j];
+		if (pp.fragId == fragId) {
+			ackedOrder = markAcked(pp);
 		}
-		Serial.print("[SEC] Reçu (fragmenté): ");
-		Serial.println(msg);
-		return true;
+	}
+	finishAck(*pm, ackedOrder, false);
+	return true;
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::handleSack(const ByteView& packet, const uint8_t* sessionKey) {
+	if (packet.size() != SACK_PACKET_SIZE) {
+		return false;
+	}
+	
+	const size_t macOffset = packet.size() - 16;
+	uint8_t macCalc[16];
+	security->hmacSha256Trunc16(sessionKey, 16, packet.data(), macOffset, macCalc);
+	
+	if (memcmp(&packet[macOffset], macCalc, 16) != 0) {
+		LOG_WARN(LOG_CAT_FRAG, "[ACK] MAC invalide, SACK rejeté");
+		return false;
 	}
 	
+	uint32_t seq = ((uint32_t)packet[1] << 24) | ((uint32_t)packet[2] << 16) | 
+	               ((uint32_t)packet[3] << 8) | packet[4];
+	const uint16_t cumulative = ((uint16_t)packet[5] << 8) | packet[6];
+	const bool peerComplete = (packet[7] & SACK_FLAG_COMPLETE) != 0;
+	const uint8_t* bitmap = &packet[8];
+	
+	PendingMessage* pm = pendingMessages.find(keyOf(seq));
+	if (!pm) return false;
+	
+	LOG_DEBUG(LOG_CAT_FRAG, "[ACK] SACK reçu pour seq=%u (%u fragments contigus%s)", seq, cumulative,
+	          peerComplete ? ", complet" : "");
+	uint32_t ackedOrder = 0;
+	for (uint16_t j = 0; j < pm->packetCount; ++j) {
+		PendingPacket& pp = pm->packets[j];
+		const uint16_t bit = pp.fragId - cumulative;
+		const bool received = pp.fragId < cumulative ||
+		                      (bit < SACK_BITMAP_BITS && (bitmap[bit >> 3] & (1 << (bit & 7))));
+		if (received) {
+			const uint32_t order = markAcked(pp);
+			if (order > ackedOrder) ackedOrder = order;
+		}
+	}
+	finishAck(*pm, ackedOrder, peerComplete);
+	return true;
+}
+
+template <class Radio>
+uint32_t FragmentManager<Radio>::markAcked(PendingPacket& pp) {
+	if (!pp.sent || pp.acked) return 0;
+	pp.acked = true;
+	recordFragmentOutcome(false);
+	if (pp.retryCount == 0) {
+		linkStats.ackedFirstTry++;
+	} else {
+		linkStats.ackedAfterRetry++;
+	}
+	return pp.sendOrder;
+}
+
+template <class Radio>
+void FragmentManager<Radio>::finishAck(PendingMessage& pm, uint32_t ackedOrder, bool peerComplete) {
+	uint16_t ackedCount = 0;
+	for (uint16_t j = 0; j < pm.packetCount; ++j) {
+		PendingPacket& pp = pm.packets[j];
+		if (pp.acked) {
+			ackedCount++;
+		} else if (pp.sent && pp.sendOrder < ackedOrder) {
+			// Fragment émis plus tard acquitté : celui-ci est perdu, inutile d'attendre le délai
+			pp.missing = true;
+		}
+	}
+	
+	// Sans FEC, chaque fragment ; en FEC, k fragments quelconques suffisent au pair
+	if (!peerComplete && ackedCount < pm.dataFrags) return;
+	
+	LOG_INFO(LOG_CAT_FRAG, "[ACK] Message seq=%u entièrement acquitté", pm.seq);
+	// Fragments FEC restés sans ACK : perdus à l'aller ou au retour
+	bool paritySkipped = false;
+	for (uint16_t j = 0; j < pm.packetCount; ++j) {
+		const PendingPacket& pp = pm.packets[j];
+		if (!pp.sent) {
+			paritySkipped = true;
+		} else if (!pp.acked) {
+			recordFragmentOutcome(true);
+		}
+	}
+	if (paritySkipped) {
+		LOG_INFO(LOG_CAT_FRAG, "[SEC] Message décodable par le pair, parité restante non envoyée");
+	}
+	releasePending(pm);
+}
+
+template <class Radio>
+void FragmentManager<Radio>::processPendingRetries() {
+	const unsigned long now = millis();
+	flushDueSacks(now);
+	
+	// La fenêtre couvre tous les messages : le canal est partagé
+	uint16_t inFlight = 0;
+	for (const PendingMessage* pm = pendingMessages.oldest(); pm; pm = pendingMessages.next(pm)) {
+		for (uint16_t j = 0; j < pm->packetCount; ++j) {
+			if (isInFlight(pm->packets[j], now)) inFlight++;
+		}
+	}
+	
+	// Plus ancien message d'abord, fragments dans l'ordre : premières émissions
+	// et renvois des fragments manquants se partagent les places libres
+	PendingMessage* nextPm;
+	for (PendingMessage* cur = pendingMessages.oldest(); cur; cur = nextPm) {
+		nextPm = pendingMessages.next(cur);
+		PendingMessage& pm = *cur;
+		bool waiting = false;
+		bool failed = false;
+		bool lastQueued = false;
+		
+		// FEC : ne renvoyer que ce qui manque pour atteindre k fragments acquittés,
+		// les fragments pas encore émis comptant comme à venir
+		int missing = pm.dataFrags;
+		for (uint16_t j = 0; j < pm.packetCount; ++j) {
+			const PendingPacket& pp = pm.packets[j];
+			if (pp.acked || !pp.sent || isInFlight(pp, now)) {
+				missing--;
+			}
+		}
+		
+		for (uint16_t j = 0; j < pm.packetCount; ++j) {
+			PendingPacket& pp = pm.packets[j];
+			if (pp.acked) continue;
+			if (!pp.sent) {
+				waiting = true;
+				if (canSendFragment(inFlight, now) && transmitFragment(pp, pm, inFlight, now)) {
+					inFlight++;
+					lastQueued = true;
+				}
+				continue;
+			}
+			if (isInFlight(pp, now)) {
+				waiting = true;
+				continue;
+			}
+			if (pp.retryCount >= MAX_RETRIES) {
+				failed = true;
+				continue;
+			}
+			if (missing <= 0) {
+				continue;
+			}
+			
+			waiting = true;
+			if (canSendFragment(inFlight, now) && transmitFragment(pp, pm, inFlight, now)) {
+				inFlight++;
+				missing--;
+			}
+		}
+		
+		if (lastQueued && pm.totalFrags > 1 && pm.packets[pm.packetCount - 1].sent) {
+			LOG_INFO(LOG_CAT_FRAG, "[SEC] Tous les fragments envoyés (ACK asynchrone)");
+		}
+		
+		if (waiting) continue;
+		
+		if (failed) {
+			for (uint16_t j = 0; j < pm.packetCount; ++j) {
+				const PendingPacket& pp = pm.packets[j];
+				if (!pp.acked) linkStats.failures++;
+			}
+			LOG_WARN(LOG_CAT_FRAG, "[SEC] Echec envoi seq=%u (pas d'ACK après retransmissions)", pm.seq);
+		}
+		releasePending(pm);
+	}
+}
+
+template <class Radio>
+void FragmentManager<Radio>::purgeOldFragments() {
+	const unsigned long now = millis();
+	
+	// Ordre d'arrivée = ordre d'expiration : s'arrêter au premier message encore valide
+	FragmentBuffer* fb;
+	while ((fb = fragmentBuffers.oldest()) != nullptr && now - fb->firstSeenMs > FRAGMENT_TIMEOUT_MS) {
+		if (!fb->complete) {
+			LOG_WARN(LOG_CAT_FRAG, "[FRAG] Message seq=%u incomplet expiré", fb->seq);
+		}
+		releaseFragments(*fb);
+		fragmentBuffers.erase(fb);
+	}
+}
+
+template <class Radio>
+bool FragmentManager<Radio>::isTransmitting() const {
+	if (lora->getTxQueueDepth() > 0) return true;
+	// Fragments en attente d'une place dans la fenêtre
+	for (const PendingMessage* pm = pendingMessages.oldest(); pm; pm = pendingMessages.next(pm)) {
+		for (uint16_t j = 0; j < pm->packetCount; ++j) {
+			if (!pm->packets[j].sent) return true;
+		}
+	}
 	return false;
 }
+
+template <class Radio>
+void FragmentManager<Radio>::printStatus() const {
+	LogSerialLock lock;
+	Serial.print("[STATUS] FEC: ");
+	Serial.print(fecEnabled ? "ON" : "OFF");
+	Serial.print(", perte estimée ");
+	Serial.print(lossEwma * 100.0f, 1);
+	Serial.print(" %, parité pour 4 fragments: ");
+	Serial.print(fecParityFor(4));
+	Serial.print(", parité émise ");
+	Serial.print(linkStats.fecParitySent);
+	Serial.print(", messages reconstruits ");
+	Serial.print(linkStats.fecRecovered);
+	Serial.print(", fenêtre ");
+	Serial.println(windowSize);
+	
+	Serial.print("[STATUS] Pool fragments: ");
+	Serial.print(slotPool.getInUse());
+	Serial.print("/");
+	Serial.print(slotPool.capacity());
+	Serial.print(" slots, max ");
+	Serial.print(slotPool.getHighWatermark());
+	Serial.print(", épuisé ");
+	Serial.print(slotPool.getExhaustedCount());
+	Serial.println(" fois");
+	
+	Serial.print("[STATUS] Transferts: envoi ");
+	Serial.print(pendingMessages.size());
+	Serial.print("/");
+	Serial.print(pendingMessages.capacity());
+	Serial.print(" (max ");
+	Serial.print(pendingMessages.getHighWatermark());
+	Serial.print("), réception ");
+	Serial.print(fragmentBuffers.size());
+	Serial.print("/");
+	Serial.print(fragmentBuffers.capacity());
+	Serial.print(" (max ");
+	Serial.print(fragmentBuffers.getHighWatermark());
+	Serial.print(", pleine ");
+	Serial.print(fragmentBuffers.getFullCount());
+	Serial.println(" fois)");
+}
+
+// Instanciations explicites : une par driver radio
+#ifdef RADIO_SIM
+template class FragmentManager<SimRadio>;
+#else
+template class FragmentManager<LoRaModule>;
+template class FragmentManager<XL1278Module>;
+#endif
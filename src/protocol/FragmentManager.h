@@ -6,57 +6,107 @@
 #include <cstdint>
 #include "PacketTypes.h"
 #include "SecurityManager.h"
-#include "LoRaModule.h"
+#include "../Config.h"
+#include "../lora/RadioDriver.h"
+#include "../utils/SlotPool.h"
+#include "../utils/FixedHashTable.h"
 
 struct PendingPacket {
 	uint32_t seq;
 	uint16_t fragId;
-	std::vector<uint8_t> packetData;
+	uint16_t slot;            // trame complète (MAC compris) dans le pool de fragments
+	uint8_t len;
 	unsigned long lastSentMs;
+	uint32_t sendOrder;       // rang de la dernière émission, tous messages confondus
 	uint8_t retryCount;
+	bool sent;                // false : en attente d'une place dans la fenêtre
 	bool acked;
+	bool missing;             // un fragment émis après lui est déjà acquitté
 };
 
 struct PendingMessage {
 	uint32_t seq;
 	uint16_t totalFrags;
-	std::vector<PendingPacket> packets;
+	uint16_t dataFrags;       // ACK nécessaires : totalFrags, ou k en FEC
+	uint16_t packetCount;
+	PendingPacket packets[MAX_MESSAGE_FRAGMENTS];
 	unsigned long firstSentMs;
 };
 
 struct FragmentBuffer {
 	uint32_t seq;
 	uint16_t totalFrags;
+	uint16_t dataFrags;       // 0 : fragments bruts (PKT_DATA), sinon k symboles FEC suffisent
 	uint8_t iv[16];
-	std::vector<std::vector<uint8_t>> fragments;
+	uint8_t lens[MAX_MESSAGE_FRAGMENTS];    // 0 : fragment pas encore reçu
+	uint16_t slots[MAX_MESSAGE_FRAGMENTS];  // rendus au pool dès le message terminé
 	unsigned long firstSeenMs;
+	unsigned long sackDueMs;  // SACK différé : envoyé à cette date sans nouveau fragment
+	uint16_t sinceSack;       // fragments nouveaux depuis le dernier SACK
+	bool sackPending;
 	bool complete;
 	bool hasIv;
 };
 
+// Compteurs cumulés d'acquittement (entrée de l'adaptation de débit)
+struct LinkStats {
+	uint32_t fragmentsSent;    // premiers envois
+	uint32_t ackedFirstTry;    // ACK sans retransmission
+	uint32_t ackedAfterRetry;  // ACK après au moins une retransmission
+	uint32_t retransmissions;
+	uint32_t failures;         // fragments abandonnés après MAX_RETRIES
+	uint32_t fecParitySent;    // fragments de parité FEC émis
+	uint32_t fecRecovered;     // messages reçus reconstruits grâce à la parité
+	uint32_t acksSent;         // trames d'acquittement émises (ACK et SACK)
+};
+
+template <class Radio>
 class FragmentManager {
 public:
 	static const size_t MAX_FRAGMENT_PAYLOAD = 156;
+	// Un slot par fragment : trame émise (en attente d'ACK) ou chiffré reçu (en réassemblage)
+	static const size_t FRAGMENT_SLOT_SIZE = RadioDriver<Radio>::MAX_SEND_SIZE;
+	typedef SlotPool<FRAGMENT_SLOT_SIZE, FRAGMENT_POOL_SLOTS> FragmentSlotPool;
+	static_assert(1 + 4 + 2 + 2 + 16 + MAX_FRAGMENT_PAYLOAD + 16 <= FRAGMENT_SLOT_SIZE && FRAGMENT_SLOT_SIZE <= 255,
+	              "Un fragment doit tenir dans un slot (longueur sur 8 bits)");
+	// Transferts en cours indexés par (pair, séquence) : adresses stables, accès en O(1)
+	static const uint16_t LINK_PEER = 0;
+	typedef FixedHashTable<PendingMessage, MAX_PENDING_MESSAGES> PendingTable;
+	typedef FixedHashTable<FragmentBuffer, MAX_REASSEMBLY_BUFFERS> ReassemblyTable;
 	static const unsigned long FRAGMENT_TIMEOUT_MS = 15000;
+	// Planchers : les délais réels ajoutent le temps d'antenne fragment + ACK au débit courant
 	static const unsigned long ACK_TIMEOUT_MS = 2000;
-	static const unsigned long ACK_FAST_WINDOW_MS = 350;
 	static const unsigned long INTER_FRAGMENT_GAP_MS = 40;
-	static const unsigned long ACK_POLL_DELAY_MS = 5;
+	static const size_t ACK_PACKET_SIZE = 1 + 4 + 2 + 16;
 	static const uint8_t MAX_RETRIES = 3;
+	// Répétition sélective : fragments émis et pas encore acquittés, tous messages confondus
+	static const uint8_t DEFAULT_WINDOW_SIZE = 4;
+	static const uint8_t MAX_WINDOW_SIZE = 32;
+	// SACK : [type][seq][cumul][drapeaux][bitmap][MAC], un seul acquittement pour
+	// plusieurs fragments ; cumul = premier fragment manquant, bit i = fragment cumul + i
+	static const size_t SACK_BITMAP_BYTES = 8;
+	static const uint16_t SACK_BITMAP_BITS = SACK_BITMAP_BYTES * 8;
+	static const size_t SACK_PACKET_SIZE = 1 + 4 + 2 + 1 + SACK_BITMAP_BYTES + 16;
+	static const uint8_t SACK_FLAG_COMPLETE = 0x01;   // message reçu (ou reconstruit en FEC)
+	static const unsigned long SACK_DELAY_MS = 50;     // plancher, en plus du temps d'antenne
+	// FEC : parité dimensionnée sur le taux de perte estimé (EWMA par fragment)
+	static const size_t FEC_HEADER_SIZE = 1 + 4 + 2 + 2 + 2;
+	static constexpr float LOSS_EWMA_ALPHA = 0.125f;
+	static constexpr float FEC_MIN_LOSS = 0.02f;   // en dessous : pas de parité
+	static constexpr float FEC_MAX_LOSS = 0.5f;    // au plus k fragments de parité
 	
-	FragmentManager(SecurityManager* security, LoRaModule* lora);
+	FragmentManager(SecurityManager* security, Radio* lora);
 	
-	// Envoi de messages fragmentés
+	// Envoi de messages fragmentés (non bloquant : les fragments partent par processPendingRetries)
 	bool sendSecureMessage(const String& text, const uint8_t* sessionKey, uint32_t& seqNumber);
 	
 	// Réception de fragments
-	bool handleDataPacket(const std::vector<uint8_t>& packet, const uint8_t* sessionKey);
+	bool handleDataPacket(const ByteView& packet, const uint8_t* sessionKey);
 	
-	// Gestion des ACKs
-	bool handleAck(const std::vector<uint8_t>& packet, const uint8_t* sessionKey);
-	bool waitForAck(uint32_t seq, uint16_t fragId, unsigned long timeoutMs = ACK_TIMEOUT_MS);
+	// Gestion des ACKs (PKT_ACK d'un fragment unique ou SACK)
+	bool handleAck(const ByteView& packet, const uint8_t* sessionKey);
 	
-	// Maintenance
+	// Maintenance : SACK différés dus, fenêtre d'émission et renvoi des fragments manquants
 	void processPendingRetries();
 	void purgeOldFragments();
 	
@@ -66,17 +116,71 @@ public:
 	// Vérifier si une transmission est réellement en cours (pas juste en attente d'ACK)
 	bool isTransmitting() const;
 	
+	const LinkStats& getLinkStats() const { return linkStats; }
+	const FragmentSlotPool& getSlotPool() const { return slotPool; }
+	const PendingTable& getPendingTable() const { return pendingMessages; }
+	const ReassemblyTable& getReassemblyTable() const { return fragmentBuffers; }
+	
+	// Code d'effacement sur les messages fragmentés (même réglage sur les deux pairs)
+	void setFecEnabled(bool enabled) { fecEnabled = enabled; }
+	bool isFecEnabled() const { return fecEnabled; }
+	float getLossEstimate() const { return lossEwma; }
+	// Fragments de parité ajoutés à k fragments de données au taux de perte actuel
+	uint16_t fecParityFor(uint16_t dataFrags) const;
+	
+	// Fragments émis sans ACK à la fois (1 : arrêt et attente), borné à MAX_WINDOW_SIZE ;
+	// en réception, un SACK part dès que la fenêtre est pleine (même réglage sur les deux pairs)
+	void setWindowSize(uint8_t size);
+	uint8_t getWindowSize() const { return windowSize; }
+	
+	void printStatus() const;
+
 private:
 	SecurityManager* security;
-	LoRaModule* lora;
+	Radio* lora;
+	const uint8_t* rxSessionKey;     // Clé du dernier fragment reçu (SACK différés)
 	
-	std::vector<PendingMessage> pendingMessages;
-	std::vector<FragmentBuffer> fragmentBuffers;
+	PendingTable pendingMessages;
+	ReassemblyTable fragmentBuffers;    // plus ancien d'abord : l'expiration s'arrête au premier valide
+	FragmentSlotPool slotPool;
+	LinkStats linkStats;
+	bool fecEnabled;
+	float lossEwma;
+	uint8_t windowSize;
+	unsigned long nextFragmentMs;  // pas d'émission avant : place pour l'ACK du pair
+	uint32_t sendOrderCounter;
 	
-	void sendSecureMessageFragment(const uint8_t* cipherData, size_t cipherLen, 
-	                               uint32_t seq, uint16_t fragId, uint16_t totalFrags,
-	                               const uint8_t iv[16], const uint8_t* sessionKey);
+	void queueDataFragment(const uint8_t* cipherData, size_t cipherLen,
+	                       uint32_t seq, uint16_t fragId, uint16_t totalFrags,
+	                       const uint8_t iv[16], const uint8_t* sessionKey);
+	void queueFecFragment(const uint8_t* symbol, size_t symLen, uint32_t seq, uint16_t fragId,
+	                      uint16_t totalFrags, uint16_t dataFrags, const uint8_t* sessionKey);
+	void queueFecMessage(const uint8_t* cipher, size_t cipherLen, const uint8_t iv[16],
+	                     uint32_t seq, uint16_t dataFrags, uint16_t parityFrags, const uint8_t* sessionKey);
+	PendingPacket* addPending(uint32_t seq, uint16_t fragId, uint16_t totalFrags, uint16_t dataFrags);
+	void releasePending(PendingMessage& pm);
+	// Liaison appairée 1:1 et trames sans adresse source : la séquence seule
+	// distingue les transferts. Jamais l'adresse radio du pair, qui change après
+	// le boot (broadcast -> adresse appairée) et rendrait les entrées introuvables
+	static PeerSeqKey keyOf(uint32_t seq) { return PeerSeqKey{ LINK_PEER, seq }; }
+	FragmentBuffer* findOrCreateBuffer(uint32_t seq, uint16_t totalFrags, uint16_t dataFrags);
+	void releaseFragments(FragmentBuffer& fb);
+	bool isInFlight(const PendingPacket& pp, unsigned long now) const;
+	bool canSendFragment(uint16_t inFlight, unsigned long now) const;
+	bool transmitFragment(PendingPacket& pp, const PendingMessage& pm, uint16_t inFlight, unsigned long now);
+	bool handleFecFragment(const ByteView& symbol, uint32_t seq, uint16_t fragId,
+	                       uint16_t totalFrags, uint16_t dataFrags, const uint8_t* sessionKey);
+	bool deliverCipher(const uint8_t* cipher, size_t cipherLen, const uint8_t iv[16],
+	                   const uint8_t* sessionKey, const char* label);
+	void recordFragmentOutcome(bool lost);
+	unsigned long ackWindowMs(size_t frameLen, unsigned long floorMs) const;
 	void sendAck(uint32_t seq, uint16_t fragId, const uint8_t* sessionKey);
+	void sendSack(FragmentBuffer& fb, const uint8_t* sessionKey);
+	void acknowledgeFragment(FragmentBuffer& fb, size_t frameLen, const uint8_t* sessionKey);
+	void flushDueSacks(unsigned long now);
+	bool handleSack(const ByteView& packet, const uint8_t* sessionKey);
+	uint32_t markAcked(PendingPacket& pp);
+	void finishAck(PendingMessage& pm, uint32_t ackedOrder, bool peerComplete);
 };
 
 #endif // FRAGMENT_MANAGER_H
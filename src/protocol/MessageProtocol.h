@@ -2,6 +2,9 @@
 #define MESSAGE_PROTOCOL_H
 
 #include <Arduino.h>
+#include <cstddef>
+#include <cstdio>
+#include "../utils/Log.h"
 
 // ============================================
 // PROTOCOLE DE MESSAGE PERSONNALISÉ
@@ -19,23 +22,29 @@
 // ============================================
 // TYPES DE COMMANDES (1 byte)
 // ============================================
-#define MSG_TYPE_TEMP_DATA      0x01  // Données de température
-#define MSG_TYPE_HUMAN_DETECT   0x02  // Détection humaine (binaire: oui/non)
-#define MSG_TYPE_HUMAN_COUNT    0x03  // Comptage humain (nombre d'humains détectés)
-#define MSG_TYPE_SENSOR_DATA    0x04  // Données complètes capteur (multi-cibles)
-#define MSG_TYPE_TEXT           0x10  // Message texte
-#define MSG_TYPE_STATUS         0x11  // Statut général
-#define MSG_TYPE_PING           0x20  // Ping
-#define MSG_TYPE_PONG           0x21  // Réponse Ping
-#define MSG_TYPE_ACK            0xF0  // Acquittement
-#define MSG_TYPE_ERROR          0xFF  // Erreur
-
-// Réserver 0x05-0x0F pour futures sondes
-#define MSG_TYPE_HUMIDITY       0x05  // Humidité (futur)
-#define MSG_TYPE_PRESSURE       0x06  // Pression (futur)
-#define MSG_TYPE_LIGHT          0x07  // Luminosité (futur)
-#define MSG_TYPE_MOTION         0x08  // Mouvement (futur)
-#define MSG_TYPE_ENVIRONMENT    0x09  // Température + pression (+ humidité)
+// Nom, tailles de données admises et affichage de chaque type :
+// MESSAGE_TYPE_REGISTRY (fin de fichier). Un nouveau type = une valeur ici
+// et une entrée dans le registre.
+enum MessageType : uint8_t {
+    MSG_TYPE_TEMP_DATA      = 0x01,  // Données de température
+    MSG_TYPE_HUMAN_DETECT   = 0x02,  // Détection humaine (binaire: oui/non)
+    MSG_TYPE_HUMAN_COUNT    = 0x03,  // Comptage humain (nombre d'humains détectés)
+    MSG_TYPE_SENSOR_DATA    = 0x04,  // Données complètes capteur (multi-cibles)
+    MSG_TYPE_TEXT           = 0x10,  // Message texte
+    MSG_TYPE_STATUS         = 0x11,  // Statut général
+    MSG_TYPE_BATCH          = 0x12,  // Trame groupée (plusieurs enregistrements)
+    MSG_TYPE_PING           = 0x20,  // Ping
+    MSG_TYPE_PONG           = 0x21,  // Réponse Ping
+    MSG_TYPE_ACK            = 0xF0,  // Acquittement
+    MSG_TYPE_ERROR          = 0xFF,  // Erreur
+    
+    // Réserver 0x05-0x0F pour futures sondes
+    MSG_TYPE_HUMIDITY       = 0x05,  // Humidité (futur)
+    MSG_TYPE_PRESSURE       = 0x06,  // Pression (futur)
+    MSG_TYPE_LIGHT          = 0x07,  // Luminosité (futur)
+    MSG_TYPE_MOTION         = 0x08,  // Mouvement (futur)
+    MSG_TYPE_ENVIRONMENT    = 0x09   // Température + pression (+ humidité)
+};
 
 // ============================================
 // MAGIC NUMBERS
@@ -50,6 +59,20 @@
 #define PROTOCOL_MAX_DATA_SIZE  249   // Taille max des données (253-4)
 #define PROTOCOL_MAX_MSG_SIZE   253   // MAGIC_NUM + HEADER + DATA
 
+// MSG_TYPE_SENSOR_DATA, format compact (bit 7 du premier octet, voir SensorFrameEncoder)
+#define SENSOR_DATA_MAX_TARGETS     3
+#define SENSOR_COMPACT_FLAG         0x80  // Format compact (sinon format fixe, 8 octets par cible)
+#define SENSOR_KEYFRAME_FLAG        0x40  // Valeurs absolues (sinon deltas contre une référence)
+#define SENSOR_COUNT_MASK           0x0F
+#define SENSOR_COMPACT_MAX_SIZE     (4 + SENSOR_DATA_MAX_TARGETS * 12)  // varints de 3 octets au pire
+#define SENSOR_DELTA_HISTORY        4     // Trames récentes gardées comme références possibles
+#define SENSOR_DECODER_SOURCES      4     // Sources suivies par un SensorFrameDecoder
+
+// Trame BATCH : DATA = suite d'enregistrements [AGE (2B)][TYPE][ID_SOURCE][TAILLE][DATA...]
+// AGE = ancienneté de la mesure à l'émission, en dixièmes de seconde (saturé à 0xFFFF)
+#define PROTOCOL_BATCH_AGE_SIZE     2
+#define PROTOCOL_BATCH_MAX_RECORDS  32
+
 // ============================================
 // STRUCTURE DE MESSAGE
 // ============================================
@@ -61,6 +84,260 @@ struct ProtocolMessage {
     bool valid;             // Message valide après parsing
 };
 
+// ProtocolMessage suit l'ordre du format radio : une vue peut lire une copie
+static_assert(offsetof(ProtocolMessage, data) == PROTOCOL_HEADER_SIZE,
+              "ProtocolMessage doit suivre le format [TYPE][ID_SOURCE][TAILLE][DATA]");
+
+// Cibles d'une trame radar (MSG_TYPE_SENSOR_DATA), indexées par slot du capteur
+struct SensorFrame {
+    uint8_t count;
+    int16_t x[SENSOR_DATA_MAX_TARGETS];          // mm
+    int16_t y[SENSOR_DATA_MAX_TARGETS];          // mm
+    int16_t speed[SENSOR_DATA_MAX_TARGETS];      // cm/s
+    uint16_t resolution[SENSOR_DATA_MAX_TARGETS];
+};
+
+// ============================================
+// VUE SUR UN MESSAGE REÇU (SANS COPIE)
+// ============================================
+// En-tête [TYPE][ID_SOURCE][TAILLE] validé sur place, données lues
+// directement dans le buffer de réception. Valide tant que ce buffer n'est pas
+// réutilisé : ProtocolMessage reste disponible pour garder une copie.
+class ProtocolMessageView {
+public:
+    ProtocolMessageView() : buffer(nullptr), valid(false) {}
+    
+    /**
+     * Valide l'en-tête sur place (sans MAGIC_NUM)
+     * @return true si le buffer contient un message complet
+     */
+    bool parse(const uint8_t* data, uint16_t size) {
+        buffer = nullptr;
+        valid = false;
+        
+        if (data == nullptr || size < PROTOCOL_HEADER_SIZE) {
+            return false;
+        }
+        if (data[2] > PROTOCOL_MAX_DATA_SIZE || size < PROTOCOL_HEADER_SIZE + data[2]) {
+            return false;
+        }
+        
+        buffer = data;
+        valid = true;
+        return true;
+    }
+    
+    bool isValid() const { return valid; }
+    uint8_t type() const { return buffer[0]; }
+    uint8_t sourceId() const { return buffer[1]; }
+    uint8_t dataSize() const { return buffer[2]; }
+    const uint8_t* data() const { return buffer + PROTOCOL_HEADER_SIZE; }
+    uint8_t dataAt(uint8_t i) const { return buffer[PROTOCOL_HEADER_SIZE + i]; }
+    
+    // Taille totale du message (en-tête + données)
+    uint16_t size() const { return PROTOCOL_HEADER_SIZE + dataSize(); }
+    
+    // Copie possédée, pour un message à conserver au-delà du buffer
+    void copyTo(ProtocolMessage* msg) const {
+        msg->valid = valid;
+        if (!valid) return;
+        msg->type = type();
+        msg->sourceId = sourceId();
+        msg->dataSize = dataSize();
+        if (dataSize() > 0) {
+            memcpy(msg->data, data(), dataSize());
+        }
+    }
+    
+private:
+    const uint8_t* buffer;
+    bool valid;
+};
+
+// ============================================
+// TRAMES GROUPÉES (MSG_TYPE_BATCH)
+// ============================================
+// Plusieurs messages (types, sources et instants différents) dans une seule
+// trame : un seul en-tête radio, un seul chiffrement et un seul préambule pour
+// tout le lot. Chaque enregistrement est un message standard précédé de son
+// âge, les décodeurs habituels s'appliquent donc tels quels.
+
+/**
+ * Construit une trame BATCH côté émetteur
+ *
+ * Politique d'envoi (shouldFlush) : la trame part dès que le plus ancien
+ * enregistrement atteint maxAgeMs, ou dès qu'il reste moins de minFreeBytes
+ * (le prochain enregistrement risquerait de ne plus tenir).
+ */
+class ProtocolBatchWriter {
+public:
+    /**
+     * @param sourceId ID de la carte émettrice (en-tête de la trame)
+     * @param maxFrameSize Taille max de la trame encodée, en-tête compris (sans MAGIC_NUM)
+     * @param maxAgeMs Âge max du plus ancien enregistrement avant envoi
+     * @param minFreeBytes Place libre en dessous de laquelle la trame part
+     */
+    ProtocolBatchWriter(uint8_t sourceId, uint8_t maxFrameSize, uint32_t maxAgeMs, uint8_t minFreeBytes)
+        : sourceId(sourceId), maxAgeMs(maxAgeMs), minFreeBytes(minFreeBytes), used(0), recordCount(0) {
+        capacity = maxFrameSize > PROTOCOL_HEADER_SIZE ? maxFrameSize - PROTOCOL_HEADER_SIZE : 0;
+        if (capacity > PROTOCOL_MAX_DATA_SIZE) {
+            capacity = PROTOCOL_MAX_DATA_SIZE;
+        }
+    }
+    
+    /**
+     * Ajoute un enregistrement mesuré à timestampMs (millis)
+     * @return false si la trame est pleine (l'appelant envoie puis recommence)
+     */
+    bool add(uint8_t type, uint8_t recordSourceId, const uint8_t* data, uint8_t dataSize, uint32_t timestampMs) {
+        // Pas de trame groupée dans une trame groupée
+        if (type == MSG_TYPE_BATCH) return false;
+        if (recordCount >= PROTOCOL_BATCH_MAX_RECORDS) return false;
+        
+        const uint16_t recordSize = PROTOCOL_BATCH_AGE_SIZE + PROTOCOL_HEADER_SIZE + dataSize;
+        if (used + recordSize > capacity) return false;
+        
+        // L'âge est calculé à l'envoi (finish) : l'octet AGE garde la place
+        uint8_t* record = payload + used;
+        record[0] = 0;
+        record[1] = 0;
+        record[2] = type;
+        record[3] = recordSourceId;
+        record[4] = dataSize;
+        if (dataSize > 0 && data != nullptr) {
+            memcpy(record + PROTOCOL_BATCH_AGE_SIZE + PROTOCOL_HEADER_SIZE, data, dataSize);
+        }
+        
+        timestamps[recordCount++] = timestampMs;
+        used += recordSize;
+        return true;
+    }
+    
+    /**
+     * Ajoute un message déjà encodé par MessageProtocol::encode*Message
+     */
+    bool addMessage(const uint8_t* encoded, uint16_t len, uint32_t timestampMs) {
+        ProtocolMessageView view;
+        if (!view.parse(encoded, len)) return false;
+        return add(view.type(), view.sourceId(), view.data(), view.dataSize(), timestampMs);
+    }
+    
+    bool isEmpty() const { return recordCount == 0; }
+    uint8_t getRecordCount() const { return recordCount; }
+    uint16_t getFreeBytes() const { return capacity - used; }
+    
+    /**
+     * Trame à envoyer maintenant (âge ou remplissage)
+     */
+    bool shouldFlush(uint32_t nowMs) const {
+        if (recordCount == 0) return false;
+        if (getFreeBytes() < minFreeBytes) return true;
+        return nowMs - timestamps[0] >= maxAgeMs;
+    }
+    
+    /**
+     * Écrit la trame [BATCH][ID_SOURCE][TAILLE][enregistrements...] et vide le lot
+     * @param nowMs Instant d'envoi, référence des âges
+     * @param output Buffer de sortie (au moins maxFrameSize octets)
+     * @return Taille de la trame (0 si le lot est vide)
+     */
+    uint16_t finish(uint32_t nowMs, uint8_t* output) {
+        if (recordCount == 0) return 0;
+        
+        uint16_t offset = 0;
+        for (uint8_t i = 0; i < recordCount; i++) {
+            uint32_t ageDs = (nowMs - timestamps[i]) / 100;
+            if (ageDs > 0xFFFF) ageDs = 0xFFFF;
+            payload[offset] = ageDs & 0xFF;
+            payload[offset + 1] = (ageDs >> 8) & 0xFF;
+            offset += PROTOCOL_BATCH_AGE_SIZE + PROTOCOL_HEADER_SIZE + payload[offset + 4];
+        }
+        
+        output[0] = MSG_TYPE_BATCH;
+        output[1] = sourceId;
+        output[2] = (uint8_t)used;
+        memcpy(output + PROTOCOL_HEADER_SIZE, payload, used);
+        
+        const uint16_t frameSize = PROTOCOL_HEADER_SIZE + used;
+        used = 0;
+        recordCount = 0;
+        return frameSize;
+    }
+    
+private:
+    uint8_t sourceId;
+    uint32_t maxAgeMs;
+    uint8_t minFreeBytes;
+    uint16_t capacity;
+    uint16_t used;
+    uint8_t recordCount;
+    uint32_t timestamps[PROTOCOL_BATCH_MAX_RECORDS];  // millis de chaque enregistrement
+    uint8_t payload[PROTOCOL_MAX_DATA_SIZE];
+};
+
+/**
+ * Parcourt les enregistrements d'une trame BATCH reçue, sans copie
+ *
+ *   ProtocolBatchReader reader(msg);
+ *   ProtocolMessageView record;
+ *   uint16_t ageDs;
+ *   while (reader.next(record, ageDs)) { ... }
+ *
+ * Un enregistrement tronqué arrête le parcours (les précédents restent valides).
+ */
+class ProtocolBatchReader {
+public:
+    explicit ProtocolBatchReader(const ProtocolMessageView& batch)
+        : data(nullptr), size(0), offset(0) {
+        if (batch.isValid() && batch.type() == MSG_TYPE_BATCH) {
+            data = batch.data();
+            size = batch.dataSize();
+        }
+    }
+    
+    /**
+     * Enregistrement suivant
+     * @param record Vue sur le message de l'enregistrement
+     * @param ageDs Âge de la mesure à l'émission (dixièmes de seconde)
+     * @return false en fin de trame ou sur un enregistrement invalide (ou lui-même un lot)
+     */
+    bool next(ProtocolMessageView& record, uint16_t& ageDs) {
+        if (data == nullptr || offset + PROTOCOL_BATCH_AGE_SIZE >= size) return false;
+        
+        const uint8_t* entry = data + offset;
+        // Lot imbriqué refusé (l'écrivain n'en produit pas) : l'affichage récursif
+        // d'une trame forgée épuiserait la pile de loop()
+        if (!record.parse(entry + PROTOCOL_BATCH_AGE_SIZE, size - offset - PROTOCOL_BATCH_AGE_SIZE) ||
+            record.type() == MSG_TYPE_BATCH) {
+            data = nullptr;
+            return false;
+        }
+        
+        ageDs = entry[0] | (entry[1] << 8);
+        offset += PROTOCOL_BATCH_AGE_SIZE + record.size();
+        return true;
+    }
+    
+private:
+    const uint8_t* data;
+    uint16_t size;
+    uint16_t offset;
+};
+
+// ============================================
+// REGISTRE DES TYPES DE MESSAGE
+// ============================================
+// Une entrée par type (MESSAGE_TYPE_REGISTRY, après MessageProtocol) :
+// recherche dans une table constexpr, sans String ni allocation.
+struct MessageTypeInfo {
+    uint8_t type;
+    const char* name;
+    uint8_t minDataSize;    // données plus courtes : message rejeté par les décodeurs
+    uint8_t maxDataSize;    // données plus longues : idem
+    // Affichage des données décodées (nullptr : dump hexa)
+    void (*format)(const ProtocolMessageView& msg, const char* prefix);
+};
+
 // ============================================
 // CLASSE PROTOCOLE
 // ============================================
@@ -144,6 +421,7 @@ public:
      * Format data: [count][target1_data][target2_data][target3_data]
      * Chaque target: X(2B) Y(2B) Speed(2B) Resolution(2B) = 8 bytes
      * Total max: 1 + (3 * 8) = 25 bytes
+     * Format compact (deltas varint) : voir SensorFrameEncoder
      */
     static uint16_t encodeSensorDataMessage(uint8_t sourceId, uint8_t count,
                                              int16_t* x, int16_t* y, 
@@ -221,97 +499,198 @@ public:
     }
     
     /**
-     * Décode un message reçu (sans MAGIC_NUM)
-     * Format attendu: [TYPE][ID_SOURCE][TAILLE][DATA...]
-     * Le MAGIC_NUM doit être traité par l'appelant avant
-     * @param buffer Buffer contenant le message (sans magic number)
-     * @param bufferSize Taille du buffer
-     * @param msg Structure à remplir
-     * @return true si le décodage a réussi
+     * Varint non signé (7 bits par octet, poids faible d'abord)
+     * @return Nombre d'octets écrits (1 à 5)
      */
-    static bool decodeMessage(const uint8_t* buffer, uint16_t bufferSize, ProtocolMessage* msg) {
-        msg->valid = false;
-        
-        // Vérifier taille minimale: TYPE + ID + SIZE = 3 bytes
-        if (bufferSize < PROTOCOL_HEADER_SIZE) {
-            return false;
+    static uint8_t writeVarint(uint32_t value, uint8_t* output) {
+        uint8_t n = 0;
+        while (value >= 0x80) {
+            output[n++] = (value & 0x7F) | 0x80;
+            value >>= 7;
         }
-        
-        msg->type = buffer[0];
-        msg->sourceId = buffer[1];
-        msg->dataSize = buffer[2];
-        
-        // Vérifier la cohérence
-        if (msg->dataSize > PROTOCOL_MAX_DATA_SIZE) {
-            return false;
+        output[n++] = (uint8_t)value;
+        return n;
+    }
+    
+    /**
+     * Lit un varint à data[index] et avance index
+     * @return false si le varint dépasse la fin des données
+     */
+    static bool readVarint(const uint8_t* data, uint16_t size, uint16_t& index, uint32_t& value) {
+        value = 0;
+        for (uint8_t shift = 0; shift < 35; shift += 7) {
+            if (index >= size) return false;
+            const uint8_t b = data[index++];
+            value |= (uint32_t)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
         }
+        return false;
+    }
+    
+    // Zigzag : petits entiers signés -> petits varints (0, -1, 1, -2... -> 0, 1, 2, 3...)
+    static uint32_t zigzagEncode(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+    static int32_t zigzagDecode(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+    
+    static bool isCompactSensorData(const ProtocolMessageView& msg) {
+        return msg.isValid() && msg.type() == MSG_TYPE_SENSOR_DATA &&
+               msg.dataSize() >= 2 && (msg.dataAt(0) & SENSOR_COMPACT_FLAG);
+    }
+    static bool isSensorKeyframe(const ProtocolMessageView& msg) {
+        return !isCompactSensorData(msg) || (msg.dataAt(0) & SENSOR_KEYFRAME_FLAG);
+    }
+    // Numéro de trame compacte, et trame de référence d'un delta
+    static uint8_t sensorFrameSeq(const ProtocolMessageView& msg) { return msg.dataAt(1); }
+    static uint8_t sensorFrameRefSeq(const ProtocolMessageView& msg) { return msg.dataAt(2); }
+    
+    /**
+     * Décode les cibles d'un MSG_TYPE_SENSOR_DATA (format fixe ou compact)
+     * @param ref Trame de référence, requise pour un delta (ignorée sinon)
+     * @return false si le message est tronqué ou si un delta n'a pas de référence
+     */
+    static bool decodeSensorFrame(const ProtocolMessageView& msg, const SensorFrame* ref, SensorFrame& out) {
+        if (msg.type() != MSG_TYPE_SENSOR_DATA || !hasPayload(msg, MSG_TYPE_SENSOR_DATA)) return false;
+        memset(&out, 0, sizeof(out));
         
-        if (bufferSize < (PROTOCOL_HEADER_SIZE + msg->dataSize)) {
-            return false;
+        const uint8_t head = msg.dataAt(0);
+        if (!(head & SENSOR_COMPACT_FLAG)) {
+            // Format fixe : seules les cibles complètes sont retenues
+            uint8_t idx = 1;
+            for (uint8_t i = 0; i < head && i < SENSOR_DATA_MAX_TARGETS && (idx + 7) < msg.dataSize(); i++) {
+                out.x[i] = msg.dataAt(idx) | (msg.dataAt(idx+1) << 8);
+                out.y[i] = msg.dataAt(idx+2) | (msg.dataAt(idx+3) << 8);
+                out.speed[i] = msg.dataAt(idx+4) | (msg.dataAt(idx+5) << 8);
+                out.resolution[i] = msg.dataAt(idx+6) | (msg.dataAt(idx+7) << 8);
+                out.count = i + 1;
+                idx += 8;
+            }
+            return true;
         }
         
-        // Copier les données
-        if (msg->dataSize > 0) {
-            memcpy(msg->data, &buffer[3], msg->dataSize);
-        }
+        const bool keyframe = (head & SENSOR_KEYFRAME_FLAG) != 0;
+        const uint8_t count = head & SENSOR_COUNT_MASK;
+        if (count > SENSOR_DATA_MAX_TARGETS) return false;
+        if (!keyframe && ref == nullptr) return false;
         
-        msg->valid = true;
+        // [HEAD][SEQ] + delta : [REF_SEQ][MASQUE_RES]
+        uint16_t idx = keyframe ? 2 : 4;
+        if (idx > msg.dataSize()) return false;
+        const uint8_t resMask = keyframe ? 0xFF : msg.dataAt(3);
+        
+        out.count = count;
+        for (uint8_t i = 0; i < count; i++) {
+            // Cible absente de la référence : deltas contre zéro
+            const bool hasBase = !keyframe && i < ref->count;
+            uint32_t zx, zy, zs;
+            if (!readVarint(msg.data(), msg.dataSize(), idx, zx)) return false;
+            if (!readVarint(msg.data(), msg.dataSize(), idx, zy)) return false;
+            if (!readVarint(msg.data(), msg.dataSize(), idx, zs)) return false;
+            out.x[i] = (int16_t)((hasBase ? ref->x[i] : 0) + zigzagDecode(zx));
+            out.y[i] = (int16_t)((hasBase ? ref->y[i] : 0) + zigzagDecode(zy));
+            out.speed[i] = (int16_t)((hasBase ? ref->speed[i] : 0) + zigzagDecode(zs));
+            
+            if (resMask & (1 << i)) {
+                uint32_t res;
+                if (!readVarint(msg.data(), msg.dataSize(), idx, res)) return false;
+                out.resolution[i] = (uint16_t)res;
+            } else if (hasBase) {
+                out.resolution[i] = ref->resolution[i];
+            } else {
+                return false;
+            }
+        }
         return true;
     }
     
     /**
-     * Obtient le nom du type de message
+     * Décode un message reçu sans copie (sans MAGIC_NUM)
+     * Format attendu: [TYPE][ID_SOURCE][TAILLE][DATA...]
+     * Le MAGIC_NUM doit être traité par l'appelant avant
+     * @param buffer Buffer contenant le message (doit rester valide pendant l'usage de la vue)
+     * @param bufferSize Taille du buffer
+     * @param view Vue à initialiser sur le buffer
+     * @return true si le décodage a réussi
      */
-    static String getTypeName(uint8_t type) {
-        switch (type) {
-            case MSG_TYPE_TEMP_DATA:    return "TEMP";
-            case MSG_TYPE_HUMAN_DETECT: return "HUMAN";
-            case MSG_TYPE_HUMAN_COUNT:  return "HUMAN_COUNT";
-            case MSG_TYPE_SENSOR_DATA:  return "SENSOR_DATA";
-            case MSG_TYPE_TEXT:         return "TEXT";
-            case MSG_TYPE_STATUS:       return "STATUS";
-            case MSG_TYPE_PING:         return "PING";
-            case MSG_TYPE_PONG:         return "PONG";
-            case MSG_TYPE_ACK:          return "ACK";
-            case MSG_TYPE_ERROR:        return "ERROR";
-            case MSG_TYPE_HUMIDITY:     return "HUMID";
-            case MSG_TYPE_PRESSURE:     return "PRESS";
-            case MSG_TYPE_LIGHT:        return "LIGHT";
-            case MSG_TYPE_MOTION:       return "MOTION";
-            case MSG_TYPE_ENVIRONMENT:  return "ENV";
-            default:                    return "UNKNOWN";
+    static bool decodeMessage(const uint8_t* buffer, uint16_t bufferSize, ProtocolMessageView& view) {
+        return view.parse(buffer, bufferSize);
+    }
+    
+    /**
+     * Décode un message reçu dans une copie (sans MAGIC_NUM)
+     * @param msg Structure à remplir
+     * @return true si le décodage a réussi
+     */
+    static bool decodeMessage(const uint8_t* buffer, uint16_t bufferSize, ProtocolMessage* msg) {
+        ProtocolMessageView view;
+        view.parse(buffer, bufferSize);
+        view.copyTo(msg);
+        return msg->valid;
+    }
+    
+    /**
+     * Entrée du registre pour un type (nullptr si inconnu)
+     */
+    static const MessageTypeInfo* getTypeInfo(uint8_t type);
+    
+    /**
+     * Obtient le nom du type de message ("UNKNOWN" si absent du registre)
+     */
+    static const char* getTypeName(uint8_t type);
+    
+    /**
+     * Message valide dont la taille de données respecte le registre pour ce type
+     */
+    static bool hasPayload(const ProtocolMessageView& msg, uint8_t type);
+    
+    /**
+     * Vue sur une copie ProtocolMessage : la structure reprend l'ordre du
+     * format radio, les décodeurs ci-dessous servent les deux représentations
+     */
+    static ProtocolMessageView viewOf(const ProtocolMessage* msg) {
+        ProtocolMessageView view;
+        if (msg->valid) {
+            view.parse(&msg->type, PROTOCOL_HEADER_SIZE + msg->dataSize);
         }
+        return view;
     }
     
     /**
      * Décode et affiche une température
      */
-    static float decodeTempData(const ProtocolMessage* msg) {
-        if (msg->dataSize < 2) return 0.0f;
-        int16_t temp_x100 = msg->data[0] | (msg->data[1] << 8);
+    static float decodeTempData(const ProtocolMessageView& msg) {
+        if (!hasPayload(msg, MSG_TYPE_TEMP_DATA)) return 0.0f;
+        int16_t temp_x100 = msg.dataAt(0) | (msg.dataAt(1) << 8);
         return temp_x100 / 100.0f;
     }
+    static float decodeTempData(const ProtocolMessage* msg) {
+        return decodeTempData(viewOf(msg));
+    }
     
     /**
      * Décode une détection humaine (binaire)
      */
+    static bool decodeHumanDetect(const ProtocolMessageView& msg) {
+        if (!hasPayload(msg, MSG_TYPE_HUMAN_DETECT)) return false;
+        return msg.dataAt(0) != 0x00;
+    }
     static bool decodeHumanDetect(const ProtocolMessage* msg) {
-        if (msg->dataSize < 1) return false;
-        return msg->data[0] != 0x00;
+        return decodeHumanDetect(viewOf(msg));
     }
     
     /**
      * Décode un comptage humain (nombre)
      */
+    static uint8_t decodeHumanCount(const ProtocolMessageView& msg) {
+        if (!hasPayload(msg, MSG_TYPE_HUMAN_COUNT)) return 0;
+        return msg.dataAt(0);
+    }
     static uint8_t decodeHumanCount(const ProtocolMessage* msg) {
-        if (msg->dataSize < 1) return 0;
-        return msg->data[0];
+        return decodeHumanCount(viewOf(msg));
     }
     
     /**
      * Décode un message environnement (température, pression, humidité)
      */
-    static void decodeEnvironment(const ProtocolMessage* msg, float* temperatureOut, float* pressureOut, float* humidityOut) {
+    static void decodeEnvironment(const ProtocolMessageView& msg, float* temperatureOut, float* pressureOut, float* humidityOut) {
         if (temperatureOut) {
             *temperatureOut = 0.0f;
         }
@@ -322,120 +701,449 @@ public:
             *humidityOut = -1.0f;
         }
         
-        if (msg->dataSize < 4) {
+        if (!hasPayload(msg, MSG_TYPE_ENVIRONMENT)) {
             return;
         }
         
         if (temperatureOut) {
-            int16_t temp_x100 = msg->data[0] | (msg->data[1] << 8);
+            int16_t temp_x100 = msg.dataAt(0) | (msg.dataAt(1) << 8);
             *temperatureOut = temp_x100 / 100.0f;
         }
         if (pressureOut) {
-            uint16_t pressure_x10 = msg->data[2] | (msg->data[3] << 8);
+            uint16_t pressure_x10 = msg.dataAt(2) | (msg.dataAt(3) << 8);
             *pressureOut = pressure_x10 / 10.0f;
         }
-        if (humidityOut && msg->dataSize >= 5) {
-            uint8_t humidity = msg->data[4];
+        if (humidityOut && msg.dataSize() >= 5) {
+            uint8_t humidity = msg.dataAt(4);
             if (humidity <= 100) {
                 *humidityOut = humidity;
             }
         }
     }
+    static void decodeEnvironment(const ProtocolMessage* msg, float* temperatureOut, float* pressureOut, float* humidityOut) {
+        decodeEnvironment(viewOf(msg), temperatureOut, pressureOut, humidityOut);
+    }
     
     /**
      * Décode un timestamp (ping)
      */
+    static uint32_t decodeTimestamp(const ProtocolMessageView& msg) {
+        if (!hasPayload(msg, MSG_TYPE_PING)) return 0;
+        return (uint32_t)msg.dataAt(0) | 
+               ((uint32_t)msg.dataAt(1) << 8) | 
+               ((uint32_t)msg.dataAt(2) << 16) | 
+               ((uint32_t)msg.dataAt(3) << 24);
+    }
     static uint32_t decodeTimestamp(const ProtocolMessage* msg) {
-        if (msg->dataSize < 4) return 0;
-        return msg->data[0] | 
-               (msg->data[1] << 8) | 
-               (msg->data[2] << 16) | 
-               (msg->data[3] << 24);
+        return decodeTimestamp(viewOf(msg));
+    }
+    
+    /**
+     * Affiche les cibles d'une trame radar décodée
+     */
+    static void printSensorTargets(const SensorFrame& frame, const char* prefix = "") {
+        for (uint8_t i = 0; i < frame.count && i < SENSOR_DATA_MAX_TARGETS; i++) {
+            int16_t x = frame.x[i];
+            int16_t y = frame.y[i];
+            float dist = sqrt(x * x + y * y) / 10.0;
+            LOG_INFO(LOG_CAT_PROTO, "%t  Cible %u: X=%dmm Y=%dmm (%.1fcm) v=%dcm/s res=%u",
+                     LogData(prefix), i + 1, x, y, dist, frame.speed[i], frame.resolution[i]);
+        }
     }
     
     /**
-     * Affiche un message décodé (debug)
+     * Affiche un message décodé (debug), via le formateur du registre
      */
     static void printMessage(const ProtocolMessage* msg, const char* prefix = "") {
-        if (!msg->valid) {
-            Serial.println(String(prefix) + "Message invalide");
+        printMessage(viewOf(msg), prefix);
+    }
+    static void printMessage(const ProtocolMessageView& msg, const char* prefix = "");
+    
+    // ============================================
+    // FORMATEURS DU REGISTRE (taille déjà validée)
+    // ============================================
+    static void formatTemp(const ProtocolMessageView& msg, const char* prefix) {
+        LOG_INFO(LOG_CAT_PROTO, "%tTemp     : %.1f °C", LogData(prefix), decodeTempData(msg));
+    }
+    
+    static void formatHumanDetect(const ProtocolMessageView& msg, const char* prefix) {
+        LOG_INFO(LOG_CAT_PROTO, "%tDétecté  : %s", LogData(prefix), decodeHumanDetect(msg) ? "OUI" : "NON");
+    }
+    
+    static void formatHumanCount(const ProtocolMessageView& msg, const char* prefix) {
+        uint8_t count = decodeHumanCount(msg);
+        LOG_INFO(LOG_CAT_PROTO, "%tHumains  : %u %s", LogData(prefix), count, count > 1 ? "personnes" : "personne");
+    }
+    
+    static void formatSensorData(const ProtocolMessageView& msg, const char* prefix) {
+        if (isCompactSensorData(msg)) {
+            if (!isSensorKeyframe(msg) && msg.dataSize() >= 3) {
+                LOG_INFO(LOG_CAT_PROTO, "%tFormat   : compact, trame %u (delta sur %u)",
+                         LogData(prefix), sensorFrameSeq(msg), sensorFrameRefSeq(msg));
+            } else {
+                LOG_INFO(LOG_CAT_PROTO, "%tFormat   : compact, trame %u (keyframe)", LogData(prefix), sensorFrameSeq(msg));
+            }
+        }
+        
+        // Un delta ne se décode qu'avec sa référence (SensorFrameDecoder)
+        SensorFrame frame;
+        if (!decodeSensorFrame(msg, nullptr, frame)) {
+            LOG_INFO(LOG_CAT_PROTO, "%tCapteur  : deltas (référence requise)", LogData(prefix));
             return;
         }
         
-        Serial.println(String(prefix) + "─────────────────");
-        Serial.println(String(prefix) + "Type     : 0x" + String(msg->type, HEX) + " (" + getTypeName(msg->type) + ")");
-        Serial.println(String(prefix) + "Source   : " + String(msg->sourceId));
-        Serial.println(String(prefix) + "Taille   : " + String(msg->dataSize) + " bytes");
+        uint8_t count = frame.count;
+        LOG_INFO(LOG_CAT_PROTO, "%tCapteur  : %u %s", LogData(prefix), count,
+                 count > 1 ? "cibles" : (count == 1 ? "cible" : "cible (aucune détection)"));
         
-        // Afficher les données selon le type
-        if (msg->type == MSG_TYPE_TEMP_DATA && msg->dataSize >= 2) {
-            float temp = decodeTempData(msg);
-            Serial.println(String(prefix) + "Temp     : " + String(temp, 1) + " °C");
+        if (count == 0) {
+            LOG_INFO(LOG_CAT_PROTO, "%t  → Zone libre (pas de présence détectée)", LogData(prefix));
         }
-        else if (msg->type == MSG_TYPE_HUMAN_DETECT && msg->dataSize >= 1) {
-            bool detected = decodeHumanDetect(msg);
-            Serial.println(String(prefix) + "Détecté  : " + String(detected ? "OUI" : "NON"));
+        printSensorTargets(frame, prefix);
+    }
+    
+    static void formatEnvironment(const ProtocolMessageView& msg, const char* prefix) {
+        float temp = 0.0f;
+        float pressure = 0.0f;
+        float humidity = -1.0f;
+        decodeEnvironment(msg, &temp, &pressure, &humidity);
+        LOG_INFO(LOG_CAT_PROTO, "%tTemp     : %.1f °C", LogData(prefix), temp);
+        LOG_INFO(LOG_CAT_PROTO, "%tPression : %.1f hPa", LogData(prefix), pressure);
+        if (humidity >= 0.0f) {
+            LOG_INFO(LOG_CAT_PROTO, "%tHumidité : %.0f %%", LogData(prefix), humidity);
         }
-        else if (msg->type == MSG_TYPE_HUMAN_COUNT && msg->dataSize >= 1) {
-            uint8_t count = decodeHumanCount(msg);
-            Serial.println(String(prefix) + "Humains  : " + String(count) + (count > 1 ? " personnes" : " personne"));
+    }
+    
+    static void formatText(const ProtocolMessageView& msg, const char* prefix) {
+        LOG_INFO(LOG_CAT_PROTO, "%tTexte    : %t", LogData(prefix), LogData(msg.data(), msg.dataSize()));
+    }
+    
+    static void formatTimestamp(const ProtocolMessageView& msg, const char* prefix) {
+        LOG_INFO(LOG_CAT_PROTO, "%tTimestamp: %u", LogData(prefix), decodeTimestamp(msg));
+    }
+    
+    static void formatBatch(const ProtocolMessageView& msg, const char* prefix) {
+        // Chaque enregistrement est affiché comme un message isolé, avec son âge
+        char recordPrefix[32];
+        snprintf(recordPrefix, sizeof(recordPrefix), "%s  ", prefix);
+        ProtocolBatchReader reader(msg);
+        ProtocolMessageView record;
+        uint16_t ageDs = 0;
+        uint8_t index = 0;
+        while (reader.next(record, ageDs)) {
+            index++;
+            LOG_INFO(LOG_CAT_PROTO, "%tEnreg. %u : il y a %.1f s", LogData(prefix), index, ageDs / 10.0f);
+            printMessage(record, recordPrefix);
         }
-        else if (msg->type == MSG_TYPE_SENSOR_DATA && msg->dataSize >= 1) {
-            uint8_t count = msg->data[0];
-            Serial.println(String(prefix) + "Capteur  : " + String(count) + (count > 1 ? " cibles" : (count == 1 ? " cible" : " cible (aucune détection)")));
-            
-            if (count == 0) {
-                Serial.println(String(prefix) + "  → Zone libre (pas de présence détectée)");
+        LOG_INFO(LOG_CAT_PROTO, "%tLot      : %u enregistrement(s)", LogData(prefix), index);
+    }
+    
+    static void formatHex(const ProtocolMessageView& msg, const char* prefix) {
+        LOG_INFO(LOG_CAT_PROTO, "%tData (hex): %h", LogData(prefix), LogData(msg.data(), msg.dataSize()));
+    }
+};
+
+// ============================================
+// REGISTRE : UNE ENTRÉE PAR TYPE
+// ============================================
+static constexpr MessageTypeInfo MESSAGE_TYPE_REGISTRY[] = {
+    // type                  nom            min  max                      affichage
+    { MSG_TYPE_TEMP_DATA,    "TEMP",        2,   2,                       &MessageProtocol::formatTemp },
+    { MSG_TYPE_HUMAN_DETECT, "HUMAN",       1,   1,                       &MessageProtocol::formatHumanDetect },
+    { MSG_TYPE_HUMAN_COUNT,  "HUMAN_COUNT", 1,   1,                       &MessageProtocol::formatHumanCount },
+    { MSG_TYPE_SENSOR_DATA,  "SENSOR_DATA", 1,   SENSOR_COMPACT_MAX_SIZE, &MessageProtocol::formatSensorData },
+    { MSG_TYPE_HUMIDITY,     "HUMID",       0,   PROTOCOL_MAX_DATA_SIZE,  nullptr },
+    { MSG_TYPE_PRESSURE,     "PRESS",       0,   PROTOCOL_MAX_DATA_SIZE,  nullptr },
+    { MSG_TYPE_LIGHT,        "LIGHT",       0,   PROTOCOL_MAX_DATA_SIZE,  nullptr },
+    { MSG_TYPE_MOTION,       "MOTION",      0,   PROTOCOL_MAX_DATA_SIZE,  nullptr },
+    { MSG_TYPE_ENVIRONMENT,  "ENV",         4,   5,                       &MessageProtocol::formatEnvironment },
+    { MSG_TYPE_TEXT,         "TEXT",        0,   PROTOCOL_MAX_DATA_SIZE,  &MessageProtocol::formatText },
+    { MSG_TYPE_STATUS,       "STATUS",      0,   PROTOCOL_MAX_DATA_SIZE,  nullptr },
+    { MSG_TYPE_BATCH,        "BATCH",       0,   PROTOCOL_MAX_DATA_SIZE,  &MessageProtocol::formatBatch },
+    { MSG_TYPE_PING,         "PING",        4,   4,                       &MessageProtocol::formatTimestamp },
+    { MSG_TYPE_PONG,         "PONG",        4,   4,                       &MessageProtocol::formatTimestamp },
+    { MSG_TYPE_ACK,          "ACK",         0,   PROTOCOL_MAX_DATA_SIZE,  nullptr },
+    { MSG_TYPE_ERROR,        "ERROR",       0,   PROTOCOL_MAX_DATA_SIZE,  nullptr },
+};
+
+static constexpr size_t MESSAGE_TYPE_COUNT = sizeof(MESSAGE_TYPE_REGISTRY) / sizeof(MESSAGE_TYPE_REGISTRY[0]);
+
+// Recherche constexpr (C++11 : une seule expression, d'où la récursion)
+constexpr const MessageTypeInfo* findMessageType(uint8_t type, size_t index = 0) {
+    return index >= MESSAGE_TYPE_COUNT ? nullptr
+         : MESSAGE_TYPE_REGISTRY[index].type == type ? &MESSAGE_TYPE_REGISTRY[index]
+         : findMessageType(type, index + 1);
+}
+
+// Contrôles à la compilation : pas de doublon, tailles cohérentes
+constexpr bool messageTypeRegistryValid(size_t index = 0) {
+    return index >= MESSAGE_TYPE_COUNT ||
+           (findMessageType(MESSAGE_TYPE_REGISTRY[index].type) == &MESSAGE_TYPE_REGISTRY[index] &&
+            MESSAGE_TYPE_REGISTRY[index].minDataSize <= MESSAGE_TYPE_REGISTRY[index].maxDataSize &&
+            MESSAGE_TYPE_REGISTRY[index].maxDataSize <= PROTOCOL_MAX_DATA_SIZE &&
+            messageTypeRegistryValid(index + 1));
+}
+static_assert(messageTypeRegistryValid(), "MESSAGE_TYPE_REGISTRY : type en double ou tailles incohérentes");
+static_assert(findMessageType(MSG_TYPE_ENVIRONMENT)->minDataSize == 4, "ENV : au moins température + pression");
+
+inline const MessageTypeInfo* MessageProtocol::getTypeInfo(uint8_t type) {
+    return findMessageType(type);
+}
+
+inline const char* MessageProtocol::getTypeName(uint8_t type) {
+    const MessageTypeInfo* info = findMessageType(type);
+    return info ? info->name : "UNKNOWN";
+}
+
+inline bool MessageProtocol::hasPayload(const ProtocolMessageView& msg, uint8_t type) {
+    const MessageTypeInfo* info = findMessageType(type);
+    return msg.isValid() && info != nullptr &&
+           msg.dataSize() >= info->minDataSize && msg.dataSize() <= info->maxDataSize;
+}
+
+inline void MessageProtocol::printMessage(const ProtocolMessageView& msg, const char* prefix) {
+    if (!msg.isValid()) {
+        LOG_INFO(LOG_CAT_PROTO, "%tMessage invalide", LogData(prefix));
+        return;
+    }
+    
+    LOG_INFO(LOG_CAT_PROTO, "%t─────────────────", LogData(prefix));
+    LOG_INFO(LOG_CAT_PROTO, "%tType     : 0x%X (%s)", LogData(prefix), msg.type(), getTypeName(msg.type()));
+    LOG_INFO(LOG_CAT_PROTO, "%tSource   : %u", LogData(prefix), msg.sourceId());
+    LOG_INFO(LOG_CAT_PROTO, "%tTaille   : %u bytes", LogData(prefix), msg.dataSize());
+    
+    // Formateur du type si les données ont la taille attendue, sinon hexa
+    const MessageTypeInfo* info = findMessageType(msg.type());
+    if (info != nullptr && info->format != nullptr && hasPayload(msg, msg.type())) {
+        info->format(msg, prefix);
+    } else {
+        formatHex(msg, prefix);
+    }
+    
+    LOG_INFO(LOG_CAT_PROTO, "%t─────────────────", LogData(prefix));
+}
+
+// ============================================
+// TRAMES RADAR COMPACTES (MSG_TYPE_SENSOR_DATA)
+// ============================================
+// Format compact : [HEAD][SEQ] puis, pour un delta, [REF_SEQ][MASQUE_RES]
+//   HEAD = SENSOR_COMPACT_FLAG | SENSOR_KEYFRAME_FLAG (keyframe) | nombre de cibles
+//   Par cible : X, Y, vitesse en varints zigzag (absolus ou deltas contre la
+//   référence), puis la résolution en varint si elle est dans le masque
+//   (toujours présente dans une keyframe, sinon seulement quand elle change).
+// Une cible immobile coûte 3 octets au lieu de 8.
+//
+// Référence d'un delta : la dernière keyframe, ou la dernière trame acquittée
+// par le récepteur (acknowledge) sur un lien fiable. Un delta perdu ne casse
+// donc pas les suivants ; une keyframe perdue se rattrape à la suivante.
+
+/**
+ * Encodeur côté capteur : une keyframe toutes les keyframeInterval trames,
+ * des deltas entre les deux
+ */
+class SensorFrameEncoder {
+public:
+    explicit SensorFrameEncoder(uint8_t keyframeInterval)
+        : keyframeInterval(keyframeInterval), framesSinceKeyframe(0), nextSeq(0),
+          hasReference(false), referenceSeq(0), historyNext(0) {
+        for (uint8_t i = 0; i < SENSOR_DELTA_HISTORY; i++) {
+            history[i].used = false;
+        }
+    }
+    
+    /**
+     * Encode une trame radar (message complet, sans MAGIC_NUM)
+     * @return Taille du message encodé (au plus 3 + 4 + 3 * 12 octets)
+     */
+    uint16_t encode(uint8_t sourceId, const SensorFrame& frame, uint8_t* output) {
+        SensorFrame sent = frame;
+        if (sent.count > SENSOR_DATA_MAX_TARGETS) sent.count = SENSOR_DATA_MAX_TARGETS;
+        const uint8_t count = sent.count;
+        const bool keyframe = !hasReference || framesSinceKeyframe >= keyframeInterval;
+        const uint8_t seq = nextSeq++;
+        
+        uint8_t data[SENSOR_COMPACT_MAX_SIZE];
+        uint8_t idx = 0;
+        data[idx++] = SENSOR_COMPACT_FLAG | (keyframe ? SENSOR_KEYFRAME_FLAG : 0) | count;
+        data[idx++] = seq;
+        
+        uint8_t resMask = 0xFF;
+        if (!keyframe) {
+            resMask = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                if (i >= reference.count || frame.resolution[i] != reference.resolution[i]) {
+                    resMask |= (1 << i);
+                }
             }
-            
-            // Décoder chaque cible
-            uint8_t idx = 1;
-            for (uint8_t i = 0; i < count && i < 3 && (idx + 7) < msg->dataSize; i++) {
-                int16_t x = msg->data[idx] | (msg->data[idx+1] << 8);
-                int16_t y = msg->data[idx+2] | (msg->data[idx+3] << 8);
-                int16_t speed = msg->data[idx+4] | (msg->data[idx+5] << 8);
-                uint16_t res = msg->data[idx+6] | (msg->data[idx+7] << 8);
-                idx += 8;
-                
-                float dist = sqrt(x * x + y * y) / 10.0;
-                Serial.print(String(prefix) + "  Cible " + String(i+1) + ": ");
-                Serial.print("X=" + String(x) + "mm Y=" + String(y) + "mm ");
-                Serial.print("(" + String(dist, 1) + "cm) ");
-                Serial.print("v=" + String(speed) + "cm/s ");
-                Serial.println("res=" + String(res));
+            data[idx++] = referenceSeq;
+            data[idx++] = resMask;
+        }
+        
+        for (uint8_t i = 0; i < count; i++) {
+            const bool hasBase = !keyframe && i < reference.count;
+            idx += MessageProtocol::writeVarint(MessageProtocol::zigzagEncode(frame.x[i] - (hasBase ? reference.x[i] : 0)), data + idx);
+            idx += MessageProtocol::writeVarint(MessageProtocol::zigzagEncode(frame.y[i] - (hasBase ? reference.y[i] : 0)), data + idx);
+            idx += MessageProtocol::writeVarint(MessageProtocol::zigzagEncode(frame.speed[i] - (hasBase ? reference.speed[i] : 0)), data + idx);
+            if (resMask & (1 << i)) {
+                idx += MessageProtocol::writeVarint(frame.resolution[i], data + idx);
             }
         }
-        else if (msg->type == MSG_TYPE_ENVIRONMENT && msg->dataSize >= 4) {
-            float temp = 0.0f;
-            float pressure = 0.0f;
-            float humidity = -1.0f;
-            decodeEnvironment(msg, &temp, &pressure, &humidity);
-            Serial.println(String(prefix) + "Temp     : " + String(temp, 1) + " °C");
-            Serial.println(String(prefix) + "Pression : " + String(pressure, 1) + " hPa");
-            if (humidity >= 0.0f) {
-                Serial.println(String(prefix) + "Humidité : " + String(humidity, 0) + " %");
+        
+        remember(seq, sent);
+        if (keyframe) {
+            setReference(seq, sent);
+            framesSinceKeyframe = 1;
+        } else {
+            framesSinceKeyframe++;
+        }
+        
+        return MessageProtocol::encodeMessage(MSG_TYPE_SENSOR_DATA, sourceId, data, idx, output);
+    }
+    
+    /**
+     * Le récepteur a bien reçu la trame seq : elle devient la référence des
+     * deltas suivants (ignoré si elle est sortie de l'historique ou plus ancienne)
+     */
+    void acknowledge(uint8_t seq) {
+        if (hasReference && (int8_t)(seq - referenceSeq) <= 0) return;
+        for (uint8_t i = 0; i < SENSOR_DELTA_HISTORY; i++) {
+            if (history[i].used && history[i].seq == seq) {
+                setReference(seq, history[i].frame);
+                return;
             }
         }
-        else if (msg->type == MSG_TYPE_TEXT) {
-            String text = String((char*)msg->data, msg->dataSize);
-            Serial.println(String(prefix) + "Texte    : " + text);
-        }
-        else if (msg->type == MSG_TYPE_PING && msg->dataSize >= 4) {
-            uint32_t timestamp = decodeTimestamp(msg);
-            Serial.println(String(prefix) + "Timestamp: " + String(timestamp));
-        }
-        else {
-            // Afficher en hexa
-            Serial.print(String(prefix) + "Data (hex): ");
-            for (uint8_t i = 0; i < msg->dataSize; i++) {
-                if (msg->data[i] < 0x10) Serial.print("0");
-                Serial.print(msg->data[i], HEX);
-                Serial.print(" ");
+    }
+    
+    // Prochaine trame en keyframe (nouveau récepteur, resynchronisation demandée,
+    // trame non émise : encode() a déjà pris une keyframe perdue pour référence)
+    void requestKeyframe() { hasReference = false; }
+    
+private:
+    struct SentFrame {
+        bool used;
+        uint8_t seq;
+        SensorFrame frame;
+    };
+    
+    uint8_t keyframeInterval;
+    uint8_t framesSinceKeyframe;
+    uint8_t nextSeq;
+    bool hasReference;
+    uint8_t referenceSeq;
+    SensorFrame reference;
+    SentFrame history[SENSOR_DELTA_HISTORY];  // dernières trames émises (acquittables)
+    uint8_t historyNext;
+    
+    void remember(uint8_t seq, const SensorFrame& frame) {
+        SentFrame& slot = history[historyNext];
+        slot.used = true;
+        slot.seq = seq;
+        slot.frame = frame;
+        historyNext = (historyNext + 1) % SENSOR_DELTA_HISTORY;
+    }
+    
+    void setReference(uint8_t seq, const SensorFrame& frame) {
+        reference = frame;
+        referenceSeq = seq;
+        hasReference = true;
+    }
+};
+
+/**
+ * Décodeur côté récepteur : garde pour chaque source sa dernière keyframe et
+ * ses trames récentes, de quoi retrouver la référence de chaque delta
+ */
+class SensorFrameDecoder {
+public:
+    SensorFrameDecoder() : useCounter(0) {
+        for (uint8_t i = 0; i < SENSOR_DECODER_SOURCES; i++) {
+            sources[i].used = false;
+        }
+    }
+    
+    /**
+     * Décode un MSG_TYPE_SENSOR_DATA (format fixe ou compact)
+     * @return false si le message est invalide ou si la référence d'un delta
+     *         manque (keyframe perdue : attendre la suivante)
+     */
+    bool decode(const ProtocolMessageView& msg, SensorFrame& out) {
+        if (!MessageProtocol::isCompactSensorData(msg)) {
+            return MessageProtocol::decodeSensorFrame(msg, nullptr, out);
+        }
+        
+        Source& source = sourceFor(msg.sourceId());
+        const uint8_t seq = MessageProtocol::sensorFrameSeq(msg);
+        const bool keyframe = MessageProtocol::isSensorKeyframe(msg);
+        
+        const SensorFrame* ref = nullptr;
+        if (!keyframe) {
+            if (msg.dataSize() < 4) return false;
+            ref = find(source, MessageProtocol::sensorFrameRefSeq(msg));
+            if (ref == nullptr) return false;
+        }
+        if (!MessageProtocol::decodeSensorFrame(msg, ref, out)) return false;
+        
+        Entry& slot = keyframe ? source.keyframe : source.recent[source.recentNext];
+        if (!keyframe) {
+            source.recentNext = (source.recentNext + 1) % SENSOR_DELTA_HISTORY;
+        }
+        slot.used = true;
+        slot.seq = seq;
+        slot.frame = out;
+        return true;
+    }
+    
+private:
+    struct Entry {
+        bool used;
+        uint8_t seq;
+        SensorFrame frame;
+    };
+    struct Source {
+        bool used;
+        uint8_t sourceId;
+        uint32_t lastUse;
+        Entry keyframe;
+        Entry recent[SENSOR_DELTA_HISTORY];
+        uint8_t recentNext;
+    };
+    
+    Source sources[SENSOR_DECODER_SOURCES];
+    uint32_t useCounter;
+    
+    // Source connue, sinon slot libre ou le moins récemment utilisé
+    Source& sourceFor(uint8_t sourceId) {
+        Source* victim = &sources[0];
+        for (uint8_t i = 0; i < SENSOR_DECODER_SOURCES; i++) {
+            Source& s = sources[i];
+            if (s.used && s.sourceId == sourceId) {
+                s.lastUse = ++useCounter;
+                return s;
+            }
+            if (!s.used) {
+                if (victim->used) victim = &s;
+            } else if (victim->used && s.lastUse < victim->lastUse) {
+                victim = &s;
             }
-            Serial.println();
         }
         
-        Serial.println(String(prefix) + "─────────────────");
+        victim->used = true;
+        victim->sourceId = sourceId;
+        victim->lastUse = ++useCounter;
+        victim->keyframe.used = false;
+        for (uint8_t i = 0; i < SENSOR_DELTA_HISTORY; i++) {
+            victim->recent[i].used = false;
+        }
+        victim->recentNext = 0;
+        return *victim;
+    }
+    
+    static const SensorFrame* find(const Source& source, uint8_t seq) {
+        if (source.keyframe.used && source.keyframe.seq == seq) return &source.keyframe.frame;
+        for (uint8_t i = 0; i < SENSOR_DELTA_HISTORY; i++) {
+            if (source.recent[i].used && source.recent[i].seq == seq) return &source.recent[i].frame;
+        }
+        return nullptr;
     }
 };
 
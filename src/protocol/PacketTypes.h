@@ -10,7 +10,10 @@ enum PacketType : uint8_t {
 	PKT_DATA = 0x10,
 	PKT_BEACON = 0x30,
 	PKT_ACK = 0x11,
-	PKT_HEARTBEAT = 0x31
+	PKT_DATA_FEC = 0x12,
+	PKT_SACK = 0x13,
+	PKT_HEARTBEAT = 0x31,
+	PKT_RATE_CTRL = 0x40
 };
 
 #endif // PACKET_TYPES_H
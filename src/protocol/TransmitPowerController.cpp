@@ -0,0 +1,178 @@
+#include "../protocol/TransmitPowerController.h"
+#ifdef RADIO_SIM
+#include "../sim/SimRadio.h"
+#else
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#endif
+#include "../utils/Log.h"
+
+template <class Radio>
+TransmitPowerController<Radio>::TransmitPowerController(Radio* lora, FragmentManager<Radio>* fragment,
+                                                        HeartbeatManager<Radio>* heartbeat)
+	: lora(lora), fragment(fragment), heartbeat(heartbeat), enabled(true), peerCount(0),
+	  currentPeer(0), reportsSinceChange(0), lastReportedRssi(0), lastMarginDb(0), backoffCount(0) {
+	snapshot = fragment->getLinkStats();
+}
+
+template <class Radio>
+void TransmitPowerController<Radio>::setEnabled(bool on) {
+	enabled = on;
+	if (!on) {
+		applyPower(lora->getMaxPowerIndex(), "contrôle désactivé");
+	}
+}
+
+template <class Radio>
+void TransmitPowerController<Radio>::applyPower(uint8_t index, const char* reason) {
+	reportsSinceChange = 0;
+	snapshot = fragment->getLinkStats();
+	if (index == lora->getPowerIndex()) return;
+	
+	{
+		LogSerialLock lock;
+		Serial.print("[TPC] ");
+		Serial.print(lora->getPowerDbm(lora->getPowerIndex()));
+		Serial.print(" -> ");
+		Serial.print(lora->getPowerDbm(index));
+		Serial.print(" dBm (");
+		Serial.print(reason);
+		Serial.println(")");
+	}
+	// Hors verrou : sur le E220, vidage de la file TX et passage en mode configuration
+	lora->setPowerIndex(index);
+}
+
+template <class Radio>
+void TransmitPowerController<Radio>::rememberPeer() {
+	if (currentPeer == 0) return;
+	
+	// Entrée existante, sinon place libre, sinon la moins récemment utilisée
+	uint8_t slot = 0;
+	bool found = false;
+	for (uint8_t i = 0; i < peerCount; i++) {
+		if (peers[i].id == currentPeer) {
+			slot = i;
+			found = true;
+			break;
+		}
+		if (peers[i].lastUsedMs < peers[slot].lastUsedMs) slot = i;
+	}
+	if (!found && peerCount < MAX_PEERS) {
+		slot = peerCount++;
+	}
+	peers[slot].id = currentPeer;
+	peers[slot].powerIndex = lora->getPowerIndex();
+	peers[slot].lastUsedMs = millis();
+}
+
+template <class Radio>
+void TransmitPowerController<Radio>::selectPeer(uint32_t peerId) {
+	if (peerId == currentPeer) return;
+	rememberPeer();
+	currentPeer = peerId;
+	
+	for (uint8_t i = 0; i < peerCount; i++) {
+		if (peers[i].id == peerId) {
+			applyPower(peers[i].powerIndex, "puissance mémorisée du pair");
+			return;
+		}
+	}
+	applyPower(lora->getMaxPowerIndex(), "nouveau pair");
+}
+
+template <class Radio>
+void TransmitPowerController<Radio>::process(bool isPaired, bool peerOnline, uint32_t peerId) {
+	int rssi = 0;
+	const bool report = heartbeat->takeRssiReport(rssi);
+	
+	if (!enabled) return;
+	
+	// Sans pair joignable : pleine portée (beacons, appairage, rendez-vous)
+	if (!isPaired || !peerOnline || peerId == 0) {
+		if (lora->getPowerIndex() != lora->getMaxPowerIndex()) {
+			applyPower(lora->getMaxPowerIndex(), "pair hors ligne");
+		}
+		return;
+	}
+	
+	selectPeer(peerId);
+	
+	// Back-off rapide : les pertes n'attendent pas le prochain retour RSSI
+	const LinkStats& st = fragment->getLinkStats();
+	if (st.failures != snapshot.failures ||
+	    st.retransmissions - snapshot.retransmissions >= BACKOFF_RETRANSMISSIONS) {
+		if (lora->getPowerIndex() != lora->getMaxPowerIndex()) {
+			backoffCount++;
+			applyPower(lora->getMaxPowerIndex(), "pertes d'ACK");
+			rememberPeer();
+		} else {
+			snapshot = st;
+		}
+		return;
+	}
+	
+	if (report) {
+		onRssiReport(rssi);
+	}
+}
+
+template <class Radio>
+void TransmitPowerController<Radio>::onRssiReport(int rssi) {
+	lastReportedRssi = rssi;
+	lastMarginDb = rssi - lora->getSensitivityDbm();
+	// Les retransmissions isolées ne s'accumulent pas d'un retour à l'autre
+	snapshot = fragment->getLinkStats();
+	
+	const uint8_t current = lora->getPowerIndex();
+	if (lastMarginDb < TARGET_MARGIN_DB) {
+		if (current < lora->getMaxPowerIndex()) {
+			applyPower(current + 1, "marge insuffisante");
+			rememberPeer();
+		}
+		return;
+	}
+	
+	// Le retour peut encore porter sur une trame émise avant le dernier changement
+	if (++reportsSinceChange < REPORTS_PER_STEP) return;
+	
+	if (current > 0) {
+		const int stepDb = lora->getPowerDbm(current) - lora->getPowerDbm(current - 1);
+		if (lastMarginDb - stepDb >= TARGET_MARGIN_DB) {
+			applyPower(current - 1, "marge suffisante");
+			rememberPeer();
+		}
+	}
+}
+
+template <class Radio>
+void TransmitPowerController<Radio>::printStatus() const {
+	LogSerialLock lock;
+	Serial.print("[TPC] Puissance ");
+	Serial.print(lora->bandName());
+	Serial.print(": ");
+	Serial.print(lora->getPowerDbm(lora->getPowerIndex()));
+	Serial.print(" dBm (nominale ");
+	Serial.print(lora->getPowerDbm(lora->getMaxPowerIndex()));
+	Serial.print(" dBm, auto ");
+	Serial.print(enabled ? "ON" : "OFF");
+	Serial.println(")");
+	if (lastReportedRssi != 0) {
+		Serial.print("[TPC] Reçu par le pair à ");
+		Serial.print(lastReportedRssi);
+		Serial.print(" dBm, marge ");
+		Serial.print(lastMarginDb);
+		Serial.print(" dB (cible ");
+		Serial.print(TARGET_MARGIN_DB);
+		Serial.print(" dB), back-off ");
+		Serial.println(backoffCount);
+	}
+}
+
+// Instanciations explicites : une par driver radio
+#ifdef RADIO_SIM
+template class TransmitPowerController<SimRadio>;
+#else
+template class TransmitPowerController<LoRaModule>;
+template class TransmitPowerController<XL1278Module>;
+#endif
@@ -0,0 +1,71 @@
+#ifndef TRANSMIT_POWER_CONTROLLER_H
+#define TRANSMIT_POWER_CONTROLLER_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "../Config.h"
+#include "../protocol/FragmentManager.h"
+#include "../utils/HeartbeatManager.h"
+#include "../lora/RadioDriver.h"
+
+/**
+ * Contrôle de puissance d'émission en boucle fermée, par pair
+ *
+ * Le pair renvoie dans ses heartbeats le RSSI auquel il reçoit nos trames.
+ * Marge de lien = RSSI rapporté - sensibilité au débit courant :
+ *  - descente d'un cran si la marge reste >= TARGET_MARGIN_DB une fois le cran retiré,
+ *    après REPORTS_PER_STEP retours mesurés à la puissance courante
+ *  - montée d'un cran dès qu'un retour passe sous TARGET_MARGIN_DB
+ *  - retour immédiat à la puissance nominale (back-off rapide) sur un fragment
+ *    abandonné ou BACKOFF_RETRANSMISSIONS retransmissions entre deux retours
+ * Pair hors ligne ou non appairé : puissance nominale (beacons et appairage à pleine portée).
+ *
+ * La puissance retenue est mémorisée par pair (MAX_PEERS entrées) et rétablie
+ * quand le pair appairé redevient le destinataire.
+ */
+template <class Radio>
+class TransmitPowerController {
+public:
+	static const uint8_t MAX_PEERS = 4;
+	static const int TARGET_MARGIN_DB = 10;
+	static const uint8_t REPORTS_PER_STEP = 2;
+	static const uint8_t BACKOFF_RETRANSMISSIONS = 2;
+	
+	TransmitPowerController(Radio* lora, FragmentManager<Radio>* fragment, HeartbeatManager<Radio>* heartbeat);
+	
+	void setEnabled(bool on);
+	bool isEnabled() const { return enabled; }
+	
+	// À appeler à chaque tour de loop()
+	void process(bool isPaired, bool peerOnline, uint32_t peerId);
+	
+	void printStatus() const;
+	
+private:
+	struct PeerPower {
+		uint32_t id;
+		uint8_t powerIndex;
+		unsigned long lastUsedMs;
+	};
+	
+	Radio* lora;
+	FragmentManager<Radio>* fragment;
+	HeartbeatManager<Radio>* heartbeat;
+	
+	bool enabled;
+	PeerPower peers[MAX_PEERS];
+	uint8_t peerCount;
+	uint32_t currentPeer;
+	uint8_t reportsSinceChange;
+	int lastReportedRssi;
+	int lastMarginDb;
+	LinkStats snapshot;
+	uint32_t backoffCount;
+	
+	void applyPower(uint8_t index, const char* reason);
+	void selectPeer(uint32_t peerId);
+	void rememberPeer();
+	void onRssiReport(int rssi);
+};
+
+#endif // TRANSMIT_POWER_CONTROLLER_H
@@ -1,10 +1,19 @@
 #include "DiscoveryManager.h"
+#ifdef RADIO_SIM
+#include "../sim/SimRadio.h"
+#else
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#endif
+#include "../utils/Log.h"
 
-DiscoveryManager::DiscoveryManager(LoRaModule* lora)
-	: lora(lora), pairingMode(false), lastBeaconMs(0), lastDiscoveryPrintMs(0) {
+template <class Radio>
+DiscoveryManager<Radio>::DiscoveryManager(Radio* lora)
+	: lora(lora), linkQuality(nullptr), pairingMode(false), lastBeaconMs(0), lastDiscoveryPrintMs(0) {
 }
 
-void DiscoveryManager::upsertDiscovered(uint32_t id, int rssi, float snr) {
+template <class Radio>
+void DiscoveryManager<Radio>::upsertDiscovered(uint32_t id, int rssi, float snr) {
 	bool found = false;
 	for (auto &d : discovered) {
 		if (d.id == id) {
@@ -21,7 +30,8 @@ void DiscoveryManager::upsertDiscovered(uint32_t id, int rssi, float snr) {
 	}
 }
 
-void DiscoveryManager::purgeDiscovered() {
+template <class Radio>
+void DiscoveryManager<Radio>::purgeDiscovered() {
 	const unsigned long now = millis();
 	std::vector<DiscoveredDevice> keep;
 	keep.reserve(discovered.size());
@@ -33,7 +43,8 @@ void DiscoveryManager::purgeDiscovered() {
 	discovered.swap(keep);
 }
 
-void DiscoveryManager::sendBeaconIfDue(uint32_t deviceId) {
+template <class Radio>
+void DiscoveryManager<Radio>::sendBeaconIfDue(uint32_t deviceId) {
 	if (!pairingMode) return;
 	
 	const unsigned long now = millis();
@@ -49,10 +60,11 @@ void DiscoveryManager::sendBeaconIfDue(uint32_t deviceId) {
 	pkt.push_back((deviceId >> 8) & 0xFF);
 	pkt.push_back(deviceId & 0xFF);
 	
-	lora->sendPacket(pkt);
+	lora->sendPacket(pkt, TX_PRIO_LOW);
 }
 
-bool DiscoveryManager::handleBeacon(const std::vector<uint8_t>& packet, uint32_t deviceId) {
+template <class Radio>
+bool DiscoveryManager<Radio>::handleBeacon(const ByteView& packet, uint32_t deviceId) {
 	if (packet.size() < 1 + 4) {
 		return false;
 	}
@@ -64,16 +76,31 @@ bool DiscoveryManager::handleBeacon(const std::vector<uint8_t>& packet, uint32_t
 		return false; // Beacon de nous-même, ignorer
 	}
 	
-	// RSSI désactivé temporairement
-	upsertDiscovered(id, -100, 0.0);
+	const int rssi = lora->getLastRssi();
+	const float snr = lora->getLastSnr();
 	
+	if (linkQuality) {
+		// Beacons périodiques : un trou dans la série = beacons perdus
+		for (const auto &d : discovered) {
+			if (d.id == id) {
+				linkQuality->recordLoss(id, LinkQualityTable::missedSince(d.lastSeenMs, millis(),
+				                                                          BEACON_INTERVAL_MS, DISCOVERY_TTL_MS));
+				break;
+			}
+		}
+		linkQuality->recordRx(id, rssi, snr, lora->hasSnr());
+	}
+	upsertDiscovered(id, rssi, snr);
+	
+	LogSerialLock lock;
 	Serial.print("[BEACON] Device ajouté/mis à jour: 0x");
 	Serial.println(id, HEX);
 	
 	return true;
 }
 
-void DiscoveryManager::printDiscoveredIfDue() {
+template <class Radio>
+void DiscoveryManager<Radio>::printDiscoveredIfDue() {
 	if (!pairingMode) return;
 	
 	const unsigned long now = millis();
@@ -82,6 +109,7 @@ void DiscoveryManager::printDiscoveredIfDue() {
 	lastDiscoveryPrintMs = now;
 	purgeDiscovered();
 	
+	LogSerialLock lock;
 	Serial.println("[PAIR] Devices en mode pairing détectés:");
 	if (discovered.empty()) {
 		Serial.println("  (aucun)");
@@ -95,10 +123,24 @@ void DiscoveryManager::printDiscoveredIfDue() {
 	for (auto &d : discovered) {
 		Serial.print("  0x");
 		Serial.print(d.id, HEX);
-		Serial.print(" | RSSI/SNR: N/A");
+		Serial.print(" | RSSI: ");
+		Serial.print(d.rssi);
+		Serial.print(" dBm");
+		if (lora->hasSnr()) {
+			Serial.print(" | SNR: ");
+			Serial.print(d.snr, 1);
+			Serial.print(" dB");
+		}
 		Serial.print(" | Vu il y a ");
 		Serial.print((now - d.lastSeenMs) / 1000);
 		Serial.println("s");
 	}
 }
 
+// Instanciations explicites : une par driver radio
+#ifdef RADIO_SIM
+template class DiscoveryManager<SimRadio>;
+#else
+template class DiscoveryManager<LoRaModule>;
+template class DiscoveryManager<XL1278Module>;
+#endif
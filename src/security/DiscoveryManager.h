@@ -6,7 +6,8 @@
 #include <cstdint>
 #include "../Config.h"
 #include "../protocol/PacketTypes.h"
-#include "../lora/LoRaModule.h"
+#include "../lora/RadioDriver.h"
+#include "../utils/LinkQualityTable.h"
 
 struct DiscoveredDevice {
 	uint32_t id;
@@ -15,12 +16,16 @@ struct DiscoveredDevice {
 	unsigned long lastSeenMs;
 };
 
+template <class Radio>
 class DiscoveryManager {
 public:
 	// Utilise les constantes de Config.h : BEACON_INTERVAL_MS, DISCOVERY_DISPLAY_MS, DISCOVERY_TTL_MS
 	static const unsigned long DISCOVERY_PRINT_INTERVAL_MS = DISCOVERY_DISPLAY_MS;
 	
-	DiscoveryManager(LoRaModule* lora);
+	DiscoveryManager(Radio* lora);
+	
+	// Optionnel : alimente la table de qualité de lien à chaque beacon
+	void setLinkQualityTable(LinkQualityTable* table) { linkQuality = table; }
 	
 	// Gestion du mode pairing
 	void setPairingMode(bool enabled) { pairingMode = enabled; }
@@ -30,7 +35,7 @@ public:
 	void sendBeaconIfDue(uint32_t deviceId);
 	
 	// Réception de beacons
-	bool handleBeacon(const std::vector<uint8_t>& packet, uint32_t deviceId);
+	bool handleBeacon(const ByteView& packet, uint32_t deviceId);
 	
 	// Affichage des devices découverts
 	void printDiscoveredIfDue();
@@ -39,7 +44,8 @@ public:
 	const std::vector<DiscoveredDevice>& getDiscoveredDevices() const { return discovered; }
 	
 private:
-	LoRaModule* lora;
+	Radio* lora;
+	LinkQualityTable* linkQuality;
 	bool pairingMode;
 	unsigned long lastBeaconMs;
 	unsigned long lastDiscoveryPrintMs;
@@ -1,6 +1,14 @@
 #include "PairingManager.h"
+#ifdef RADIO_SIM
+#include "../sim/SimRadio.h"
+#else
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#endif
+#include "../utils/Log.h"
 
-PairingManager::PairingManager(SecurityManager* security, LoRaModule* lora, NVSManager* nvs)
+template <class Radio>
+PairingManager<Radio>::PairingManager(SecurityManager* security, Radio* lora, NVSManager* nvs)
 	: security(security), lora(lora), nvs(nvs), paired(false), pairedDeviceId(0),
 	  pendingBind(false), pendingInitiatorId(0), deviceId(0) {
 	memset(sessionKey, 0, 16);
@@ -9,22 +17,43 @@ PairingManager::PairingManager(SecurityManager* security, LoRaModule* lora, NVSM
 	memset(pendingNonceI, 0, 16);
 }
 
-bool PairingManager::loadPairingState() {
-	return nvs->loadPairingState(sessionKey, 16, paired);
+template <class Radio>
+void PairingManager<Radio>::updatePeerAddress() {
+	// Pair inconnu (non appairé, ou ID non encore revu depuis le démarrage) : broadcast
+	lora->setPeerAddress(paired && pairedDeviceId != 0 ? radioAddressOf(pairedDeviceId) : RADIO_ADDR_BROADCAST);
 }
 
-bool PairingManager::savePairingState() {
+template <class Radio>
+void PairingManager<Radio>::notePairedDeviceId(uint32_t id) {
+	if (!paired || id == 0 || id == pairedDeviceId) return;
+	pairedDeviceId = id;
+	updatePeerAddress();
+}
+
+template <class Radio>
+bool PairingManager<Radio>::loadPairingState() {
+	const bool ok = nvs->loadPairingState(sessionKey, 16, paired);
+	// ID du pair non persisté : broadcast jusqu'au premier heartbeat reçu
+	updatePeerAddress();
+	return ok;
+}
+
+template <class Radio>
+bool PairingManager<Radio>::savePairingState() {
 	return nvs->savePairingState(sessionKey, 16, paired);
 }
 
-bool PairingManager::clearPairingState() {
+template <class Radio>
+bool PairingManager<Radio>::clearPairingState() {
 	paired = false;
 	memset(sessionKey, 0, 16);
 	pairedDeviceId = 0;
+	updatePeerAddress();
 	return nvs->clearPairingState();
 }
 
-bool PairingManager::sendBindRequest(uint32_t targetId) {
+template <class Radio>
+bool PairingManager<Radio>::sendBindRequest(uint32_t targetId) {
 	security->generateRandomBytes(nonceInitiator, 16);
 	
 	std::vector<uint8_t> pubI;
@@ -50,12 +79,14 @@ bool PairingManager::sendBindRequest(uint32_t targetId) {
 	pkt.push_back((uint8_t)pubI.size());
 	pkt.insert(pkt.end(), pubI.begin(), pubI.end());
 	
-	lora->sendPacket(pkt);
+	lora->sendPacket(pkt, TX_PRIO_HIGH, radioAddressOf(targetId));
+	LogSerialLock lock;
 	Serial.print("[BIND] REQ -> "); Serial.println(targetId, HEX);
 	return true;
 }
 
-void PairingManager::sendBindResponse(uint32_t initiatorId, const std::vector<uint8_t>& pubI) {
+template <class Radio>
+void PairingManager<Radio>::sendBindResponse(uint32_t initiatorId, const std::vector<uint8_t>& pubI) {
 	security->generateRandomBytes(nonceResponder, 16);
 	
 	std::vector<uint8_t> pubR;
@@ -105,11 +136,13 @@ void PairingManager::sendBindResponse(uint32_t initiatorId, const std::vector<ui
 	pkt.insert(pkt.end(), pubR.begin(), pubR.end());
 	pkt.insert(pkt.end(), mac16, mac16 + 16);
 	
-	lora->sendPacket(pkt);
+	lora->sendPacket(pkt, TX_PRIO_HIGH, radioAddressOf(initiatorId));
+	LogSerialLock lock;
 	Serial.print("[BIND] RESP -> "); Serial.println(initiatorId, HEX);
 }
 
-void PairingManager::sendBindConfirm(const std::vector<uint8_t>& pubI, const std::vector<uint8_t>& pubR) {
+template <class Radio>
+void PairingManager<Radio>::sendBindConfirm(const std::vector<uint8_t>& pubI, const std::vector<uint8_t>& pubR) {
 	std::vector<uint8_t> shared;
 	if (!security->computeSharedSecret(pubR.data(), pubR.size(), shared)) {
 		Serial.println("[BIND] Echec ECDH confirm");
@@ -137,11 +170,12 @@ void PairingManager::sendBindConfirm(const std::vector<uint8_t>& pubI, const std
 	pkt.push_back((uint8_t)PKT_BIND_CONFIRM);
 	pkt.insert(pkt.end(), mac16, mac16 + 16);
 	
-	lora->sendPacket(pkt);
+	lora->sendPacket(pkt, TX_PRIO_HIGH, lora->getPeerAddress());
 	Serial.println("[BIND] CONF sent");
 }
 
-bool PairingManager::acceptPendingBind() {
+template <class Radio>
+bool PairingManager<Radio>::acceptPendingBind() {
 	if (!pendingBind) {
 		Serial.println("[BIND] Rien à accepter.");
 		return false;
@@ -153,12 +187,14 @@ bool PairingManager::acceptPendingBind() {
 	return true;
 }
 
-void PairingManager::cancelPendingBind() {
+template <class Radio>
+void PairingManager<Radio>::cancelPendingBind() {
 	pendingBind = false;
 	Serial.println("[BIND] Annulé.");
 }
 
-bool PairingManager::handleBindRequest(const std::vector<uint8_t>& packet) {
+template <class Radio>
+bool PairingManager<Radio>::handleBindRequest(const ByteView& packet) {
 	// type | targetId(4) | initiatorId(4) | nonceI(16) | pubLen(1) | pub
 	if (packet.size() < 1 + 4 + 4 + 16 + 1) return false;
 	
@@ -178,12 +214,14 @@ bool PairingManager::handleBindRequest(const std::vector<uint8_t>& packet) {
 	                  packet.begin() + (1 + 4 + 4 + 16 + 1 + pubLen));
 	pendingBind = true;
 	
+	LogSerialLock lock;
 	Serial.print("[BIND] REQ de "); Serial.print(initId, HEX);
 	Serial.println(". Tapez 'A' pour accepter.");
 	return true;
 }
 
-bool PairingManager::handleBindResponse(const std::vector<uint8_t>& packet) {
+template <class Radio>
+bool PairingManager<Radio>::handleBindResponse(const ByteView& packet) {
 	// type | initiatorId(4) | responderId(4) | nonceR(16) | pubLen(1) | pubR | mac16
 	if (packet.size() < 1 + 4 + 4 + 16 + 1 + 16) return false;
 	
@@ -243,14 +281,17 @@ bool PairingManager::handleBindResponse(const std::vector<uint8_t>& packet) {
 	memcpy(sessionKey, tempKey, 16);
 	paired = true;
 	pairedDeviceId = respId;
+	updatePeerAddress();
 	savePairingState();
 	
+	LogSerialLock lock;
 	Serial.print("[BIND] Etabli avec "); Serial.println(respId, HEX);
 	sendBindConfirm(pubI, pubR);
 	return true;
 }
 
-bool PairingManager::handleBindConfirm(const std::vector<uint8_t>& packet) {
+template <class Radio>
+bool PairingManager<Radio>::handleBindConfirm(const ByteView& packet) {
 	// type | mac16
 	if (packet.size() < 1 + 16) return false;
 	
@@ -295,11 +336,20 @@ bool PairingManager::handleBindConfirm(const std::vector<uint8_t>& packet) {
 	memcpy(sessionKey, tempKey, 16);
 	paired = true;
 	pairedDeviceId = pendingInitiatorId;
+	updatePeerAddress();
 	savePairingState();
 	pendingBind = false;
 	
+	LogSerialLock lock;
 	Serial.print("[BIND] Appairage terminé (répondeur) avec 0x");
 	Serial.println(pendingInitiatorId, HEX);
 	return true;
 }
 
+// Instanciations explicites : une par driver radio
+#ifdef RADIO_SIM
+template class PairingManager<SimRadio>;
+#else
+template class PairingManager<LoRaModule>;
+template class PairingManager<XL1278Module>;
+#endif
@@ -6,12 +6,13 @@
 #include <cstdint>
 #include "PacketTypes.h"
 #include "SecurityManager.h"
-#include "LoRaModule.h"
+#include "../lora/RadioDriver.h"
 #include "NVSManager.h"
 
+template <class Radio>
 class PairingManager {
 public:
-	PairingManager(SecurityManager* security, LoRaModule* lora, NVSManager* nvs);
+	PairingManager(SecurityManager* security, Radio* lora, NVSManager* nvs);
 	
 	// Gestion de l'état d'appairage
 	bool isPaired() const { return paired; }
@@ -35,16 +36,20 @@ public:
 	uint32_t getPendingInitiatorId() const { return pendingInitiatorId; }
 	
 	// Traitement des paquets d'appairage
-	bool handleBindRequest(const std::vector<uint8_t>& packet);
-	bool handleBindResponse(const std::vector<uint8_t>& packet);
-	bool handleBindConfirm(const std::vector<uint8_t>& packet);
+	bool handleBindRequest(const ByteView& packet);
+	bool handleBindResponse(const ByteView& packet);
+	bool handleBindConfirm(const ByteView& packet);
+	
+	// Pair identifié après coup (heartbeat authentifié, ex. après redémarrage) :
+	// les envois unicast lui sont alors adressés
+	void notePairedDeviceId(uint32_t id);
 	
 	// Configuration
 	void setDeviceId(uint32_t id) { deviceId = id; }
 	
 private:
 	SecurityManager* security;
-	LoRaModule* lora;
+	Radio* lora;
 	NVSManager* nvs;
 	
 	bool paired;
@@ -69,6 +74,7 @@ private:
 	
 	void sendBindResponse(uint32_t initiatorId, const std::vector<uint8_t>& pubI);
 	void sendBindConfirm(const std::vector<uint8_t>& pubI, const std::vector<uint8_t>& pubR);
+	void updatePeerAddress();
 };
 
 #endif // PAIRING_MANAGER_H
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <HardwareSerial.h>
 #include "../Config.h"
+#include "../utils/Log.h"
 
 // ============================================
 // CAPTEUR HLK-LD2450 - CONFIGURATION
@@ -162,17 +163,11 @@ public:
                     totalFramesReceived++;
                     
                     // Debug: afficher la trame brute (une fois par seconde max)
-                    if (DEBUG_RAW_FRAMES && millis() - lastDebugTime >= 1000) {
+                    if (DEBUG_RAW_FRAMES && LOG_ENABLED(LOG_LEVEL_DEBUG, LOG_CAT_SENSOR) &&
+                        millis() - lastDebugTime >= 1000) {
                         lastDebugTime = millis();
-                        Serial.print("[DEBUG] Trame (");
-                        Serial.print(rxIndex);
-                        Serial.print(" bytes): ");
-                        for (int i = 0; i < rxIndex && i < 32; i++) {
-                            if (rxBuffer[i] < 0x10) Serial.print("0");
-                            Serial.print(rxBuffer[i], HEX);
-                            Serial.print(" ");
-                        }
-                        Serial.println();
+                        LOG_DEBUG(LOG_CAT_SENSOR, "[DEBUG] Trame (%u bytes): %h", rxIndex,
+                                  LogData(rxBuffer, rxIndex < 32 ? rxIndex : 32));
                     }
                     
                     // Vérifier le format de trame (30 bytes minimum)
@@ -192,7 +187,7 @@ public:
                 else if (rxIndex >= 64) {
                     // Buffer overflow, réinitialiser
                     if (DEBUG_RAW_FRAMES) {
-                        Serial.println("[DEBUG] Buffer overflow, trame trop longue");
+                        LOG_DEBUG(LOG_CAT_SENSOR, "[DEBUG] Buffer overflow, trame trop longue");
                     }
                     rxIndex = 0;
                     frameStarted = false;
@@ -203,13 +198,8 @@ public:
         // Afficher les stats toutes les 30 secondes
         if (millis() - lastStatsTime >= 30000 && totalFramesReceived > 0) {
             lastStatsTime = millis();
-            Serial.print("[SENSOR] Stats: ");
-            Serial.print(totalFramesValid);
-            Serial.print(" trames valides / ");
-            Serial.print(totalFramesReceived);
-            Serial.print(" reçues (");
-            Serial.print((totalFramesValid * 100) / totalFramesReceived);
-            Serial.println("%)");
+            LOG_INFO(LOG_CAT_SENSOR, "[SENSOR] Stats: %u trames valides / %u reçues (%u%%)",
+                     totalFramesValid, totalFramesReceived, (totalFramesValid * 100) / totalFramesReceived);
         }
     }
     
@@ -228,7 +218,7 @@ public:
         int dataOffset = 4;
         
 #if DEBUG_FILTERING
-        Serial.println("[SENSOR] === Parsing trame ===");
+        LOG_DEBUG(LOG_CAT_SENSOR, "[SENSOR] === Parsing trame ===");
 #endif
         
         for (int i = 0; i < 3; i++) {
@@ -279,25 +269,10 @@ public:
                 // Debug: afficher les détails du filtrage
 #if DEBUG_FILTERING
                 if (hasTarget) {
-                    Serial.print("[SENSOR] Cible ");
-                    Serial.print(i+1);
-                    Serial.print(": X=");
-                    Serial.print(targets[i].x);
-                    Serial.print("mm Y=");
-                    Serial.print(targets[i].y);
-                    Serial.print("mm dist=");
-                    Serial.print(distance / 10.0, 1);
-                    Serial.print("cm res=");
-                    Serial.print(targets[i].resolution);
-                    Serial.print("mm");
-                    
-                    if (!inPhysicalRange) {
-                        Serial.println(" ❌ REJETÉE (hors plage ±6m)");
-                    } else if (!inDetectionRange) {
-                        Serial.println(" ❌ REJETÉE (distance < 1cm ou > 6m)");
-                    } else {
-                        Serial.println(" ✓ VALIDE");
-                    }
+                    const char* verdict = !inPhysicalRange ? "❌ REJETÉE (hors plage ±6m)" :
+                                          !inDetectionRange ? "❌ REJETÉE (distance < 1cm ou > 6m)" : "✓ VALIDE";
+                    LOG_DEBUG(LOG_CAT_SENSOR, "[SENSOR] Cible %d: X=%dmm Y=%dmm dist=%.1fcm res=%umm %s",
+                              i + 1, targets[i].x, targets[i].y, distance / 10.0, targets[i].resolution, verdict);
                 } else {
                     // X=0 ET Y=0 = pas de cible
                 }
@@ -318,30 +293,20 @@ public:
             lastHumanCount = newCount;
             humanDetected = (newCount > 0);
             
-            Serial.print("[SENSOR] ⚡ Détection: ");
-            Serial.print(newCount);
-            Serial.println(newCount > 1 ? " humains détectés !" : (newCount == 1 ? " humain détecté" : " aucun humain"));
+            LOG_INFO(LOG_CAT_SENSOR, "[SENSOR] ⚡ Détection: %u %s", newCount,
+                     newCount > 1 ? "humains détectés !" : (newCount == 1 ? "humain détecté" : "aucun humain"));
             
             // Afficher les détails de chaque cible
             for (int i = 0; i < 3; i++) {
                 if (targets[i].valid) {
-                    Serial.print("[SENSOR]   └─ Cible ");
-                    Serial.print(i + 1);
-                    Serial.print(": X=");
-                    Serial.print(targets[i].x);
-                    Serial.print("mm, Y=");
-                    Serial.print(targets[i].y);
-                    Serial.print("mm (");
-                    Serial.print(sqrt(targets[i].x * targets[i].x + targets[i].y * targets[i].y) / 10.0, 1);
-                    Serial.print("cm)");
-                    
+                    const float distCm = sqrt(targets[i].x * targets[i].x + targets[i].y * targets[i].y) / 10.0;
                     if (targets[i].speed != 0) {
-                        Serial.print(", vitesse=");
-                        Serial.print(targets[i].speed);
-                        Serial.print("cm/s");
+                        LOG_INFO(LOG_CAT_SENSOR, "[SENSOR]   └─ Cible %d: X=%dmm, Y=%dmm (%.1fcm), vitesse=%dcm/s",
+                                 i + 1, targets[i].x, targets[i].y, distCm, targets[i].speed);
+                    } else {
+                        LOG_INFO(LOG_CAT_SENSOR, "[SENSOR]   └─ Cible %d: X=%dmm, Y=%dmm (%.1fcm)",
+                                 i + 1, targets[i].x, targets[i].y, distCm);
                     }
-                    
-                    Serial.println();
                 }
             }
         }
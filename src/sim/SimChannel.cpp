@@ -0,0 +1,179 @@
+#include "../sim/SimChannel.h"
+#include "../sim/SimRadio.h"
+#include "../sim/SimContext.h"
+
+static const float DEFAULT_PATH_LOSS_DB = 100.0f;
+
+SimChannel::SimChannel(uint32_t seed)
+	: pathLossDb((size_t)MAX_RADIOS * MAX_RADIOS, DEFAULT_PATH_LOSS_DB),
+	  lossProbability(0.0f), corruptProbability(0.0f), fadingSigmaDb(2.0f), rng(seed) {
+	memset(&stats, 0, sizeof(stats));
+}
+
+uint8_t SimChannel::attach(SimRadio* radio) {
+	if (radios.size() >= MAX_RADIOS) return SIM_NO_NODE;
+	radios.push_back(radio);
+	return (uint8_t)(radios.size() - 1);
+}
+
+bool SimChannel::reattach(uint8_t index, SimRadio* radio) {
+	if (index >= radios.size()) return false;
+	radios[index] = radio;
+	return true;
+}
+
+void SimChannel::setPathLossDb(uint8_t a, uint8_t b, float lossDb) {
+	if (a >= MAX_RADIOS || b >= MAX_RADIOS) return;
+	pathLossDb[(size_t)a * MAX_RADIOS + b] = lossDb;
+	pathLossDb[(size_t)b * MAX_RADIOS + a] = lossDb;
+}
+
+float SimChannel::getPathLossDb(uint8_t a, uint8_t b) const {
+	if (a >= MAX_RADIOS || b >= MAX_RADIOS) return DEFAULT_PATH_LOSS_DB;
+	return pathLossDb[(size_t)a * MAX_RADIOS + b];
+}
+
+float SimChannel::uniform() {
+	return std::uniform_real_distribution<float>(0.0f, 1.0f)(rng);
+}
+
+void SimChannel::transmit(uint8_t from, const uint8_t* data, size_t len, uint16_t dest,
+                          uint8_t rateIndex, int powerDbm, uint32_t airtimeUs) {
+	// Trames terminées avant ce début : à remettre d'abord (ordre des remises)
+	deliverDue();
+	
+	Transmission tx;
+	tx.from = from;
+	tx.dest = dest;
+	tx.rateIndex = rateIndex;
+	tx.delivered = false;
+	tx.startUs = SimContext::nowUs();
+	tx.endUs = tx.startUs + airtimeUs;
+	tx.data.assign(data, data + len);
+	tx.rssiDbm.resize(radios.size());
+	
+	std::normal_distribution<float> fading(0.0f, fadingSigmaDb);
+	for (uint8_t rx = 0; rx < radios.size(); rx++) {
+		if (rx == from) continue;
+		const float jitter = fadingSigmaDb > 0.0f ? fading(rng) : 0.0f;
+		tx.rssiDbm[rx] = (float)powerDbm - getPathLossDb(from, rx) + jitter;
+	}
+	
+	transmissions.push_back(tx);
+	stats.framesSent++;
+}
+
+void SimChannel::deliverDue() {
+	const uint64_t now = SimContext::nowUs();
+	// Ordre de fin d'émission : les trames sont empilées par ordre de début,
+	// une trame courte peut finir avant une longue commencée plus tôt
+	bool pending = true;
+	while (pending) {
+		pending = false;
+		Transmission* next = nullptr;
+		for (size_t i = 0; i < transmissions.size(); i++) {
+			Transmission& tx = transmissions[i];
+			if (tx.delivered || tx.endUs > now) continue;
+			if (!next || tx.endUs < next->endUs) next = &tx;
+		}
+		if (next) {
+			next->delivered = true;
+			for (uint8_t rx = 0; rx < radios.size(); rx++) {
+				if (rx != next->from) deliverTo(*next, rx);
+			}
+			pending = true;
+		}
+	}
+	prune();
+}
+
+void SimChannel::deliverTo(Transmission& tx, uint8_t rx) {
+	SimRadio* radio = radios[rx];
+	
+	if (radio->getRateIndex() != tx.rateIndex) {
+		stats.rateMismatch++;
+		return;
+	}
+	
+	const float rssi = tx.rssiDbm[rx];
+	if (rssi < (float)radio->getSensitivityDbm()) {
+		stats.belowSensitivity++;
+		return;
+	}
+	
+	for (size_t i = 0; i < transmissions.size(); i++) {
+		const Transmission& other = transmissions[i];
+		if (&other == &tx || !overlaps(tx, other)) continue;
+		if (other.from == rx) {
+			stats.halfDuplex++;
+			return;
+		}
+		if (other.rateIndex != tx.rateIndex) continue;
+		if (other.rssiDbm[rx] > rssi - (float)CAPTURE_THRESHOLD_DB) {
+			stats.collisions++;
+			return;
+		}
+	}
+	
+	if (lossProbability > 0.0f && uniform() < lossProbability) {
+		stats.randomLoss++;
+		return;
+	}
+	
+	if (!radio->acceptsAddress(tx.dest)) {
+		stats.addressFiltered++;
+		return;
+	}
+	
+	// Horodatage dans l'horloge du récepteur (millis() depuis son démarrage)
+	const uint32_t timestampMs = (uint32_t)((tx.endUs - SimContext::bootUsOf(rx)) / 1000ULL);
+	if (corruptProbability > 0.0f && uniform() < corruptProbability) {
+		std::vector<uint8_t> damaged(tx.data);
+		const size_t bit = std::uniform_int_distribution<size_t>(0, damaged.size() * 8 - 1)(rng);
+		damaged[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+		if (radio->deliver(damaged.data(), damaged.size(), (int)lroundf(rssi), timestampMs)) {
+			stats.corrupted++;
+		} else {
+			stats.rxOverflow++;
+		}
+		return;
+	}
+	
+	if (radio->deliver(tx.data.data(), tx.data.size(), (int)lroundf(rssi), timestampMs)) {
+		stats.delivered++;
+	} else {
+		stats.rxOverflow++;
+	}
+}
+
+void SimChannel::prune() {
+	// Une trame remise reste utile tant qu'elle peut encore chevaucher une trame
+	// non remise (les émissions futures commencent au plus tôt maintenant)
+	uint64_t horizonUs = SimContext::nowUs();
+	for (size_t i = 0; i < transmissions.size(); i++) {
+		if (!transmissions[i].delivered && transmissions[i].startUs < horizonUs) {
+			horizonUs = transmissions[i].startUs;
+		}
+	}
+	for (size_t i = 0; i < transmissions.size(); ) {
+		if (transmissions[i].delivered && transmissions[i].endUs <= horizonUs) {
+			transmissions.erase(transmissions.begin() + i);
+		} else {
+			i++;
+		}
+	}
+}
+
+void SimChannel::printStats() const {
+	Serial.println("[SIM] Canal :");
+	Serial.print("  Trames émises        : "); Serial.println(stats.framesSent);
+	Serial.print("  Remises              : "); Serial.println(stats.delivered);
+	Serial.print("  Remises corrompues   : "); Serial.println(stats.corrupted);
+	Serial.print("  Sous la sensibilité  : "); Serial.println(stats.belowSensitivity);
+	Serial.print("  Collisions           : "); Serial.println(stats.collisions);
+	Serial.print("  Half-duplex          : "); Serial.println(stats.halfDuplex);
+	Serial.print("  Pertes aléatoires    : "); Serial.println(stats.randomLoss);
+	Serial.print("  Autre débit          : "); Serial.println(stats.rateMismatch);
+	Serial.print("  Filtrées (adresse)   : "); Serial.println(stats.addressFiltered);
+	Serial.print("  File RX pleine       : "); Serial.println(stats.rxOverflow);
+}
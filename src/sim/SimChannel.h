@@ -0,0 +1,101 @@
+#ifndef SIM_CHANNEL_H
+#define SIM_CHANNEL_H
+
+#include <Arduino.h>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+class SimRadio;
+
+// Compteurs du canal simulé (une trame comptée une fois par récepteur)
+struct SimChannelStats {
+	uint32_t framesSent;
+	uint32_t delivered;
+	uint32_t corrupted;         // remises avec un bit inversé (rejet attendu par MAC/CRC applicatif)
+	uint32_t belowSensitivity;  // lien trop faible au débit du récepteur
+	uint32_t collisions;        // chevauchement sans capture
+	uint32_t halfDuplex;        // récepteur en émission pendant la trame
+	uint32_t randomLoss;        // perte tirée (lossProbability)
+	uint32_t rateMismatch;      // récepteur réglé sur un autre débit
+	uint32_t addressFiltered;   // trame adressée à un autre noeud (non comptée comme perte)
+	uint32_t rxOverflow;        // file RX du récepteur pleine
+};
+
+/**
+ * Canal radio partagé de la simulation hôte
+ *
+ * Chaque émission occupe le canal pendant son temps d'antenne (calculé par
+ * le driver au débit courant). À la fin de l'émission, la trame est remise à
+ * chaque récepteur qui :
+ *   - est réglé sur le même débit (les débits différents ne se voient pas),
+ *   - n'émettait pas lui-même pendant la trame (half-duplex),
+ *   - reçoit au-dessus de sa sensibilité : RSSI = puissance - affaiblissement
+ *     du lien + évanouissement gaussien tiré par trame,
+ *   - ne subit aucune trame concurrente au même débit à moins de
+ *     CAPTURE_THRESHOLD_DB (effet de capture LoRa : la plus forte survit),
+ *   - échappe à la perte aléatoire, puis au filtrage d'adresse du module.
+ * Une trame remise peut être corrompue (un bit inversé) avec corruptProbability.
+ */
+class SimChannel {
+public:
+	static const int CAPTURE_THRESHOLD_DB = 6;
+	static const uint8_t MAX_RADIOS = 32;
+	
+	explicit SimChannel(uint32_t seed);
+	
+	uint8_t attach(SimRadio* radio);
+	// Redémarrage d'un noeud : sa nouvelle radio reprend l'index (et les liens) de l'ancienne
+	bool reattach(uint8_t index, SimRadio* radio);
+	uint8_t getRadioCount() const { return (uint8_t)radios.size(); }
+	
+	// Affaiblissement (dB) du lien a <-> b, symétrique ; défaut 100 dB
+	void setPathLossDb(uint8_t a, uint8_t b, float lossDb);
+	float getPathLossDb(uint8_t a, uint8_t b) const;
+	
+	void setLossProbability(float p) { lossProbability = p; }
+	void setCorruptProbability(float p) { corruptProbability = p; }
+	void setFadingSigmaDb(float sigma) { fadingSigmaDb = sigma; }
+	
+	// Début d'émission (appelé par SimRadio::transmitFrame)
+	void transmit(uint8_t from, const uint8_t* data, size_t len, uint16_t dest,
+	              uint8_t rateIndex, int powerDbm, uint32_t airtimeUs);
+	
+	// Remet les trames dont l'émission est terminée au temps virtuel courant
+	void deliverDue();
+	
+	const SimChannelStats& getStats() const { return stats; }
+	void printStats() const;
+	
+private:
+	struct Transmission {
+		uint8_t from;
+		uint16_t dest;
+		uint8_t rateIndex;
+		bool delivered;
+		uint64_t startUs;
+		uint64_t endUs;
+		std::vector<uint8_t> data;
+		std::vector<float> rssiDbm;  // RSSI vu par chaque radio (tiré au début de la trame)
+	};
+	
+	std::vector<SimRadio*> radios;
+	std::vector<float> pathLossDb;   // matrice MAX_RADIOS x MAX_RADIOS
+	std::vector<Transmission> transmissions;
+	
+	float lossProbability;
+	float corruptProbability;
+	float fadingSigmaDb;
+	
+	std::mt19937 rng;
+	SimChannelStats stats;
+	
+	static bool overlaps(const Transmission& a, const Transmission& b) {
+		return a.startUs < b.endUs && b.startUs < a.endUs;
+	}
+	float uniform();
+	void deliverTo(Transmission& tx, uint8_t rx);
+	void prune();
+};
+
+#endif // SIM_CHANNEL_H
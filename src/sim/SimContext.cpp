@@ -0,0 +1,70 @@
+#include "../sim/SimContext.h"
+#include <cstdio>
+#include <string>
+
+uint64_t SimContext::clockUs = 0;
+uint64_t SimContext::bootUs[SIM_MAX_NODES];
+uint8_t SimContext::node = SIM_NO_NODE;
+SimContext::DelayHook SimContext::delayHook = nullptr;
+uint32_t SimContext::rngState = 0x12345678;
+bool SimContext::verbose = true;
+
+// Une ligne en cours par noeud : un log coupé par un delay() ne se mélange pas
+// avec ceux des noeuds qui tournent pendant l'attente
+// (dernier tampon pour le code hors noeud)
+static const uint8_t LINE_BUFFER_COUNT = SIM_MAX_NODES + 1;
+static std::string lineBuffers[LINE_BUFFER_COUNT];
+
+static uint8_t bufferIndex(uint8_t node) {
+	return node == SIM_NO_NODE ? LINE_BUFFER_COUNT - 1 : (uint8_t)(node % (LINE_BUFFER_COUNT - 1));
+}
+
+void SimContext::delayMs(unsigned long ms) {
+	if (delayHook) {
+		delayHook(ms);
+	} else {
+		clockUs += (uint64_t)ms * 1000ULL;
+	}
+}
+
+void SimContext::seed(uint32_t value) {
+	rngState = value ? value : 0x12345678;
+}
+
+uint32_t SimContext::random32() {
+	// xorshift32 : suffisant pour les nonces/IV simulés, reproductible
+	uint32_t x = rngState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	rngState = x;
+	return x;
+}
+
+void SimContext::write(const char* text, size_t len) {
+	const uint8_t index = bufferIndex(node);
+	for (size_t i = 0; i < len; i++) {
+		if (text[i] == '\n') {
+			emitLine(index);
+		} else if (text[i] != '\r') {
+			lineBuffers[index] += text[i];
+		}
+	}
+}
+
+void SimContext::flush() {
+	for (uint8_t i = 0; i < LINE_BUFFER_COUNT; i++) {
+		if (!lineBuffers[i].empty()) emitLine(i);
+	}
+	fflush(stdout);
+}
+
+void SimContext::emitLine(uint8_t index) {
+	std::string& line = lineBuffers[index];
+	if (index == bufferIndex(SIM_NO_NODE)) {
+		printf("%s\n", line.c_str());
+	} else if (verbose) {
+		printf("[%10.3f] n%u %s\n", (double)clockUs / 1e6, (unsigned)index, line.c_str());
+	}
+	line.clear();
+}
@@ -0,0 +1,61 @@
+#ifndef SIM_CONTEXT_H
+#define SIM_CONTEXT_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Code hors noeud (scénario, rapport) : logs toujours affichés, sans préfixe de noeud
+static const uint8_t SIM_NO_NODE = 0xFF;
+static const uint8_t SIM_MAX_NODES = 32;
+
+/**
+ * État global de la simulation hôte, vu par les shims Arduino (sim/host)
+ *
+ * - temps virtuel en microsecondes, seul le simulateur le fait avancer ;
+ *   millis()/micros() lisent le temps depuis le démarrage du noeud courant,
+ *   comme sur l'ESP32 (échéanciers des managers décalés d'un noeud à l'autre)
+ * - noeud courant : préfixe des logs, espace NVS et adresse MAC du noeud
+ *   dont le code s'exécute
+ * - delay() : rendu au simulateur (SimFleet), qui fait avancer le temps en
+ *   faisant tourner les autres noeuds pendant l'attente
+ * - aléa déterministe (esp_random) : une même graine rejoue la même simulation
+ */
+class SimContext {
+public:
+	typedef void (*DelayHook)(unsigned long ms);
+	
+	static uint64_t nowUs() { return clockUs; }
+	static void advanceUs(uint64_t us) { clockUs += us; }
+	
+	// Instant de démarrage (temps virtuel) du noeud : origine de son millis()
+	static void setBootUs(uint8_t index, uint64_t us) { if (index < SIM_MAX_NODES) bootUs[index] = us; }
+	static uint64_t bootUsOf(uint8_t index) { return index < SIM_MAX_NODES ? bootUs[index] : 0; }
+	static uint64_t localUs() { return clockUs - bootUsOf(node); }
+	
+	static uint8_t currentNode() { return node; }
+	static void setCurrentNode(uint8_t index) { node = index; }
+	
+	static void setDelayHook(DelayHook hook) { delayHook = hook; }
+	static void delayMs(unsigned long ms);
+	
+	static void seed(uint32_t value);
+	static uint32_t random32();
+	
+	// Logs des noeuds : ligne complète préfixée du temps virtuel et du noeud.
+	// verbose = false : seuls les logs hors noeud (rapport) sont affichés.
+	static void setVerbose(bool on) { verbose = on; }
+	static void write(const char* text, size_t len);
+	static void flush();
+	
+private:
+	static uint64_t clockUs;
+	static uint64_t bootUs[SIM_MAX_NODES];
+	static uint8_t node;
+	static DelayHook delayHook;
+	static uint32_t rngState;
+	static bool verbose;
+	
+	static void emitLine(uint8_t index);
+};
+
+#endif // SIM_CONTEXT_H
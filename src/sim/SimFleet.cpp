@@ -0,0 +1,182 @@
+#include "../sim/SimFleet.h"
+#include "../sim/SimContext.h"
+#include <algorithm>
+
+SimFleet* SimFleet::active = nullptr;
+
+SimFleet::SimFleet(uint8_t nodeCount, uint32_t seed, uint16_t dutyCyclePermille)
+	: channel(seed), busy(nodeCount, false), booted(nodeCount, false) {
+	if (nodeCount > MAX_NODES) nodeCount = MAX_NODES;
+	SimContext::seed(seed);
+	for (uint8_t i = 0; i < nodeCount; i++) {
+		nodes.push_back(new SimNode(i, &channel, dutyCyclePermille));
+	}
+	active = this;
+	SimContext::setDelayHook(delayHook);
+}
+
+SimFleet::~SimFleet() {
+	SimContext::setDelayHook(nullptr);
+	active = nullptr;
+	for (size_t i = 0; i < nodes.size(); i++) {
+		delete nodes[i];
+	}
+}
+
+void SimFleet::placeInLine(float spacingM) {
+	for (uint8_t a = 0; a < nodes.size(); a++) {
+		for (uint8_t b = a + 1; b < nodes.size(); b++) {
+			float distanceM = spacingM * (float)(b - a);
+			if (distanceM < 1.0f) distanceM = 1.0f;
+			channel.setPathLossDb(a, b, PATH_LOSS_1M_DB + 10.0f * PATH_LOSS_EXPONENT * log10f(distanceM));
+		}
+	}
+}
+
+bool SimFleet::begin(unsigned long messageIntervalMs) {
+	// Démarrages étalés : tous au même instant, beacons et heartbeats partiraient
+	// en phase et les collisions semi-duplex fausseraient tout le bilan
+	std::vector<uint64_t> bootAtUs(nodes.size());
+	for (size_t i = 0; i < nodes.size(); i++) {
+		bootAtUs[i] = SimContext::nowUs() + (uint64_t)(SimContext::random32() % BOOT_SPREAD_MS) * 1000ULL;
+	}
+	// Les radios s'attachent au canal dans l'ordre des noeuds (index canal = index
+	// noeud) : instants triés, le noeud i démarre au i-ème
+	std::sort(bootAtUs.begin(), bootAtUs.end());
+	
+	for (size_t i = 0; i < nodes.size(); i++) {
+		while (SimContext::nowUs() < bootAtUs[i]) {
+			tick();
+		}
+		SimContext::setBootUs((uint8_t)i, SimContext::nowUs());
+		SimContext::setCurrentNode((uint8_t)i);
+		busy[i] = true;
+		const bool ok = nodes[i]->begin();
+		busy[i] = false;
+		if (!ok) {
+			SimContext::setCurrentNode(SIM_NO_NODE);
+			Serial.print("[SIM] ERREUR: Echec démarrage du noeud ");
+			Serial.println((unsigned int)i);
+			return false;
+		}
+		booted[i] = true;
+	}
+	
+	for (size_t i = 0; i + 1 < nodes.size(); i += 2) {
+		SimContext::setCurrentNode((uint8_t)i);
+		nodes[i]->setPartner(nodes[i + 1], true);
+		nodes[i]->setMessageIntervalMs(messageIntervalMs);
+		SimContext::setCurrentNode((uint8_t)(i + 1));
+		nodes[i + 1]->setPartner(nodes[i], false);
+		nodes[i + 1]->setMessageIntervalMs(messageIntervalMs);
+	}
+	SimContext::setCurrentNode(SIM_NO_NODE);
+	return true;
+}
+
+bool SimFleet::reboot() {
+	for (size_t i = 0; i < nodes.size(); i++) {
+		SimContext::setBootUs((uint8_t)i, SimContext::nowUs());
+		SimContext::setCurrentNode((uint8_t)i);
+		busy[i] = true;
+		const bool ok = nodes[i]->reboot();
+		busy[i] = false;
+		if (!ok) {
+			SimContext::setCurrentNode(SIM_NO_NODE);
+			Serial.print("[SIM] ERREUR: Echec redémarrage du noeud ");
+			Serial.println((unsigned int)i);
+			return false;
+		}
+	}
+	SimContext::setCurrentNode(SIM_NO_NODE);
+	return true;
+}
+
+void SimFleet::tick() {
+	const uint8_t caller = SimContext::currentNode();
+	channel.deliverDue();
+	for (uint8_t i = 0; i < nodes.size(); i++) {
+		if (busy[i] || !booted[i]) continue;
+		SimContext::setCurrentNode(i);
+		busy[i] = true;
+		nodes[i]->step();
+		busy[i] = false;
+	}
+	SimContext::setCurrentNode(caller);
+	SimContext::advanceUs(TICK_US);
+}
+
+void SimFleet::waitMs(unsigned long ms) {
+	// Un delay() imbriqué plus long peut faire dépasser l'échéance : le noeud
+	// reprend alors en retard, comme une tâche préemptée
+	const uint64_t untilUs = SimContext::nowUs() + (uint64_t)ms * 1000ULL;
+	while (SimContext::nowUs() < untilUs) {
+		tick();
+	}
+}
+
+void SimFleet::delayHook(unsigned long ms) {
+	if (active) {
+		active->waitMs(ms);
+	} else {
+		SimContext::advanceUs((uint64_t)ms * 1000ULL);
+	}
+}
+
+void SimFleet::run(unsigned long durationMs) {
+	const uint64_t untilUs = SimContext::nowUs() + (uint64_t)durationMs * 1000ULL;
+	while (SimContext::nowUs() < untilUs) {
+		tick();
+	}
+	SimContext::flush();
+}
+
+void SimFleet::printReport() {
+	SimContext::setCurrentNode(SIM_NO_NODE);
+	Serial.println();
+	Serial.print("[SIM] Bilan après ");
+	Serial.print(millis() / 1000.0, 1);
+	Serial.print(" s virtuelles, ");
+	Serial.print(nodes.size());
+	Serial.println(" noeuds");
+	
+	uint8_t pairedCount = 0;
+	LinkStats total;
+	memset(&total, 0, sizeof(total));
+	for (size_t i = 0; i < nodes.size(); i++) {
+		nodes[i]->printReport();
+		if (nodes[i]->isPaired()) pairedCount++;
+		const LinkStats& link = nodes[i]->getLinkStats();
+		total.fragmentsSent += link.fragmentsSent;
+		total.ackedFirstTry += link.ackedFirstTry;
+		total.ackedAfterRetry += link.ackedAfterRetry;
+		total.retransmissions += link.retransmissions;
+		total.failures += link.failures;
+		total.fecParitySent += link.fecParitySent;
+		total.fecRecovered += link.fecRecovered;
+		total.acksSent += link.acksSent;
+	}
+	channel.printStats();
+	
+	Serial.print("[SIM] Appairés: ");
+	Serial.print(pairedCount);
+	Serial.print("/");
+	Serial.print(nodes.size());
+	Serial.print(", fragments ");
+	Serial.print(total.fragmentsSent);
+	Serial.print(", ACK 1er essai ");
+	Serial.print(total.ackedFirstTry);
+	Serial.print(", après reprise ");
+	Serial.print(total.ackedAfterRetry);
+	Serial.print(", retransmissions ");
+	Serial.print(total.retransmissions);
+	Serial.print(", échecs ");
+	Serial.print(total.failures);
+	Serial.print(", parité FEC ");
+	Serial.print(total.fecParitySent);
+	Serial.print(", reconstruits ");
+	Serial.print(total.fecRecovered);
+	Serial.print(", ACK émis ");
+	Serial.println(total.acksSent);
+	SimContext::flush();
+}
@@ -0,0 +1,66 @@
+#ifndef SIM_FLEET_H
+#define SIM_FLEET_H
+
+#include <Arduino.h>
+#include <vector>
+#include "../Config.h"
+#include "../sim/SimChannel.h"
+#include "../sim/SimContext.h"
+#include "../sim/SimNode.h"
+
+/**
+ * Ordonnanceur de la simulation : N noeuds sur un canal commun, en temps virtuel
+ *
+ * Chaque pas (TICK_US) fait tourner une fois le script et la boucle de chaque
+ * noeud, puis avance l'horloge. Un delay() dans le code d'un noeud (attente
+ * d'ACK, vidage de file) fait avancer le temps pas à pas en continuant de faire
+ * tourner les autres noeuds ; le noeud en attente n'est pas ré-entré.
+ *
+ * Géométrie : noeuds alignés tous les spacingM mètres, affaiblissement
+ * log-distance PL(d) = PATH_LOSS_1M_DB + 10 * PATH_LOSS_EXPONENT * log10(d).
+ * Avec les valeurs par défaut, portée ~5 km à 22 dBm / 2.4 kbps : au-delà de
+ * 10 noeuds à 500 m, les extrémités ne s'entendent plus (noeuds cachés).
+ */
+class SimFleet {
+public:
+	static const uint32_t TICK_US = 1000;
+	static const uint8_t MAX_NODES = SIM_MAX_NODES;
+	// Démarrage de chaque noeud tiré dans [0, BOOT_SPREAD_MS) : une période de
+	// heartbeat, la plus longue des émissions périodiques
+	static const unsigned long BOOT_SPREAD_MS = HEARTBEAT_INTERVAL_MS;
+	static constexpr float PATH_LOSS_1M_DB = 40.0f;
+	static constexpr float PATH_LOSS_EXPONENT = 3.0f;
+	
+	SimFleet(uint8_t nodeCount, uint32_t seed, uint16_t dutyCyclePermille);
+	~SimFleet();
+	
+	SimChannel& getChannel() { return channel; }
+	uint8_t getNodeCount() const { return (uint8_t)nodes.size(); }
+	SimNode& getNode(uint8_t i) { return *nodes[i]; }
+	
+	// Affaiblissement de tous les liens selon la position des noeuds
+	void placeInLine(float spacingM);
+	
+	// Démarre les noeuds à des instants aléatoires et forme les couples (0,1), (2,3)...
+	bool begin(unsigned long messageIntervalMs);
+	
+	// Coupure d'alimentation de tous les noeuds au même instant (NVS conservée)
+	bool reboot();
+	
+	void run(unsigned long durationMs);
+	void printReport();
+	
+private:
+	SimChannel channel;
+	std::vector<SimNode*> nodes;
+	std::vector<bool> busy;    // noeud en cours d'exécution (dans un delay())
+	std::vector<bool> booted;  // begin() passé : le noeud tourne à chaque pas
+	
+	static SimFleet* active;
+	
+	void tick();
+	void waitMs(unsigned long ms);
+	static void delayHook(unsigned long ms);
+};
+
+#endif // SIM_FLEET_H
@@ -0,0 +1,270 @@
+#include "../sim/SimNode.h"
+#include "../sim/SimChannel.h"
+#include "../sim/SimContext.h"
+
+SimNode::SimNode(uint8_t index, SimChannel* channel, uint16_t dutyCyclePermille)
+	: index(index), channel(channel), dutyCyclePermille(dutyCyclePermille), deviceId(0), seqNumber(0),
+	  pairingManager(nullptr), fragmentManager(nullptr), heartbeatManager(nullptr),
+	  discoveryManager(nullptr), rateController(nullptr), powerController(nullptr),
+	  linkQuality(nullptr), packetHandler(nullptr),
+	  partner(nullptr), initiator(false), messageIntervalMs(20000), nextActionMs(0),
+	  pairedAtMs(0), messagesSent(0), rebootCount(0),
+	  fecEnabled(false), windowSize(FragmentManager<SimRadio>::DEFAULT_WINDOW_SIZE) {
+	createHardware();
+}
+
+SimNode::~SimNode() {
+	destroyStack();
+}
+
+void SimNode::createHardware() {
+	nvsManager = new NVSManager();
+	securityManager = new SecurityManager();
+	radio = new SimRadio(channel, dutyCyclePermille);
+}
+
+void SimNode::destroyStack() {
+	delete packetHandler;
+	delete powerController;
+	delete rateController;
+	delete linkQuality;
+	delete discoveryManager;
+	delete heartbeatManager;
+	delete fragmentManager;
+	delete pairingManager;
+	delete radio;
+	delete securityManager;
+	delete nvsManager;
+	packetHandler = nullptr;
+	powerController = nullptr;
+	rateController = nullptr;
+	linkQuality = nullptr;
+	discoveryManager = nullptr;
+	heartbeatManager = nullptr;
+	fragmentManager = nullptr;
+	pairingManager = nullptr;
+	radio = nullptr;
+	securityManager = nullptr;
+	nvsManager = nullptr;
+}
+
+bool SimNode::reboot() {
+	const uint8_t channelIndex = radio->getChannelIndex();
+	destroyStack();
+	createHardware();
+	// Place reprise avant tout delay() : le canal ne remet plus rien à l'ancienne radio
+	radio->rejoinChannel(channelIndex);
+	rebootCount++;
+	
+	Serial.println("[SIM] Redémarrage du noeud");
+	if (!begin()) return false;
+	fragmentManager->setFecEnabled(fecEnabled);
+	fragmentManager->setWindowSize(windowSize);
+	// Le script reprend sur la nouvelle horloge millis() du noeud
+	nextActionMs = millis() + 1000 + (SimContext::random32() % 2000);
+	return true;
+}
+
+bool SimNode::begin() {
+	if (!securityManager->init()) {
+		Serial.println("[SEC] ERREUR: Echec init SecurityManager");
+		return false;
+	}
+	if (!nvsManager->loadDeviceId(deviceId)) {
+		Serial.println("[NVS] Erreur lors du chargement du Device ID");
+	}
+	
+	radio->setLocalAddress(radioAddressOf(deviceId));
+	if (!radio->begin(nvsManager)) {
+		return false;
+	}
+	
+	pairingManager = new PairingManager<SimRadio>(securityManager, radio, nvsManager);
+	pairingManager->setDeviceId(deviceId);
+	fragmentManager = new FragmentManager<SimRadio>(securityManager, radio);
+	heartbeatManager = new HeartbeatManager<SimRadio>(securityManager, radio);
+	discoveryManager = new DiscoveryManager<SimRadio>(radio);
+	linkQuality = new LinkQualityTable();
+	heartbeatManager->setLinkQualityTable(linkQuality);
+	discoveryManager->setLinkQualityTable(linkQuality);
+	packetHandler = new PacketHandler<SimRadio>(pairingManager, fragmentManager,
+	                                            heartbeatManager, discoveryManager);
+	rateController = new AdaptiveRateController<SimRadio>(securityManager, radio, fragmentManager, nvsManager);
+	packetHandler->setRateController(rateController);
+	powerController = new TransmitPowerController<SimRadio>(radio, fragmentManager, heartbeatManager);
+	
+	pairingManager->loadPairingState();
+	discoveryManager->setPairingMode(!pairingManager->isPaired());
+	
+	Serial.print("Device ID: 0x");
+	Serial.println(deviceId, HEX);
+	return true;
+}
+
+void SimNode::setPartner(SimNode* node, bool isInitiator) {
+	partner = node;
+	initiator = isInitiator;
+	// Décalage par noeud : les couples ne démarrent pas tous au même instant
+	nextActionMs = millis() + 1000 + (SimContext::random32() % 2000);
+}
+
+void SimNode::step() {
+	runScript();
+	loop();
+}
+
+void SimNode::runScript() {
+	if (!partner) return;
+	const unsigned long now = millis();
+	
+	if (!pairingManager->isPaired()) {
+		// Commande A : accepter la demande du partenaire
+		if (!initiator && pairingManager->hasPendingBind() &&
+		    pairingManager->getPendingInitiatorId() == partner->getDeviceId()) {
+			pairingManager->acceptPendingBind();
+		}
+		// Commande B : (re)demander l'appairage
+		if (initiator && (long)(now - nextActionMs) >= 0) {
+			pairingManager->sendBindRequest(partner->getDeviceId());
+			nextActionMs = now + PAIRING_RETRY_MS;
+		}
+		return;
+	}
+	
+	if (pairedAtMs == 0) {
+		pairedAtMs = now;
+		discoveryManager->setPairingMode(false);
+		nextActionMs = now + (SimContext::random32() % messageIntervalMs);
+	}
+	
+	// Commande S : message périodique, fragmenté une fois sur quatre
+	if ((long)(now - nextActionMs) >= 0) {
+		const size_t len = (messagesSent % 4 == 3) ? LONG_MESSAGE_LEN : SHORT_MESSAGE_LEN;
+		String text = String("n") + String((unsigned int)index) + "#" + String((unsigned long)messagesSent) + " ";
+		while (text.length() < len) text += '.';
+		fragmentManager->sendSecureMessage(text, pairingManager->getSessionKey(), seqNumber);
+		messagesSent++;
+		// Gigue de +/- 25 % : pas de synchronisation durable entre couples
+		const unsigned long jitter = SimContext::random32() % (messageIntervalMs / 2 + 1);
+		nextActionMs = millis() + messageIntervalMs * 3 / 4 + jitter;
+	}
+}
+
+void SimNode::loop() {
+	radio->processTxQueue();
+	
+	ByteView frame;
+	if (radio->receiveFrame(frame)) {
+		packetHandler->handlePacket(frame, deviceId,
+		                           pairingManager->isPaired(),
+		                           pairingManager->getSessionKey(),
+		                           pairingManager);
+	}
+	
+	discoveryManager->sendBeaconIfDue(deviceId);
+	heartbeatManager->sendHeartbeatIfDue(deviceId,
+	                                    pairingManager->getSessionKey(),
+	                                    pairingManager->isPaired(),
+	                                    fragmentManager->isTransmitting());
+	discoveryManager->printDiscoveredIfDue();
+	
+	fragmentManager->purgeOldFragments();
+	fragmentManager->processPendingRetries();
+	
+	rateController->process(deviceId, pairingManager->getSessionKey(),
+	                        pairingManager->isPaired(),
+	                        heartbeatManager->isPairedDeviceOnline());
+	powerController->process(pairingManager->isPaired(),
+	                         heartbeatManager->isPairedDeviceOnline(),
+	                         pairingManager->getPairedDeviceId());
+	
+	heartbeatManager->updateAndSendOnlineStatus(pairingManager->isPaired(),
+	                                           pairingManager->getPairedDeviceId());
+}
+
+void SimNode::printReport() {
+	const LinkStats& link = fragmentManager->getLinkStats();
+	Serial.print("[SIM] Noeud ");
+	Serial.print(index);
+	Serial.print(" (0x");
+	Serial.print(deviceId, HEX);
+	Serial.print(", adresse 0x");
+	Serial.print(radio->getLocalAddress(), HEX);
+	Serial.println(")");
+	
+	Serial.print("  Appairage : ");
+	if (pairingManager->isPaired()) {
+		Serial.print("OK à ");
+		Serial.print(pairedAtMs / 1000.0, 1);
+		Serial.print(" s avec 0x");
+		Serial.println(pairingManager->getPairedDeviceId(), HEX);
+	} else {
+		Serial.println(partner ? "ECHEC" : "aucun (noeud isolé)");
+	}
+	if (rebootCount > 0 && pairingManager->isPaired()) {
+		// ID du pair non persisté : revu seulement si un heartbeat a passé depuis
+		Serial.print("  Redémarré : ");
+		Serial.print(rebootCount);
+		Serial.print(" fois, pair ");
+		Serial.println(pairingManager->getPairedDeviceId() != 0 ? "retrouvé" : "PERDU");
+	}
+	
+	Serial.print("  Messages  : ");
+	Serial.print(messagesSent);
+	Serial.print(" envoyés, fragments ");
+	Serial.print(link.fragmentsSent);
+	Serial.print(", ACK 1er essai ");
+	Serial.print(link.ackedFirstTry);
+	Serial.print(", ACK après reprise ");
+	Serial.print(link.ackedAfterRetry);
+	Serial.print(", retransmissions ");
+	Serial.print(link.retransmissions);
+	Serial.print(", échecs ");
+	Serial.print(link.failures);
+	Serial.print(", parité FEC ");
+	Serial.print(link.fecParitySent);
+	Serial.print(", reconstruits ");
+	Serial.print(link.fecRecovered);
+	Serial.print(", ACK émis ");
+	Serial.println(link.acksSent);
+	
+	const FragmentManager<SimRadio>::FragmentSlotPool& pool = fragmentManager->getSlotPool();
+	Serial.print("  Pool      : ");
+	Serial.print(pool.getInUse());
+	Serial.print("/");
+	Serial.print(pool.capacity());
+	Serial.print(" slots, max ");
+	Serial.print(pool.getHighWatermark());
+	Serial.print(", épuisé ");
+	Serial.print(pool.getExhaustedCount());
+	Serial.println(" fois");
+	
+	const FragmentManager<SimRadio>::ReassemblyTable& rx = fragmentManager->getReassemblyTable();
+	Serial.print("  Transferts: envoi max ");
+	Serial.print(fragmentManager->getPendingTable().getHighWatermark());
+	Serial.print("/");
+	Serial.print(FragmentManager<SimRadio>::PendingTable::capacity());
+	Serial.print(", réception max ");
+	Serial.print(rx.getHighWatermark());
+	Serial.print("/");
+	Serial.print(rx.capacity());
+	Serial.print(", pleine ");
+	Serial.print(rx.getFullCount());
+	Serial.println(" fois");
+	
+	Serial.print("  Radio     : ");
+	Serial.print(radio->getTxSentCount());
+	Serial.print(" trames, ");
+	Serial.print((unsigned long)(radio->getTxAirtimeTotalUs() / 1000ULL));
+	Serial.print(" ms d'antenne, file perdus ");
+	Serial.print(radio->getTxDroppedCount());
+	Serial.print(", hors budget ");
+	Serial.print(radio->getTxBudgetDroppedCount());
+	Serial.print(", différés ");
+	Serial.print(radio->getTxDeferredCount());
+	Serial.print(", débit ");
+	Serial.print(radio->getRateName(radio->getRateIndex()));
+	Serial.print(", puissance ");
+	Serial.print(radio->getPowerDbm(radio->getPowerIndex()));
+	Serial.println(" dBm");
+}
@@ -0,0 +1,106 @@
+#ifndef SIM_NODE_H
+#define SIM_NODE_H
+
+#include <Arduino.h>
+#include "../storage/NVSManager.h"
+#include "../security/SecurityManager.h"
+#include "../security/PairingManager.h"
+#include "../security/DiscoveryManager.h"
+#include "../protocol/FragmentManager.h"
+#include "../protocol/AdaptiveRateController.h"
+#include "../protocol/TransmitPowerController.h"
+#include "../utils/HeartbeatManager.h"
+#include "../utils/LinkQualityTable.h"
+#include "../lora/PacketHandler.h"
+#include "../sim/SimRadio.h"
+
+class SimChannel;
+
+/**
+ * Noeud simulé : la pile sécurisée complète de main_complet sur un SimRadio,
+ * pilotée par un script de trafic à la place des commandes série
+ *
+ * begin() et loop() sont des copies de setup() / loop() de main_complet
+ * (managers et ordre des appels), sans le matériel ni les commandes série :
+ * à garder en phase quand le mode change.
+ *
+ * Script : le noeud "initiateur" d'un couple demande l'appairage (commande B)
+ * jusqu'à réussite, le "répondeur" accepte la demande de son partenaire
+ * (commande A) ; une fois appairés, chacun envoie un message (commande S)
+ * toutes les messageIntervalMs, un sur quatre assez long pour être fragmenté.
+ *
+ * reboot() rejoue une coupure d'alimentation : toute la pile, radio comprise,
+ * est reconstruite et ne retrouve que ce que la NVS a conservé.
+ */
+class SimNode {
+public:
+	static const unsigned long PAIRING_RETRY_MS = 8000;
+	static const size_t SHORT_MESSAGE_LEN = 24;
+	static const size_t LONG_MESSAGE_LEN = 240;
+	
+	SimNode(uint8_t index, SimChannel* channel, uint16_t dutyCyclePermille);
+	~SimNode();
+	
+	// Reprise de setup() de main_complet
+	bool begin();
+	
+	// Redémarrage complet (nouvelle radio sur la même place du canal) puis begin()
+	bool reboot();
+	
+	// Script de trafic puis reprise de loop() de main_complet
+	void step();
+	
+	// Couple pour le script (nullptr : noeud isolé, beacons seulement)
+	void setPartner(SimNode* node, bool initiator);
+	void setMessageIntervalMs(unsigned long intervalMs) { messageIntervalMs = intervalMs; }
+	void setFecEnabled(bool enabled) { fecEnabled = enabled; fragmentManager->setFecEnabled(enabled); }
+	void setWindowSize(uint8_t size) { windowSize = size; fragmentManager->setWindowSize(size); }
+	
+	uint8_t getIndex() const { return index; }
+	uint32_t getDeviceId() const { return deviceId; }
+	bool isPaired() const { return pairingManager->isPaired(); }
+	unsigned long getPairedAtMs() const { return pairedAtMs; }
+	uint32_t getMessagesSent() const { return messagesSent; }
+	uint32_t getPairedDeviceId() const { return pairingManager->getPairedDeviceId(); }
+	uint8_t getRebootCount() const { return rebootCount; }
+	const LinkStats& getLinkStats() const { return fragmentManager->getLinkStats(); }
+	SimRadio* getRadio() { return radio; }
+	
+	void printReport();
+	
+private:
+	uint8_t index;
+	SimChannel* channel;
+	uint16_t dutyCyclePermille;
+	uint32_t deviceId;
+	uint32_t seqNumber;
+	
+	NVSManager* nvsManager;
+	SecurityManager* securityManager;
+	SimRadio* radio;
+	PairingManager<SimRadio>* pairingManager;
+	FragmentManager<SimRadio>* fragmentManager;
+	HeartbeatManager<SimRadio>* heartbeatManager;
+	DiscoveryManager<SimRadio>* discoveryManager;
+	AdaptiveRateController<SimRadio>* rateController;
+	TransmitPowerController<SimRadio>* powerController;
+	LinkQualityTable* linkQuality;
+	PacketHandler<SimRadio>* packetHandler;
+	
+	SimNode* partner;
+	bool initiator;
+	unsigned long messageIntervalMs;
+	unsigned long nextActionMs;
+	unsigned long pairedAtMs;
+	uint32_t messagesSent;
+	uint8_t rebootCount;
+	bool fecEnabled;      // réglages du scénario, réappliqués après reboot()
+	uint8_t windowSize;
+	
+	void createHardware();
+	void destroyStack();
+	void runScript();
+	void loop();
+};
+
+#endif // SIM_NODE_H
@@ -0,0 +1,128 @@
+#include "../sim/SimRadio.h"
+#include "../sim/SimChannel.h"
+#include "../sim/SimContext.h"
+#include "../utils/AirTime.h"
+
+// Mêmes valeurs que LoRaModule (E220-900T22D)
+static const uint32_t SIM_RATE_BPS[SimRadio::RATE_COUNT] = { 2400, 4800, 9600, 19200 };
+static const char* const SIM_RATE_NAMES[SimRadio::RATE_COUNT] = { "2.4kbps", "4.8kbps", "9.6kbps", "19.2kbps" };
+static const int16_t SIM_RATE_SENSITIVITY_DBM[SimRadio::RATE_COUNT] = { -129, -126, -123, -120 };
+static const int8_t SIM_POWER_DBM[SimRadio::POWER_COUNT] = { 10, 13, 17, 22 };
+// En-tête ADDH/ADDL/CHAN de la transmission fixe
+static const size_t SIM_FIXED_HEADER_BYTES = 3;
+
+SimRadio::SimRadio(SimChannel* channel, uint16_t dutyCyclePermille)
+	: RadioDriver<SimRadio>(dutyCyclePermille),
+	  channel(channel), channelIndex(SIM_NO_NODE), txEndUs(0), rateIndex(getBaseRateIndex()),
+	  powerIndex(getMaxPowerIndex()), lastRssi(0), lastRxTimestampMs(0), holdingRxFrame(false) {
+}
+
+bool SimRadio::rejoinChannel(uint8_t index) {
+	if (!channel->reattach(index, this)) return false;
+	channelIndex = index;
+	return true;
+}
+
+bool SimRadio::begin(NVSManager* nvs) {
+	(void)nvs;
+	if (channelIndex == SIM_NO_NODE) {
+		channelIndex = channel->attach(this);
+	}
+	if (channelIndex == SIM_NO_NODE) {
+		Serial.println("[SIM] ERREUR: Canal plein");
+		return false;
+	}
+	Serial.print("[SIM] Radio simulée, adresse 0x");
+	Serial.print(getLocalAddress(), HEX);
+	Serial.print(", ");
+	Serial.print(SIM_RATE_NAMES[rateIndex]);
+	Serial.print(", ");
+	Serial.print(SIM_POWER_DBM[powerIndex]);
+	Serial.println(" dBm");
+	return true;
+}
+
+const char* SimRadio::getRateName(uint8_t index) const {
+	return index < RATE_COUNT ? SIM_RATE_NAMES[index] : "?";
+}
+
+int SimRadio::getSensitivityDbm() const {
+	return SIM_RATE_SENSITIVITY_DBM[rateIndex];
+}
+
+int SimRadio::getPowerDbm(uint8_t index) const {
+	return index < POWER_COUNT ? SIM_POWER_DBM[index] : 0;
+}
+
+bool SimRadio::setPowerIndex(uint8_t index) {
+	if (index > getMaxPowerIndex()) return false;
+	powerIndex = index;
+	return true;
+}
+
+uint32_t SimRadio::timeOnAirUs(size_t len) const {
+	return AirTime::e220Us(len + SIM_FIXED_HEADER_BYTES, SIM_RATE_BPS[rateIndex]);
+}
+
+bool SimRadio::setRateIndex(uint8_t index) {
+	if (index >= RATE_COUNT) return false;
+	if (index == rateIndex) return true;
+	
+	// Comme le E220 : les trames en file partent encore à l'ancien débit
+	if (!flushTxQueue(2000)) {
+		Serial.println("[SIM] ATTENTION: File TX non vidée avant changement de débit");
+	}
+	
+	Serial.print("[SIM] Débit air: ");
+	Serial.print(SIM_RATE_NAMES[rateIndex]);
+	Serial.print(" -> ");
+	Serial.println(SIM_RATE_NAMES[index]);
+	rateIndex = index;
+	return true;
+}
+
+bool SimRadio::canTransmit() {
+	return SimContext::nowUs() >= txEndUs;
+}
+
+void SimRadio::transmitFrame(const uint8_t* data, size_t len, uint16_t dest) {
+	const uint32_t airtimeUs = timeOnAirUs(len);
+	// Les trames broadcast (beacons, appairage) partent à la puissance nominale
+	const uint8_t txPower = (dest == RADIO_ADDR_BROADCAST) ? getMaxPowerIndex() : powerIndex;
+	channel->transmit(channelIndex, data, len, dest, rateIndex, SIM_POWER_DBM[txPower], airtimeUs);
+	txEndUs = SimContext::nowUs() + airtimeUs;
+}
+
+bool SimRadio::acceptsAddress(uint16_t dest) const {
+	return dest == RADIO_ADDR_BROADCAST || getLocalAddress() == RADIO_ADDR_BROADCAST ||
+	       dest == getLocalAddress();
+}
+
+bool SimRadio::deliver(const uint8_t* data, size_t len, int rssi, uint32_t timestampMs) {
+	if (rxQueue.size() >= SIM_RX_QUEUE_SLOTS) return false;
+	
+	RxFrame frame;
+	frame.data.assign(data, data + len);
+	frame.rssi = rssi;
+	frame.timestampMs = timestampMs;
+	rxQueue.push_back(frame);
+	return true;
+}
+
+bool SimRadio::receiveFrame(ByteView& frame) {
+	// La vue précédente n'est plus utilisée : sa trame quitte la file
+	if (holdingRxFrame) {
+		rxQueue.pop_front();
+		holdingRxFrame = false;
+	}
+	
+	channel->deliverDue();
+	if (rxQueue.empty()) return false;
+	
+	const RxFrame& head = rxQueue.front();
+	holdingRxFrame = true;
+	lastRssi = head.rssi;
+	lastRxTimestampMs = head.timestampMs;
+	frame = ByteView(head.data.data(), head.data.size());
+	return true;
+}
@@ -0,0 +1,94 @@
+#ifndef SIM_RADIO_H
+#define SIM_RADIO_H
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+#include "../Config.h"
+#include "../lora/RadioDriver.h"
+#include "../utils/ByteView.h"
+
+class NVSManager;
+class SimChannel;
+
+/**
+ * Driver radio simulé (env native_sim) : même interface RadioDriver que
+ * LoRaModule, branché sur un SimChannel partagé au lieu de l'UART du E220
+ *
+ * Modèle calqué sur le E220 en transmission fixe : échelle de débits
+ * 2.4 -> 19.2 kbps et de puissances 10 -> 22 dBm, temps d'antenne
+ * AirTime::e220Us avec l'en-tête ADDH/ADDL/CHAN, filtrage par adresse
+ * (le module ne remet que le broadcast et ses propres trames), pas de SNR.
+ * La réception est une file de SIM_RX_QUEUE_SLOTS trames, comme la file RX
+ * du XL1278 ; au-delà, les trames sont perdues (comptées par le canal).
+ */
+class SimRadio : public RadioDriver<SimRadio> {
+public:
+	static const uint8_t SIM_RX_QUEUE_SLOTS = 8;
+	
+	explicit SimRadio(SimChannel* channel, uint16_t dutyCyclePermille = DUTY_CYCLE_PERMILLE_E220);
+	
+	// nvs inutilisé : rien à configurer côté module
+	bool begin(NVSManager* nvs = nullptr);
+	
+	// Vue sur la trame en tête de file, valide jusqu'à la réception suivante
+	bool receiveFrame(ByteView& frame);
+	using RadioDriver<SimRadio>::receiveFrame;
+	
+	int getLastRssi() const { return lastRssi; }
+	float getLastSnr() const { return 0.0f; }
+	bool hasSnr() const { return false; }
+	uint32_t getLastRxTimestamp() const { return lastRxTimestampMs; }
+	
+	// Interface RadioDriver : occupé pendant le temps d'antenne de la trame en cours
+	bool canTransmit();
+	void transmitFrame(const uint8_t* data, size_t len, uint16_t dest);
+	const char* bandName() const { return "SIM"; }
+	
+	// Échelles identiques au E220 (débit de base 2.4 kbps, puissance nominale 22 dBm)
+	static const uint8_t RATE_COUNT = 4;
+	uint8_t getRateCount() const { return RATE_COUNT; }
+	uint8_t getRateIndex() const { return rateIndex; }
+	uint8_t getBaseRateIndex() const { return 0; }
+	bool setRateIndex(uint8_t index);
+	const char* getRateName(uint8_t index) const;
+	
+	int getSensitivityDbm() const;
+	
+	static const uint8_t POWER_COUNT = 4;
+	uint8_t getPowerCount() const { return POWER_COUNT; }
+	uint8_t getPowerIndex() const { return powerIndex; }
+	uint8_t getMaxPowerIndex() const { return POWER_COUNT - 1; }
+	bool setPowerIndex(uint8_t index);
+	int getPowerDbm(uint8_t index) const;
+	
+	uint32_t timeOnAirUs(size_t len) const;
+	
+	// Côté canal : filtrage d'adresse du module et remise d'une trame
+	bool acceptsAddress(uint16_t dest) const;
+	bool deliver(const uint8_t* data, size_t len, int rssi, uint32_t timestampMs);
+	
+	uint8_t getChannelIndex() const { return channelIndex; }
+	// Redémarrage : reprend la place de la radio précédente du noeud, que le
+	// canal ne doit plus jamais adresser (begin() ne s'attache alors plus)
+	bool rejoinChannel(uint8_t index);
+	
+private:
+	struct RxFrame {
+		std::vector<uint8_t> data;
+		int rssi;
+		uint32_t timestampMs;
+	};
+	
+	SimChannel* channel;
+	uint8_t channelIndex;
+	uint64_t txEndUs;
+	uint8_t rateIndex;
+	uint8_t powerIndex;
+	int lastRssi;
+	uint32_t lastRxTimestampMs;
+	std::deque<RxFrame> rxQueue;
+	bool holdingRxFrame;  // trame en tête encore exposée par la dernière vue
+};
+
+#endif // SIM_RADIO_H
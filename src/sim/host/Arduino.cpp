@@ -0,0 +1,155 @@
+#include <Arduino.h>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include "../SimContext.h"
+
+SimSerial Serial;
+
+// ---------------------------------------------------------------------------
+// String
+// ---------------------------------------------------------------------------
+
+void String::trim() {
+	size_t start = 0;
+	while (start < value.size() && isspace((unsigned char)value[start])) start++;
+	size_t end = value.size();
+	while (end > start && isspace((unsigned char)value[end - 1])) end--;
+	value = value.substr(start, end - start);
+}
+
+void String::toUpperCase() {
+	for (size_t i = 0; i < value.size(); i++) {
+		value[i] = (char)toupper((unsigned char)value[i]);
+	}
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+	if (value.size() != other.value.size()) return false;
+	for (size_t i = 0; i < value.size(); i++) {
+		if (tolower((unsigned char)value[i]) != tolower((unsigned char)other.value[i])) return false;
+	}
+	return true;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+	const size_t pos = value.find(c, from);
+	return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int from) const {
+	return from < value.size() ? String(value.substr(from)) : String();
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+	if (to > value.size()) to = (unsigned int)value.size();
+	return from < to ? String(value.substr(from, to - from)) : String();
+}
+
+std::string String::formatSigned(long v, unsigned char base) {
+	// Comme Arduino : signe uniquement en décimal
+	if (base == DEC && v < 0) return "-" + formatUnsigned((unsigned long long)(-(long long)v), base);
+	return formatUnsigned((unsigned long)v, base);
+}
+
+std::string String::formatUnsigned(unsigned long long v, unsigned char base) {
+	if (base < 2 || base > 16) base = DEC;
+	char buf[65];
+	size_t pos = sizeof(buf);
+	buf[--pos] = '\0';
+	do {
+		buf[--pos] = "0123456789ABCDEF"[v % base];
+		v /= base;
+	} while (v > 0);
+	return std::string(&buf[pos]);
+}
+
+std::string String::formatFloat(double v, unsigned char decimals) {
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+	return std::string(buf);
+}
+
+// ---------------------------------------------------------------------------
+// Serial
+// ---------------------------------------------------------------------------
+
+void SimSerial::flush() {
+	SimContext::flush();
+}
+
+size_t SimSerial::write(uint8_t c) {
+	const char ch = (char)c;
+	SimContext::write(&ch, 1);
+	return 1;
+}
+
+size_t SimSerial::write(const uint8_t* data, size_t len) {
+	SimContext::write((const char*)data, len);
+	return len;
+}
+
+size_t SimSerial::print(const char* text) {
+	const size_t len = strlen(text);
+	SimContext::write(text, len);
+	return len;
+}
+
+size_t SimSerial::print(double v, int decimals) {
+	return print(String::formatFloat(v, (unsigned char)decimals).c_str());
+}
+
+size_t SimSerial::printSigned(long v, int base) {
+	return print(String::formatSigned(v, (unsigned char)base).c_str());
+}
+
+size_t SimSerial::printUnsigned(unsigned long long v, int base) {
+	return print(String::formatUnsigned(v, (unsigned char)base).c_str());
+}
+
+size_t SimSerial::printf(const char* format, ...) {
+	char buf[256];
+	va_list args;
+	va_start(args, format);
+	const int n = vsnprintf(buf, sizeof(buf), format, args);
+	va_end(args);
+	if (n <= 0) return 0;
+	return print(buf);
+}
+
+// ---------------------------------------------------------------------------
+// Temps, aléa, identité du noeud
+// ---------------------------------------------------------------------------
+
+unsigned long millis() {
+	return (unsigned long)(SimContext::localUs() / 1000ULL);
+}
+
+unsigned long micros() {
+	return (unsigned long)SimContext::localUs();
+}
+
+void delay(unsigned long ms) {
+	SimContext::delayMs(ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+	// Attentes actives courtes : le temps avance sans rendre la main aux autres noeuds
+	SimContext::advanceUs(us);
+}
+
+void yield() {
+}
+
+uint32_t esp_random() {
+	return SimContext::random32();
+}
+
+int esp_read_mac(uint8_t* mac, esp_mac_type_t type) {
+	(void)type;
+	// OUI Espressif, dernier octet = numéro du noeud
+	static const uint8_t BASE_MAC[5] = { 0x24, 0x0A, 0xC4, 0x51, 0x40 };
+	memcpy(mac, BASE_MAC, sizeof(BASE_MAC));
+	mac[5] = SimContext::currentNode();
+	return 0;
+}
@@ -0,0 +1,124 @@
+#ifndef SIM_HOST_ARDUINO_H
+#define SIM_HOST_ARDUINO_H
+
+/**
+ * Sous-ensemble de l'API Arduino-ESP32 pour la simulation hôte (env native_sim)
+ *
+ * Seul ce qu'utilise la pile sécurisée est fourni : temps virtuel (SimContext),
+ * Serial ligne par ligne préfixé par le noeud courant, String minimal,
+ * esp_random déterministe et adresse MAC propre à chaque noeud.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+
+typedef uint8_t byte;
+
+#define DEC 10
+#define HEX 16
+
+class String {
+public:
+	String(const char* text = "") : value(text ? text : "") {}
+	String(const char* text, unsigned int len) : value(text, len) {}
+	String(const std::string& text) : value(text) {}
+	explicit String(char c) : value(1, c) {}
+	explicit String(int v, unsigned char base = DEC) : value(formatSigned(v, base)) {}
+	explicit String(unsigned int v, unsigned char base = DEC) : value(formatUnsigned(v, base)) {}
+	explicit String(long v, unsigned char base = DEC) : value(formatSigned(v, base)) {}
+	explicit String(unsigned long v, unsigned char base = DEC) : value(formatUnsigned(v, base)) {}
+	explicit String(float v, unsigned char decimals = 2) : value(formatFloat(v, decimals)) {}
+	explicit String(double v, unsigned char decimals = 2) : value(formatFloat(v, decimals)) {}
+	
+	unsigned int length() const { return (unsigned int)value.size(); }
+	const char* c_str() const { return value.c_str(); }
+	char operator[](unsigned int i) const { return i < value.size() ? value[i] : 0; }
+	char& operator[](unsigned int i) { return value[i]; }
+	
+	String& operator+=(const String& other) { value += other.value; return *this; }
+	String& operator+=(const char* text) { value += text; return *this; }
+	String& operator+=(char c) { value += c; return *this; }
+	friend String operator+(const String& a, const String& b) { return String(a.value + b.value); }
+	friend String operator+(const String& a, const char* b) { return String(a.value + b); }
+	friend String operator+(const char* a, const String& b) { return String(a + b.value); }
+	bool operator==(const String& other) const { return value == other.value; }
+	bool operator!=(const String& other) const { return value != other.value; }
+	
+	void trim();
+	void toUpperCase();
+	bool equalsIgnoreCase(const String& other) const;
+	bool startsWith(const String& prefix) const { return value.compare(0, prefix.value.size(), prefix.value) == 0; }
+	int indexOf(char c, unsigned int from = 0) const;
+	String substring(unsigned int from) const;
+	String substring(unsigned int from, unsigned int to) const;
+	long toInt() const { return strtol(value.c_str(), nullptr, 10); }
+	float toFloat() const { return strtof(value.c_str(), nullptr); }
+	
+	static std::string formatSigned(long v, unsigned char base);
+	static std::string formatUnsigned(unsigned long long v, unsigned char base);
+	static std::string formatFloat(double v, unsigned char decimals);
+	
+private:
+	std::string value;
+};
+
+class SimSerial {
+public:
+	void begin(unsigned long baud) { (void)baud; }
+	explicit operator bool() const { return true; }
+	
+	// Pas d'entrée série : le scénario pilote les noeuds directement
+	int available() { return 0; }
+	int read() { return -1; }
+	String readStringUntil(char terminator) { (void)terminator; return String(); }
+	void flush();
+	
+	size_t write(uint8_t c);
+	size_t write(const uint8_t* data, size_t len);
+	
+	size_t print(const char* text);
+	size_t print(const String& text) { return print(text.c_str()); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(int v, int base = DEC) { return printSigned(v, base); }
+	size_t print(long v, int base = DEC) { return printSigned(v, base); }
+	size_t print(long long v, int base = DEC) { return printSigned((long)v, base); }
+	size_t print(unsigned char v, int base = DEC) { return printUnsigned(v, base); }
+	size_t print(unsigned int v, int base = DEC) { return printUnsigned(v, base); }
+	size_t print(unsigned long v, int base = DEC) { return printUnsigned(v, base); }
+	size_t print(unsigned long long v, int base = DEC) { return printUnsigned(v, base); }
+	size_t print(double v, int decimals = 2);
+	
+	template <class T>
+	size_t println(const T& v) { const size_t n = print(v); return n + println(); }
+	template <class T>
+	size_t println(const T& v, int format) { const size_t n = print(v, format); return n + println(); }
+	size_t println() { return print("\n"); }
+	
+	size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+	
+private:
+	size_t printSigned(long v, int base);
+	size_t printUnsigned(unsigned long long v, int base);
+};
+
+extern SimSerial Serial;
+
+// Temps virtuel : seul le simulateur le fait avancer (delay() y rend la main)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+uint32_t esp_random();
+
+typedef enum {
+	ESP_MAC_WIFI_STA
+} esp_mac_type_t;
+int esp_read_mac(uint8_t* mac, esp_mac_type_t type);
+
+#endif // SIM_HOST_ARDUINO_H
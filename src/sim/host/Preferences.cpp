@@ -0,0 +1,81 @@
+#include <Preferences.h>
+#include <map>
+#include <vector>
+#include "../SimContext.h"
+
+// Clé complète "noeud/espace/clé" -> valeur brute
+static std::map<std::string, std::vector<uint8_t> > store;
+
+bool Preferences::begin(const char* name, bool readOnlyMode) {
+	nameSpace = name;
+	readOnly = readOnlyMode;
+	node = SimContext::currentNode();
+	opened = true;
+	return true;
+}
+
+std::string Preferences::fullKey(const char* key) const {
+	return String::formatUnsigned(node, DEC) + "/" + nameSpace + "/" + key;
+}
+
+bool Preferences::isKey(const char* key) {
+	return opened && store.count(fullKey(key)) > 0;
+}
+
+bool Preferences::remove(const char* key) {
+	if (!opened || readOnly) return false;
+	return store.erase(fullKey(key)) > 0;
+}
+
+bool Preferences::clear() {
+	if (!opened || readOnly) return false;
+	const std::string prefix = fullKey("");
+	for (std::map<std::string, std::vector<uint8_t> >::iterator it = store.begin(); it != store.end(); ) {
+		if (it->first.compare(0, prefix.size(), prefix) == 0) {
+			store.erase(it++);
+		} else {
+			++it;
+		}
+	}
+	return true;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+	if (!opened || readOnly) return 0;
+	const uint8_t* bytes = (const uint8_t*)value;
+	store[fullKey(key)].assign(bytes, bytes + len);
+	return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+	if (!opened) return 0;
+	std::map<std::string, std::vector<uint8_t> >::const_iterator it = store.find(fullKey(key));
+	if (it == store.end() || it->second.size() > maxLen) return 0;
+	memcpy(buf, it->second.data(), it->second.size());
+	return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+	if (!opened) return 0;
+	std::map<std::string, std::vector<uint8_t> >::const_iterator it = store.find(fullKey(key));
+	return it == store.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::putValue(const char* key, uint32_t value, size_t width) {
+	uint8_t bytes[4];
+	for (size_t i = 0; i < width; i++) {
+		bytes[i] = (uint8_t)(value >> (8 * i));
+	}
+	return putBytes(key, bytes, width);
+}
+
+uint32_t Preferences::getValue(const char* key, uint32_t defaultValue) {
+	uint8_t bytes[4];
+	const size_t len = getBytes(key, bytes, sizeof(bytes));
+	if (len == 0) return defaultValue;
+	uint32_t value = 0;
+	for (size_t i = 0; i < len; i++) {
+		value |= (uint32_t)bytes[i] << (8 * i);
+	}
+	return value;
+}
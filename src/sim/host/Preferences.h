@@ -0,0 +1,46 @@
+#ifndef SIM_HOST_PREFERENCES_H
+#define SIM_HOST_PREFERENCES_H
+
+#include <Arduino.h>
+#include <string>
+
+/**
+ * NVS simulée (env native_sim) : stockage en mémoire, une partition par noeud
+ * (SimContext::currentNode), conservée pendant toute la simulation
+ */
+class Preferences {
+public:
+	Preferences() : opened(false), readOnly(false), node(0) {}
+	
+	bool begin(const char* name, bool readOnly = false);
+	void end() { opened = false; }
+	
+	bool isKey(const char* key);
+	bool remove(const char* key);
+	bool clear();
+	
+	size_t putBytes(const char* key, const void* value, size_t len);
+	size_t getBytes(const char* key, void* buf, size_t maxLen);
+	size_t getBytesLength(const char* key);
+	
+	size_t putBool(const char* key, bool value) { return putValue(key, (uint32_t)(value ? 1 : 0), 1); }
+	bool getBool(const char* key, bool defaultValue = false) { return getValue(key, defaultValue ? 1 : 0) != 0; }
+	size_t putUChar(const char* key, uint8_t value) { return putValue(key, value, 1); }
+	uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return (uint8_t)getValue(key, defaultValue); }
+	size_t putUInt(const char* key, uint32_t value) { return putValue(key, value, 4); }
+	uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+	size_t putULong(const char* key, uint32_t value) { return putValue(key, value, 4); }
+	uint32_t getULong(const char* key, uint32_t defaultValue = 0) { return getValue(key, defaultValue); }
+	
+private:
+	bool opened;
+	bool readOnly;
+	uint8_t node;
+	std::string nameSpace;
+	
+	std::string fullKey(const char* key) const;
+	size_t putValue(const char* key, uint32_t value, size_t width);
+	uint32_t getValue(const char* key, uint32_t defaultValue);
+};
+
+#endif // SIM_HOST_PREFERENCES_H
@@ -0,0 +1,104 @@
+#include <Arduino.h>
+#include <cstdio>
+#include "../sim/SimContext.h"
+#include "../sim/SimFleet.h"
+
+/**
+ * Simulateur hôte de la pile sécurisée (pio run -e native_sim)
+ *
+ * Usage : program [options]
+ *   --nodes N         noeuds (défaut 4, couples (0,1), (2,3)...)
+ *   --duration S      durée simulée en secondes (défaut 300)
+ *   --spacing M       distance entre noeuds voisins en mètres (défaut 500)
+ *   --loss P          probabilité de perte par trame et par récepteur (défaut 0)
+ *   --corrupt P       probabilité de corruption d'une trame remise (défaut 0)
+ *   --fading DB       écart type de l'évanouissement par trame (défaut 2)
+ *   --interval S      période des messages applicatifs (défaut 20)
+ *   --duty PERMILLE   duty cycle de la bande (défaut DUTY_CYCLE_PERMILLE_E220, 0 = aucun)
+ *   --seed X          graine (défaut 1) : même graine, même simulation
+ *   --fec             parité Reed-Solomon sur les messages fragmentés (commande FEC ON)
+ *   --window N        fragments émis sans attendre leur ACK (défaut 4, commande WINDOW)
+ *   --reboot S        redémarre tous les noeuds à S secondes, appairage conservé en NVS
+ *                     (défaut 0 = jamais)
+ *   --quiet           bilan seulement, sans les logs des noeuds
+ */
+
+static void printUsage(const char* program) {
+	printf("Usage: %s [--nodes N] [--duration S] [--spacing M] [--loss P] [--corrupt P]\n"
+	       "          [--fading DB] [--interval S] [--duty PERMILLE] [--seed X] [--fec]\n"
+	       "          [--window N] [--reboot S] [--quiet]\n", program);
+}
+
+int main(int argc, char** argv) {
+	unsigned long nodeCount = 4;
+	double durationS = 300.0;
+	double spacingM = 500.0;
+	double loss = 0.0;
+	double corrupt = 0.0;
+	double fadingDb = 2.0;
+	double intervalS = 20.0;
+	double rebootS = 0.0;
+	unsigned long dutyPermille = DUTY_CYCLE_PERMILLE_E220;
+	unsigned long seed = 1;
+	bool quiet = false;
+	bool fec = false;
+	unsigned long windowSize = FragmentManager<SimRadio>::DEFAULT_WINDOW_SIZE;
+	
+	for (int i = 1; i < argc; i++) {
+		const String arg(argv[i]);
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+		if (arg == "--quiet") { quiet = true; continue; }
+		if (arg == "--fec") { fec = true; continue; }
+		if (!value) { printUsage(argv[0]); return 1; }
+		if (arg == "--nodes") nodeCount = strtoul(value, nullptr, 10);
+		else if (arg == "--duration") durationS = atof(value);
+		else if (arg == "--spacing") spacingM = atof(value);
+		else if (arg == "--loss") loss = atof(value);
+		else if (arg == "--corrupt") corrupt = atof(value);
+		else if (arg == "--fading") fadingDb = atof(value);
+		else if (arg == "--interval") intervalS = atof(value);
+		else if (arg == "--duty") dutyPermille = strtoul(value, nullptr, 10);
+		else if (arg == "--seed") seed = strtoul(value, nullptr, 0);
+		else if (arg == "--window") windowSize = strtoul(value, nullptr, 10);
+		else if (arg == "--reboot") rebootS = atof(value);
+		else { printUsage(argv[0]); return 1; }
+		i++;
+	}
+	
+	if (nodeCount < 1 || nodeCount > SimFleet::MAX_NODES || intervalS < 1.0 || rebootS < 0.0 ||
+	    windowSize < 1 || windowSize > FragmentManager<SimRadio>::MAX_WINDOW_SIZE) {
+		printUsage(argv[0]);
+		return 1;
+	}
+	
+	SimContext::setVerbose(!quiet);
+	SimFleet fleet((uint8_t)nodeCount, (uint32_t)seed, (uint16_t)dutyPermille);
+	fleet.placeInLine((float)spacingM);
+	fleet.getChannel().setLossProbability((float)loss);
+	fleet.getChannel().setCorruptProbability((float)corrupt);
+	fleet.getChannel().setFadingSigmaDb((float)fadingDb);
+	
+	printf("[SIM] %lu noeuds, %.0f s, espacement %.0f m, perte %.3f, corruption %.3f, graine %lu\n",
+	       nodeCount, durationS, spacingM, loss, corrupt, seed);
+	
+	if (!fleet.begin((unsigned long)(intervalS * 1000.0))) {
+		SimContext::flush();
+		return 1;
+	}
+	for (uint8_t i = 0; i < fleet.getNodeCount(); i++) {
+		fleet.getNode(i).setFecEnabled(fec);
+		fleet.getNode(i).setWindowSize((uint8_t)windowSize);
+	}
+	if (rebootS > 0.0 && rebootS < durationS) {
+		fleet.run((unsigned long)(rebootS * 1000.0));
+		if (!fleet.reboot()) {
+			SimContext::flush();
+			return 1;
+		}
+		fleet.run((unsigned long)((durationS - rebootS) * 1000.0));
+	} else {
+		fleet.run((unsigned long)(durationS * 1000.0));
+	}
+	fleet.printReport();
+	return 0;
+}
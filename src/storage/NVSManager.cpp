@@ -103,12 +103,39 @@ bool NVSManager::clearPairingState() {
 	
 	nvs.remove("sessionKey");
 	nvs.remove("isPaired");
+	nvs.remove("rateReqId");
+	nvs.remove("rateReqSeq");
 	end();
 	
 	Serial.println("[NVS] Appairage effacé");
 	return true;
 }
 
+bool NVSManager::loadRateReqGuard(uint32_t& senderId, uint32_t& seq) {
+	if (!begin()) {
+		return false;
+	}
+	
+	bool found = nvs.isKey("rateReqId") && nvs.isKey("rateReqSeq");
+	if (found) {
+		senderId = nvs.getUInt("rateReqId", 0);
+		seq = nvs.getUInt("rateReqSeq", 0);
+	}
+	end();
+	return found;
+}
+
+bool NVSManager::saveRateReqGuard(uint32_t senderId, uint32_t seq) {
+	if (!begin()) {
+		return false;
+	}
+	
+	nvs.putUInt("rateReqId", senderId);
+	nvs.putUInt("rateReqSeq", seq);
+	end();
+	return true;
+}
+
 bool NVSManager::loadDeviceId(uint32_t& deviceId) {
 	const uint32_t DEFAULT_DEVICE_ID = 0xA1B2C3D4;
 	
@@ -171,3 +198,35 @@ bool NVSManager::saveDeviceId(uint32_t deviceId) {
 	return true;
 }
 
+bool NVSManager::loadRadioConfigFingerprint(uint32_t& fingerprint) {
+	if (!begin()) {
+		return false;
+	}
+	
+	bool found = nvs.isKey("radioCfgFp");
+	if (found) {
+		fingerprint = nvs.getUInt("radioCfgFp", 0);
+	}
+	end();
+	return found;
+}
+
+bool NVSManager::saveRadioConfigFingerprint(uint32_t fingerprint) {
+	if (!begin()) {
+		return false;
+	}
+	
+	nvs.putUInt("radioCfgFp", fingerprint);
+	end();
+	return true;
+}
+
+bool NVSManager::clearRadioConfigFingerprint() {
+	if (!begin()) {
+		return false;
+	}
+	
+	nvs.remove("radioCfgFp");
+	end();
+	return true;
+}
@@ -16,10 +16,19 @@ public:
 	bool loadPairingState(uint8_t* sessionKey, size_t keyLen, bool& isPaired);
 	bool clearPairingState();
 	
+	// Dernier REQ de contrôle de débit accepté (anti-rejeu), effacé avec l'appairage
+	bool loadRateReqGuard(uint32_t& senderId, uint32_t& seq);
+	bool saveRateReqGuard(uint32_t senderId, uint32_t seq);
+	
 	// Gestion du Device ID
 	bool loadDeviceId(uint32_t& deviceId);
 	bool saveDeviceId(uint32_t deviceId);
 	
+	// Empreinte de la dernière configuration radio écrite (évite le mode config au démarrage)
+	bool loadRadioConfigFingerprint(uint32_t& fingerprint);
+	bool saveRadioConfigFingerprint(uint32_t fingerprint);
+	bool clearRadioConfigFingerprint();
+	
 private:
 	Preferences nvs;
 	bool begin();
@@ -0,0 +1,46 @@
+#ifndef AIR_TIME_H
+#define AIR_TIME_H
+
+#include <Arduino.h>
+#include <math.h>
+
+/**
+ * Temps d'occupation du canal (time-on-air) d'une trame, en microsecondes
+ */
+namespace AirTime {
+
+/**
+ * Modulation LoRa (formule Semtech AN1200.13, SX127x / LLCC68)
+ * @param payloadLen Octets de charge utile
+ * @param sf Spreading factor (6-12)
+ * @param bandwidthHz Bande passante (ex. 125000)
+ * @param codingRateDenom Dénominateur du coding rate (5 pour 4/5 ... 8 pour 4/8)
+ */
+inline uint32_t loraUs(size_t payloadLen, uint8_t sf, uint32_t bandwidthHz, uint8_t codingRateDenom,
+                       uint16_t preambleLen = 8, bool crc = true, bool explicitHeader = true) {
+	const float tSymUs = (float)(1UL << sf) * 1e6f / (float)bandwidthHz;
+	// Low data rate optimize : imposé au-delà de 16 ms par symbole
+	const int de = (tSymUs > 16000.0f) ? 1 : 0;
+	const float num = 8.0f * payloadLen - 4.0f * sf + 28.0f + (crc ? 16.0f : 0.0f) - (explicitHeader ? 0.0f : 20.0f);
+	float payloadSymbols = ceilf(num / (4.0f * (sf - 2 * de))) * (float)codingRateDenom;
+	if (payloadSymbols < 0.0f) payloadSymbols = 0.0f;
+	payloadSymbols += 8.0f;
+	
+	const float preambleUs = ((float)preambleLen + 4.25f) * tSymUs;
+	return (uint32_t)(preambleUs + payloadSymbols * tSymUs);
+}
+
+/**
+ * E220 (LLCC68 en mode transparent)
+ * Ebyte ne publie pas les SF/BW derrière chaque débit air : estimation à partir
+ * du débit nominal, majorée d'un surcoût fixe équivalent préambule + en-tête + CRC.
+ */
+static const uint8_t E220_FRAME_OVERHEAD_BYTES = 12;
+
+inline uint32_t e220Us(size_t payloadLen, uint32_t airRateBps) {
+	return (uint32_t)(((uint64_t)(payloadLen + E220_FRAME_OVERHEAD_BYTES) * 8ULL * 1000000ULL) / airRateBps);
+}
+
+} // namespace AirTime
+
+#endif // AIR_TIME_H
@@ -0,0 +1,51 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <Arduino.h>
+
+/**
+ * Décomposition du temps de démarrage (étapes de setup())
+ * mark() clôt l'étape en cours ; print() affiche la durée de chacune.
+ */
+class BootProfiler {
+public:
+	static const uint8_t MAX_STAGES = 12;
+	
+	BootProfiler() : count(0), startMs(millis()), lastMs(startMs) {}
+	
+	void mark(const char* label) {
+		const unsigned long now = millis();
+		if (count < MAX_STAGES) {
+			labels[count] = label;
+			durations[count] = now - lastMs;
+			count++;
+		}
+		lastMs = now;
+	}
+	
+	void print() const {
+		Serial.println("[BOOT] Temps de démarrage:");
+		Serial.print("  avant setup(): ");
+		Serial.print(startMs);
+		Serial.println(" ms");
+		for (uint8_t i = 0; i < count; i++) {
+			Serial.print("  ");
+			Serial.print(labels[i]);
+			Serial.print(": ");
+			Serial.print(durations[i]);
+			Serial.println(" ms");
+		}
+		Serial.print("  total: ");
+		Serial.print(lastMs);
+		Serial.println(" ms depuis le reset");
+	}
+	
+private:
+	const char* labels[MAX_STAGES];
+	unsigned long durations[MAX_STAGES];
+	uint8_t count;
+	unsigned long startMs;
+	unsigned long lastMs;
+};
+
+#endif // BOOT_PROFILER_H
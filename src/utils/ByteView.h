@@ -0,0 +1,38 @@
+#ifndef BYTE_VIEW_H
+#define BYTE_VIEW_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Vue non propriétaire sur une suite d'octets (pointeur + longueur)
+ * Permet de passer un paquet reçu aux handlers sans copie ni allocation.
+ * La vue n'est valide que tant que le buffer sous-jacent n'est pas réutilisé.
+ */
+class ByteView {
+public:
+	ByteView() : ptr(nullptr), len(0) {}
+	ByteView(const uint8_t* data, size_t size) : ptr(data), len(size) {}
+	ByteView(const std::vector<uint8_t>& v) : ptr(v.data()), len(v.size()) {}
+	
+	const uint8_t* data() const { return ptr; }
+	size_t size() const { return len; }
+	bool empty() const { return len == 0; }
+	
+	const uint8_t& operator[](size_t i) const { return ptr[i]; }
+	const uint8_t* begin() const { return ptr; }
+	const uint8_t* end() const { return ptr + len; }
+	
+	// Sous-vue à partir de offset (vide si offset hors limites)
+	ByteView subview(size_t offset) const {
+		if (offset >= len) return ByteView();
+		return ByteView(ptr + offset, len - offset);
+	}
+	
+private:
+	const uint8_t* ptr;
+	size_t len;
+};
+
+#endif // BYTE_VIEW_H
@@ -0,0 +1,81 @@
+#include "DutyCycleBudget.h"
+#include "Log.h"
+
+DutyCycleBudget::DutyCycleBudget(uint16_t permille, unsigned long windowMs) {
+	configure(permille, windowMs);
+}
+
+void DutyCycleBudget::configure(uint16_t permille, unsigned long windowMs) {
+	this->permille = permille;
+	bucketMs = windowMs / BUCKET_COUNT;
+	if (bucketMs == 0) bucketMs = 1;
+	// windowMs * 1000 * permille / 1000 = windowMs * permille (en µs)
+	budgetUs = (uint32_t)((uint64_t)windowMs * permille);
+	memset(buckets, 0, sizeof(buckets));
+	current = 0;
+	bucketStartMs = millis();
+}
+
+void DutyCycleBudget::advance() {
+	const unsigned long now = millis();
+	const unsigned long steps = (now - bucketStartMs) / bucketMs;
+	if (steps == 0) return;
+	
+	if (steps >= BUCKET_COUNT) {
+		memset(buckets, 0, sizeof(buckets));
+	} else {
+		for (unsigned long i = 0; i < steps; i++) {
+			current = (current + 1) % BUCKET_COUNT;
+			buckets[current] = 0;
+		}
+	}
+	bucketStartMs += steps * bucketMs;
+}
+
+uint32_t DutyCycleBudget::getUsedUs() {
+	advance();
+	uint32_t used = 0;
+	for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+		used += buckets[i];
+	}
+	return used;
+}
+
+bool DutyCycleBudget::allows(uint32_t airtimeUs, TxPriority prio) {
+	if (!isEnabled()) return true;
+	
+	uint32_t share = budgetUs;
+	if (prio == TX_PRIO_LOW) {
+		share = (uint32_t)((uint64_t)budgetUs * LOW_PRIORITY_SHARE_PCT / 100);
+	} else if (prio == TX_PRIO_NORMAL) {
+		share = (uint32_t)((uint64_t)budgetUs * NORMAL_PRIORITY_SHARE_PCT / 100);
+	}
+	return (uint64_t)getUsedUs() + airtimeUs <= share;
+}
+
+void DutyCycleBudget::spend(uint32_t airtimeUs) {
+	advance();
+	buckets[current] += airtimeUs;
+}
+
+void DutyCycleBudget::print(const char* label) {
+	LogSerialLock lock;
+	Serial.print("[DUTY] ");
+	Serial.print(label);
+	Serial.print(": ");
+	if (!isEnabled()) {
+		Serial.println("pas de limite");
+		return;
+	}
+	const uint32_t used = getUsedUs();
+	Serial.print(used / 1000);
+	Serial.print(" / ");
+	Serial.print(budgetUs / 1000);
+	Serial.print(" ms sur ");
+	Serial.print(bucketMs * BUCKET_COUNT / 1000);
+	Serial.print(" s (");
+	Serial.print(permille / 10.0f, 1);
+	Serial.print(" % autorisé, ");
+	Serial.print(budgetUs ? (float)used * 100.0f / budgetUs : 0.0f, 1);
+	Serial.println(" % consommé)");
+}
@@ -0,0 +1,55 @@
+#ifndef DUTY_CYCLE_BUDGET_H
+#define DUTY_CYCLE_BUDGET_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "../Config.h"
+
+// Priorité d'émission : détermine la part du budget accessible et l'ordre de la file TX
+enum TxPriority : uint8_t {
+	TX_PRIO_LOW = 0,     // beacons, heartbeats, télémétrie périodique (abandonnés si budget serré)
+	TX_PRIO_NORMAL = 1,  // données applicatives (différées)
+	TX_PRIO_HIGH = 2     // ACK, appairage, contrôle (différés, accès à tout le budget)
+};
+
+/**
+ * Budget de duty cycle sur fenêtre glissante (ex. 1 % par heure)
+ *
+ * La fenêtre est découpée en BUCKET_COUNT tranches ; le temps d'antenne
+ * consommé est sommé sur les tranches encore dans la fenêtre.
+ * Chaque priorité n'a accès qu'à une part du budget : la réserve restante
+ * garde de la place pour les ACK et le contrôle quand le canal est chargé.
+ */
+class DutyCycleBudget {
+public:
+	static const uint8_t BUCKET_COUNT = 60;
+	static const uint8_t LOW_PRIORITY_SHARE_PCT = 70;
+	static const uint8_t NORMAL_PRIORITY_SHARE_PCT = 90;
+	
+	// permille = 0 : pas de limite
+	explicit DutyCycleBudget(uint16_t permille = 0, unsigned long windowMs = DUTY_CYCLE_WINDOW_MS);
+	
+	void configure(uint16_t permille, unsigned long windowMs = DUTY_CYCLE_WINDOW_MS);
+	bool isEnabled() const { return permille > 0; }
+	
+	// La trame peut-elle partir maintenant sans dépasser la part de sa priorité ?
+	bool allows(uint32_t airtimeUs, TxPriority prio);
+	void spend(uint32_t airtimeUs);
+	
+	uint32_t getUsedUs();
+	uint32_t getBudgetUs() const { return budgetUs; }
+	
+	void print(const char* label);
+	
+private:
+	uint32_t buckets[BUCKET_COUNT];
+	uint8_t current;
+	unsigned long bucketStartMs;
+	unsigned long bucketMs;
+	uint32_t budgetUs;
+	uint16_t permille;
+	
+	void advance();
+};
+
+#endif // DUTY_CYCLE_BUDGET_H
@@ -0,0 +1,110 @@
+#include "ErasureCode.h"
+#include <vector>
+#include <cstring>
+
+uint8_t ErasureCode::gfExp[512];
+uint8_t ErasureCode::gfLog[256];
+bool ErasureCode::tablesReady = false;
+
+void ErasureCode::initTables() {
+	if (tablesReady) return;
+	// Polynôme primitif x^8 + x^4 + x^3 + x^2 + 1 (0x11D), générateur 2
+	uint16_t x = 1;
+	for (uint16_t i = 0; i < 255; i++) {
+		gfExp[i] = (uint8_t)x;
+		gfLog[x] = (uint8_t)i;
+		x <<= 1;
+		if (x & 0x100) x ^= 0x11D;
+	}
+	// Table doublée : exp[log a + log b] sans réduction modulo 255
+	for (uint16_t i = 255; i < 512; i++) {
+		gfExp[i] = gfExp[i - 255];
+	}
+	gfLog[0] = 0;
+	tablesReady = true;
+}
+
+uint8_t ErasureCode::mul(uint8_t a, uint8_t b) {
+	if (a == 0 || b == 0) return 0;
+	return gfExp[gfLog[a] + gfLog[b]];
+}
+
+uint8_t ErasureCode::inv(uint8_t a) {
+	return gfExp[255 - gfLog[a]];
+}
+
+uint8_t ErasureCode::coefficient(uint16_t id, uint16_t col, uint16_t k) {
+	if (id < k) {
+		return (id == col) ? 1 : 0;
+	}
+	// x_j + y_i en GF(2^8) : jamais nul car id >= k > col
+	return inv((uint8_t)(id ^ col));
+}
+
+void ErasureCode::mulAdd(uint8_t* dst, const uint8_t* src, uint8_t factor, size_t len) {
+	if (factor == 0) return;
+	const uint16_t logF = gfLog[factor];
+	for (size_t i = 0; i < len; i++) {
+		if (src[i] != 0) {
+			dst[i] ^= gfExp[logF + gfLog[src[i]]];
+		}
+	}
+}
+
+void ErasureCode::encodeParity(const uint8_t* data, uint16_t k, size_t symLen,
+                               uint16_t parityIndex, uint8_t* out) {
+	initTables();
+	memset(out, 0, symLen);
+	const uint16_t id = k + parityIndex;
+	for (uint16_t i = 0; i < k; i++) {
+		mulAdd(out, data + (size_t)i * symLen, coefficient(id, i, k), symLen);
+	}
+}
+
+bool ErasureCode::decode(const uint8_t* const* symbols, const uint16_t* ids, uint16_t k,
+                         size_t symLen, uint8_t* out) {
+	if (k == 0 || k > MAX_SYMBOLS) return false;
+	initTables();
+	
+	// Système A * D = S : ligne r de A = coefficients du symbole reçu ids[r]
+	std::vector<uint8_t> a((size_t)k * k);
+	for (uint16_t r = 0; r < k; r++) {
+		if (ids[r] >= MAX_SYMBOLS) return false;
+		for (uint16_t c = 0; c < k; c++) {
+			a[(size_t)r * k + c] = coefficient(ids[r], c, k);
+		}
+		memcpy(out + (size_t)r * symLen, symbols[r], symLen);
+	}
+	
+	// Gauss-Jordan : les mêmes opérations sur les lignes de out donnent D
+	std::vector<uint8_t> tmp(symLen > k ? symLen : k);
+	for (uint16_t c = 0; c < k; c++) {
+		uint16_t pivot = c;
+		while (pivot < k && a[(size_t)pivot * k + c] == 0) pivot++;
+		if (pivot == k) return false; // index en double
+		
+		if (pivot != c) {
+			memcpy(tmp.data(), &a[(size_t)pivot * k], k);
+			memcpy(&a[(size_t)pivot * k], &a[(size_t)c * k], k);
+			memcpy(&a[(size_t)c * k], tmp.data(), k);
+			memcpy(tmp.data(), out + (size_t)pivot * symLen, symLen);
+			memcpy(out + (size_t)pivot * symLen, out + (size_t)c * symLen, symLen);
+			memcpy(out + (size_t)c * symLen, tmp.data(), symLen);
+		}
+		
+		const uint8_t scale = inv(a[(size_t)c * k + c]);
+		if (scale != 1) {
+			for (uint16_t j = 0; j < k; j++) a[(size_t)c * k + j] = mul(a[(size_t)c * k + j], scale);
+			uint8_t* row = out + (size_t)c * symLen;
+			for (size_t j = 0; j < symLen; j++) row[j] = mul(row[j], scale);
+		}
+		
+		for (uint16_t r = 0; r < k; r++) {
+			const uint8_t f = a[(size_t)r * k + c];
+			if (r == c || f == 0) continue;
+			mulAdd(&a[(size_t)r * k], &a[(size_t)c * k], f, k);
+			mulAdd(out + (size_t)r * symLen, out + (size_t)c * symLen, f, symLen);
+		}
+	}
+	return true;
+}
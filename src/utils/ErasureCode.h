@@ -0,0 +1,49 @@
+#ifndef ERASURE_CODE_H
+#define ERASURE_CODE_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Code d'effacement Reed-Solomon systématique sur GF(2^8) (matrice de Cauchy)
+ *
+ * Un bloc de k symboles de données de symLen octets est complété par m
+ * symboles de parité ; n'importe quels k des k + m symboles suffisent à
+ * reconstruire le bloc. Les symboles 0..k-1 sont les données elles-mêmes,
+ * le symbole de parité j vaut somme_i D_i / (x_j + y_i) avec y_i = i et
+ * x_j = k + j : toute sous-matrice carrée d'une matrice de Cauchy est
+ * inversible, d'où la propriété MDS tant que k + m <= 256.
+ */
+class ErasureCode {
+public:
+	static const uint16_t MAX_SYMBOLS = 256; // k + m
+	
+	// Symbole de parité parityIndex (0..m-1) du bloc data (k symboles contigus)
+	static void encodeParity(const uint8_t* data, uint16_t k, size_t symLen,
+	                         uint16_t parityIndex, uint8_t* out);
+	
+	/**
+	 * Reconstruit les k symboles de données dans out (k * symLen octets)
+	 * @param symbols k symboles reçus, dans n'importe quel ordre
+	 * @param ids Index (0..k+m-1) de chaque symbole reçu, tous distincts
+	 * @return false si les index sont invalides ou en double
+	 */
+	static bool decode(const uint8_t* const* symbols, const uint16_t* ids, uint16_t k,
+	                   size_t symLen, uint8_t* out);
+
+private:
+	static uint8_t gfExp[512];
+	static uint8_t gfLog[256];
+	static bool tablesReady;
+	
+	static void initTables();
+	static uint8_t mul(uint8_t a, uint8_t b);
+	static uint8_t inv(uint8_t a);
+	// Coefficient de la ligne id (donnée ou parité) pour la colonne col
+	static uint8_t coefficient(uint16_t id, uint16_t col, uint16_t k);
+	// dst ^= factor * src
+	static void mulAdd(uint8_t* dst, const uint8_t* src, uint8_t factor, size_t len);
+};
+
+#endif // ERASURE_CODE_H
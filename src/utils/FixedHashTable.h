@@ -0,0 +1,197 @@
+#ifndef FIXED_HASH_TABLE_H
+#define FIXED_HASH_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Clé d'un transfert fragmenté : adresse radio du pair et numéro de séquence
+struct PeerSeqKey {
+	uint16_t peer;
+	uint32_t seq;
+	
+	bool operator==(const PeerSeqKey& other) const { return peer == other.peer && seq == other.seq; }
+};
+
+// Plus petite puissance de 2 >= n
+static constexpr uint16_t hashBucketCount(uint32_t n, uint32_t p = 1) {
+	return p >= n ? (uint16_t)p : hashBucketCount(n, p * 2);
+}
+
+/**
+ * Table de hachage à capacité fixe, adresses stables, clé (pair, séquence)
+ *
+ * Les N valeurs occupent un tableau alloué une fois : un pointeur obtenu par
+ * find() ou insert() reste valide jusqu'à erase() de cette entrée, quoi qu'il
+ * arrive aux autres (pas de réallocation comme avec push_back). Un second
+ * tableau d'index, au moins deux fois plus grand et en puissance de 2, sert
+ * l'adressage ouvert (sondage linéaire). La suppression décale les index
+ * suivants au lieu de laisser des pierres tombales : recherche, insertion et
+ * suppression en O(1), même après des milliers de transferts.
+ *
+ * Les entrées sont chaînées par ordre d'insertion : oldest() / next()
+ * parcourent du plus ancien au plus récent, et l'expiration s'arrête à la
+ * première entrée encore valide.
+ *
+ * Un seul contexte d'exécution (loop()) : pas de synchronisation.
+ */
+template <class V, uint16_t N>
+class FixedHashTable {
+	static_assert(N >= 1 && N <= 0x4000, "FixedHashTable: N hors limites");
+	
+	static const uint16_t NONE = 0xFFFF;
+	
+	// Taux de remplissage au plus 1/2 : sondages courts
+	static const uint16_t BUCKETS = hashBucketCount(2u * N);
+	static const uint16_t MASK = BUCKETS - 1;
+
+public:
+	FixedHashTable() : head(NONE), tail(NONE), freeCount(N), highWatermark(0), fullCount(0) {
+		for (uint16_t i = 0; i < BUCKETS; i++) {
+			buckets[i] = NONE;
+		}
+		for (uint16_t i = 0; i < N; i++) {
+			freeStack[i] = N - 1 - i;
+		}
+	}
+	
+	V* find(const PeerSeqKey& key) {
+		const uint16_t e = lookup(key);
+		return (e == NONE) ? nullptr : &values[e];
+	}
+	const V* find(const PeerSeqKey& key) const {
+		const uint16_t e = lookup(key);
+		return (e == NONE) ? nullptr : &values[e];
+	}
+	
+	// Nouvelle entrée en fin d'ordre (clé absente, valeur à initialiser par
+	// l'appelant) ; nullptr si la table est pleine (compté)
+	V* insert(const PeerSeqKey& key) {
+		if (freeCount == 0) {
+			fullCount++;
+			return nullptr;
+		}
+		const uint16_t e = freeStack[--freeCount];
+		if (N - freeCount > highWatermark) {
+			highWatermark = N - freeCount;
+		}
+		
+		uint16_t b = hashOf(key);
+		while (buckets[b] != NONE) {
+			b = (b + 1) & MASK;
+		}
+		buckets[b] = e;
+		
+		Node& node = nodes[e];
+		node.key = key;
+		node.prev = tail;
+		node.next = NONE;
+		if (tail != NONE) {
+			nodes[tail].next = e;
+		} else {
+			head = e;
+		}
+		tail = e;
+		return &values[e];
+	}
+	
+	// Retire l'entrée (pointeur obtenu de cette table) ; les autres ne bougent pas
+	void erase(const V* value) {
+		const uint16_t e = (uint16_t)(value - values);
+		if (e >= N) return;
+		
+		uint16_t b = hashOf(nodes[e].key);
+		while (buckets[b] != e) {
+			if (buckets[b] == NONE) return; // déjà retirée
+			b = (b + 1) & MASK;
+		}
+		removeBucket(b);
+		
+		Node& node = nodes[e];
+		if (node.prev != NONE) {
+			nodes[node.prev].next = node.next;
+		} else {
+			head = node.next;
+		}
+		if (node.next != NONE) {
+			nodes[node.next].prev = node.prev;
+		} else {
+			tail = node.prev;
+		}
+		freeStack[freeCount++] = e;
+	}
+	
+	// --- Parcours par ordre d'insertion (erase() de l'entrée courante permis
+	// après avoir lu next()) ---
+	
+	V* oldest() { return (head == NONE) ? nullptr : &values[head]; }
+	const V* oldest() const { return (head == NONE) ? nullptr : &values[head]; }
+	V* next(const V* value) {
+		const uint16_t n = nodes[value - values].next;
+		return (n == NONE) ? nullptr : &values[n];
+	}
+	const V* next(const V* value) const {
+		const uint16_t n = nodes[value - values].next;
+		return (n == NONE) ? nullptr : &values[n];
+	}
+	
+	// --- Statistiques ---
+	
+	bool empty() const { return freeCount == N; }
+	bool full() const { return freeCount == 0; }
+	uint16_t size() const { return N - freeCount; }
+	static uint16_t capacity() { return N; }
+	uint16_t getHighWatermark() const { return highWatermark; }
+	uint32_t getFullCount() const { return fullCount; }   // insertions refusées
+
+private:
+	struct Node {
+		PeerSeqKey key;
+		uint16_t prev;        // ordre d'insertion
+		uint16_t next;
+	};
+	
+	V values[N];
+	Node nodes[N];
+	uint16_t buckets[BUCKETS];   // index d'entrée, NONE : case vide
+	uint16_t freeStack[N];
+	uint16_t head;               // plus ancienne entrée
+	uint16_t tail;               // plus récente
+	uint16_t freeCount;
+	uint16_t highWatermark;
+	uint32_t fullCount;
+	
+	static uint16_t hashOf(const PeerSeqKey& key) {
+		// Hachage multiplicatif (Knuth) : les séquences consécutives d'un même
+		// pair se répartissent sur toute la table
+		const uint32_t h = (key.seq ^ ((uint32_t)key.peer << 16)) * 0x9E3779B1u;
+		return (uint16_t)(h >> 16) & MASK;
+	}
+	
+	uint16_t lookup(const PeerSeqKey& key) const {
+		uint16_t b = hashOf(key);
+		while (buckets[b] != NONE) {
+			if (nodes[buckets[b]].key == key) return buckets[b];
+			b = (b + 1) & MASK;
+		}
+		return NONE;
+	}
+	
+	// Suppression sans pierre tombale : chaque index suivant du même groupe
+	// remonte dans le trou s'il y reste joignable depuis sa case d'origine
+	void removeBucket(uint16_t hole) {
+		uint16_t b = hole;
+		for (;;) {
+			b = (b + 1) & MASK;
+			const uint16_t e = buckets[b];
+			if (e == NONE) break;
+			const uint16_t home = hashOf(nodes[e].key);
+			if (((b - home) & MASK) >= ((b - hole) & MASK)) {
+				buckets[hole] = e;
+				hole = b;
+			}
+		}
+		buckets[hole] = NONE;
+	}
+};
+
+#endif // FIXED_HASH_TABLE_H
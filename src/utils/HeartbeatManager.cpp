@@ -1,30 +1,73 @@
 #include "HeartbeatManager.h"
+#ifdef RADIO_SIM
+#include "../sim/SimRadio.h"
+#else
+#include "../lora/LoRaModule.h"
+#include "../lora/XL1278Module.h"
+#endif
+#include "Log.h"
 #include <cstring>
 
-HeartbeatManager::HeartbeatManager(SecurityManager* security, LoRaModule* lora)
-	: security(security), lora(lora), lastHeartbeatSentMs(0), lastHeartbeatReceivedMs(0),
-	  lastStatusUpdateMs(0), lastOnlineStateSent(false) {
+template <class Radio>
+const uint8_t HeartbeatManager<Radio>::RSSI_REPORT_UNKNOWN;
+
+template <class Radio>
+HeartbeatManager<Radio>::HeartbeatManager(SecurityManager* security, Radio* lora)
+	: security(security), lora(lora), linkQuality(nullptr), lastHeartbeatSentMs(0), jitterMs(0),
+	  lastHeartbeatReceivedMs(0), lastStatusUpdateMs(0), lastOnlineStateSent(false),
+	  intervalMs(HEARTBEAT_INTERVAL_MS), timeoutMs(HEARTBEAT_TIMEOUT_MS), replyOnly(false),
+	  peerHeard(false), peerRssi(0), rssiReportPending(false), reportedRssi(0) {
+}
+
+template <class Radio>
+void HeartbeatManager<Radio>::setInterval(unsigned long interval) {
+	intervalMs = interval;
+	timeoutMs = 3 * interval;
+	jitterMs = 0;
+}
+
+template <class Radio>
+unsigned long HeartbeatManager<Radio>::msUntilNextHeartbeat() const {
+	const unsigned long elapsed = millis() - lastHeartbeatSentMs;
+	return elapsed >= currentPeriodMs() ? 0 : currentPeriodMs() - elapsed;
+}
+
+template <class Radio>
+bool HeartbeatManager<Radio>::takeRssiReport(int& rssi) {
+	if (!rssiReportPending) return false;
+	rssiReportPending = false;
+	rssi = reportedRssi;
+	return true;
 }
 
-void HeartbeatManager::sendHeartbeat(uint32_t deviceId, const uint8_t* sessionKey) {
+template <class Radio>
+void HeartbeatManager<Radio>::sendHeartbeat(uint32_t deviceId, const uint8_t* sessionKey) {
 	std::vector<uint8_t> pkt;
-	pkt.reserve(1 + 4 + 16);
+	pkt.reserve(1 + 4 + 1 + 16);
 	pkt.push_back((uint8_t)PKT_HEARTBEAT);
 	pkt.push_back((deviceId >> 24) & 0xFF);
 	pkt.push_back((deviceId >> 16) & 0xFF);
 	pkt.push_back((deviceId >> 8) & 0xFF);
 	pkt.push_back(deviceId & 0xFF);
+	// Retour pour le contrôle de puissance du pair
+	if (peerHeard) {
+		const int level = -peerRssi;
+		pkt.push_back((uint8_t)(level < 0 ? 0 : (level > 254 ? 254 : level)));
+	} else {
+		pkt.push_back(RSSI_REPORT_UNKNOWN);
+	}
 	
 	uint8_t mac16[16];
 	security->hmacSha256Trunc16(sessionKey, 16, pkt.data(), pkt.size(), mac16);
 	pkt.insert(pkt.end(), mac16, mac16 + 16);
 	
-	lora->sendPacket(pkt);
+	lora->sendPacket(pkt, TX_PRIO_LOW, lora->getPeerAddress());
 }
 
-void HeartbeatManager::sendHeartbeatIfDue(uint32_t deviceId, const uint8_t* sessionKey, 
-                                          bool isPaired, bool isTransmitting) {
-	if (!isPaired) return;
+template <class Radio>
+void HeartbeatManager<Radio>::sendHeartbeatIfDue(uint32_t deviceId, const uint8_t* sessionKey, 
+                                                 bool isPaired, bool isTransmitting) {
+	if (!isPaired || replyOnly) return;
 	
 	// Ne bloquer les heartbeats que si une transmission est réellement en cours
 	// Les messages en attente d'ACK ne bloquent plus les heartbeats
@@ -34,15 +77,17 @@ void HeartbeatManager::sendHeartbeatIfDue(uint32_t deviceId, const uint8_t* sess
 	}
 	
 	const unsigned long now = millis();
-	if (now - lastHeartbeatSentMs < HEARTBEAT_INTERVAL_MS) return;
+	if (now - lastHeartbeatSentMs < currentPeriodMs()) return;
 	
 	lastHeartbeatSentMs = now;
+	jitterMs = esp_random() % (intervalMs / JITTER_DIVISOR + 1);
 	sendHeartbeat(deviceId, sessionKey);
 }
 
-bool HeartbeatManager::handleHeartbeat(const std::vector<uint8_t>& packet, 
-                                      const uint8_t* sessionKey, uint32_t deviceId, 
-                                      uint32_t& pairedDeviceId) {
+template <class Radio>
+bool HeartbeatManager<Radio>::handleHeartbeat(const ByteView& packet, 
+                                             const uint8_t* sessionKey, uint32_t deviceId, 
+                                             uint32_t& pairedDeviceId) {
 	if (packet.size() < 1 + 4 + 16) {
 		return false;
 	}
@@ -64,17 +109,35 @@ bool HeartbeatManager::handleHeartbeat(const std::vector<uint8_t>& packet,
 		return false;
 	}
 	
-	lastHeartbeatReceivedMs = millis();
+	peerHeard = true;
+	peerRssi = lora->getLastRssi();
+	// Octet de retour RSSI absent des heartbeats d'avant le contrôle de puissance
+	if (packet.size() >= 1 + 4 + 1 + 16 && packet[5] != RSSI_REPORT_UNKNOWN) {
+		reportedRssi = -(int)packet[5];
+		rssiReportPending = true;
+	}
+	
+	const unsigned long now = millis();
+	if (linkQuality) {
+		// Heartbeats périodiques : un trou dans la série = heartbeats perdus
+		linkQuality->recordLoss(senderId, LinkQualityTable::missedSince(lastHeartbeatReceivedMs, now,
+		                                                                intervalMs, timeoutMs));
+		linkQuality->recordRx(senderId, lora->getLastRssi(), lora->getLastSnr(), lora->hasSnr());
+	}
+	
+	lastHeartbeatReceivedMs = now;
 	bool wasOnline = (lastOnlineStateSent == true);
 	
 	if (pairedDeviceId == 0 || pairedDeviceId != senderId) {
 		pairedDeviceId = senderId;
+		LogSerialLock lock;
 		Serial.print("[HEARTBEAT] Device appairé détecté: 0x");
 		Serial.println(senderId, HEX);
 	}
 	
 	if (!wasOnline) {
 		lastOnlineStateSent = true;
+		LogSerialLock lock;
 		Serial.print("[STATUS] Device appairé en ligne: OUI");
 		if (pairedDeviceId != 0) {
 			Serial.print(" (ID: 0x");
@@ -84,16 +147,23 @@ bool HeartbeatManager::handleHeartbeat(const std::vector<uint8_t>& packet,
 		Serial.println();
 	}
 	
+	if (replyOnly) {
+		lastHeartbeatSentMs = now;
+		sendHeartbeat(deviceId, sessionKey);
+	}
+	
 	return true;
 }
 
-bool HeartbeatManager::isPairedDeviceOnline() const {
+template <class Radio>
+bool HeartbeatManager<Radio>::isPairedDeviceOnline() const {
 	if (lastHeartbeatReceivedMs == 0) return false;
 	const unsigned long now = millis();
-	return (now - lastHeartbeatReceivedMs) < HEARTBEAT_TIMEOUT_MS;
+	return (now - lastHeartbeatReceivedMs) < timeoutMs;
 }
 
-void HeartbeatManager::updateAndSendOnlineStatus(bool isPaired, uint32_t pairedDeviceId) {
+template <class Radio>
+void HeartbeatManager<Radio>::updateAndSendOnlineStatus(bool isPaired, uint32_t pairedDeviceId) {
 	const unsigned long now = millis();
 	if (now - lastStatusUpdateMs < STATUS_UPDATE_INTERVAL_MS) {
 		return;
@@ -111,6 +181,7 @@ void HeartbeatManager::updateAndSendOnlineStatus(bool isPaired, uint32_t pairedD
 	
 	if (online != lastOnlineStateSent) {
 		lastOnlineStateSent = online;
+		LogSerialLock lock;
 		Serial.print("[STATUS] Device appairé en ligne: ");
 		Serial.println(online ? "OUI" : "NON");
 		if (pairedDeviceId != 0) {
@@ -120,3 +191,10 @@ void HeartbeatManager::updateAndSendOnlineStatus(bool isPaired, uint32_t pairedD
 	}
 }
 
+// Instanciations explicites : une par driver radio
+#ifdef RADIO_SIM
+template class HeartbeatManager<SimRadio>;
+#else
+template class HeartbeatManager<LoRaModule>;
+template class HeartbeatManager<XL1278Module>;
+#endif
@@ -7,20 +7,43 @@
 #include "../Config.h"
 #include "../protocol/PacketTypes.h"
 #include "../security/SecurityManager.h"
-#include "../lora/LoRaModule.h"
+#include "../lora/RadioDriver.h"
+#include "../utils/LinkQualityTable.h"
 
+template <class Radio>
 class HeartbeatManager {
 public:
-	// Utilise les constantes de Config.h : HEARTBEAT_INTERVAL_MS et HEARTBEAT_TIMEOUT_MS
+	// Par défaut : HEARTBEAT_INTERVAL_MS et HEARTBEAT_TIMEOUT_MS (Config.h)
 	static const unsigned long STATUS_UPDATE_INTERVAL_MS = 500;
+	// Octet de retour RSSI : -dBm du dernier heartbeat reçu du pair, 0xFF = pas encore entendu
+	static const uint8_t RSSI_REPORT_UNKNOWN = 0xFF;
+	// Chaque période raccourcie d'un tirage dans [0, intervalle / JITTER_DIVISOR] :
+	// deux noeuds appairés au même instant ne restent pas en phase (semi-duplex)
+	static const unsigned long JITTER_DIVISOR = 10;
 	
-	HeartbeatManager(SecurityManager* security, LoRaModule* lora);
+	HeartbeatManager(SecurityManager* security, Radio* lora);
+	
+	// Optionnel : alimente la table de qualité de lien à chaque heartbeat
+	void setLinkQualityTable(LinkQualityTable* table) { linkQuality = table; }
+	
+	// Profil WOR : période alignée sur le réveil du noeud sur batterie
+	// (timeout = 3 périodes, comme HEARTBEAT_TIMEOUT_MS / HEARTBEAT_INTERVAL_MS)
+	void setInterval(unsigned long intervalMs);
+	// Pas d'envoi périodique : un heartbeat part en réponse à chaque heartbeat reçu,
+	// pendant que le pair endormi est encore à l'écoute
+	void setReplyOnly(bool on) { replyOnly = on; }
+	// Temps avant le prochain heartbeat périodique (0 = dû)
+	unsigned long msUntilNextHeartbeat() const;
+	
+	// RSSI auquel le pair reçoit nos trames (retour porté par son heartbeat).
+	// Retourne true une seule fois par heartbeat reçu.
+	bool takeRssiReport(int& rssi);
 	
 	// Envoi de heartbeat
 	void sendHeartbeatIfDue(uint32_t deviceId, const uint8_t* sessionKey, bool isPaired, bool isTransmitting);
 	
 	// Réception de heartbeat
-	bool handleHeartbeat(const std::vector<uint8_t>& packet, const uint8_t* sessionKey, uint32_t deviceId, uint32_t& pairedDeviceId);
+	bool handleHeartbeat(const ByteView& packet, const uint8_t* sessionKey, uint32_t deviceId, uint32_t& pairedDeviceId);
 	
 	// Vérification de l'état en ligne
 	bool isPairedDeviceOnline() const;
@@ -30,14 +53,26 @@ public:
 	
 private:
 	SecurityManager* security;
-	LoRaModule* lora;
+	Radio* lora;
+	LinkQualityTable* linkQuality;
 	
 	unsigned long lastHeartbeatSentMs;
+	unsigned long jitterMs;           // avance de la période en cours
 	unsigned long lastHeartbeatReceivedMs;
 	unsigned long lastStatusUpdateMs;
 	bool lastOnlineStateSent;
+	unsigned long intervalMs;
+	unsigned long timeoutMs;
+	bool replyOnly;
+	
+	// RSSI du pair mesuré ici (renvoyé dans nos heartbeats) et retour reçu du pair
+	bool peerHeard;
+	int peerRssi;
+	bool rssiReportPending;
+	int reportedRssi;
 	
 	void sendHeartbeat(uint32_t deviceId, const uint8_t* sessionKey);
+	unsigned long currentPeriodMs() const { return intervalMs - jitterMs; }
 };
 
 #endif // HEARTBEAT_MANAGER_H
@@ -0,0 +1,120 @@
+#include "LinkQualityTable.h"
+#include "Log.h"
+
+constexpr float LinkQualityTable::EWMA_ALPHA;
+
+LinkQualityTable::LinkQualityTable() : count(0) {
+}
+
+LinkQuality* LinkQualityTable::findOrCreate(uint32_t id) {
+	for (uint8_t i = 0; i < count; i++) {
+		if (entries[i].id == id) return &entries[i];
+	}
+	
+	uint8_t slot = count;
+	if (count < MAX_PEERS) {
+		count++;
+	} else {
+		// Table pleine : remplacer le pair vu le plus anciennement
+		const unsigned long now = millis();
+		slot = 0;
+		for (uint8_t i = 1; i < MAX_PEERS; i++) {
+			if (now - entries[i].lastSeenMs > now - entries[slot].lastSeenMs) {
+				slot = i;
+			}
+		}
+	}
+	
+	LinkQuality& e = entries[slot];
+	e.id = id;
+	e.rssiEwma = 0.0f;
+	e.snrEwma = 0.0f;
+	e.perEwma = 0.0f;
+	e.lastRssi = 0;
+	e.hasSnr = false;
+	e.rxCount = 0;
+	e.lossCount = 0;
+	e.lastSeenMs = millis();
+	return &e;
+}
+
+void LinkQualityTable::recordRx(uint32_t id, int rssi, float snr, bool hasSnr) {
+	LinkQuality* e = findOrCreate(id);
+	
+	if (e->rxCount == 0) {
+		// Premier échantillon : initialise la moyenne
+		e->rssiEwma = (float)rssi;
+		e->snrEwma = snr;
+	} else {
+		e->rssiEwma += EWMA_ALPHA * ((float)rssi - e->rssiEwma);
+		e->snrEwma += EWMA_ALPHA * (snr - e->snrEwma);
+	}
+	e->perEwma -= EWMA_ALPHA * e->perEwma;
+	e->lastRssi = rssi;
+	e->hasSnr = hasSnr;
+	e->rxCount++;
+	e->lastSeenMs = millis();
+}
+
+void LinkQualityTable::recordLoss(uint32_t id, uint16_t lost) {
+	if (lost == 0) return;
+	LinkQuality* e = findOrCreate(id);
+	
+	for (uint16_t i = 0; i < lost; i++) {
+		e->perEwma += EWMA_ALPHA * (1.0f - e->perEwma);
+	}
+	e->lossCount += lost;
+}
+
+uint16_t LinkQualityTable::missedSince(unsigned long lastSeenMs, unsigned long now,
+                                       unsigned long intervalMs, unsigned long maxGapMs) {
+	const unsigned long gap = now - lastSeenMs;
+	// Au-delà de maxGapMs, l'émetteur a pu s'arrêter volontairement : pas de pertes comptées
+	if (lastSeenMs == 0 || intervalMs == 0 || gap > maxGapMs) return 0;
+	
+	// Arrondi : une gigue d'une demi-période n'est pas une perte
+	const unsigned long periods = (gap + intervalMs / 2) / intervalMs;
+	return periods > 1 ? (uint16_t)(periods - 1) : 0;
+}
+
+const LinkQuality* LinkQualityTable::find(uint32_t id) const {
+	for (uint8_t i = 0; i < count; i++) {
+		if (entries[i].id == id) return &entries[i];
+	}
+	return nullptr;
+}
+
+void LinkQualityTable::print() const {
+	LogSerialLock lock;
+	Serial.println("[LINK] Qualité des liens:");
+	if (count == 0) {
+		Serial.println("  (aucun pair entendu)");
+		return;
+	}
+	
+	const unsigned long now = millis();
+	for (uint8_t i = 0; i < count; i++) {
+		const LinkQuality& e = entries[i];
+		Serial.print("  0x");
+		Serial.print(e.id, HEX);
+		Serial.print(" | RSSI ");
+		Serial.print(e.rssiEwma, 1);
+		Serial.print(" dBm (dernier ");
+		Serial.print(e.lastRssi);
+		Serial.print(")");
+		if (e.hasSnr) {
+			Serial.print(" | SNR ");
+			Serial.print(e.snrEwma, 1);
+			Serial.print(" dB");
+		}
+		Serial.print(" | PER ");
+		Serial.print(e.perEwma * 100.0f, 1);
+		Serial.print("% (");
+		Serial.print(e.rxCount);
+		Serial.print(" reçus, ");
+		Serial.print(e.lossCount);
+		Serial.print(" perdus) | Vu il y a ");
+		Serial.print((now - e.lastSeenMs) / 1000);
+		Serial.println("s");
+	}
+}
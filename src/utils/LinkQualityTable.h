@@ -0,0 +1,57 @@
+#ifndef LINK_QUALITY_TABLE_H
+#define LINK_QUALITY_TABLE_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "../Config.h"
+
+struct LinkQuality {
+	uint32_t id;
+	float rssiEwma;          // dBm
+	float snrEwma;           // dB (XL1278 uniquement)
+	float perEwma;           // taux d'erreur paquet estimé (0..1)
+	int lastRssi;
+	bool hasSnr;
+	uint32_t rxCount;
+	uint32_t lossCount;
+	unsigned long lastSeenMs;
+};
+
+/**
+ * Qualité de lien par pair : RSSI/SNR lissés (EWMA) et taux d'erreur paquet
+ *
+ * Table fixe (pas d'allocation) ; quand elle est pleine, l'entrée la plus
+ * anciennement vue est remplacée. Les pertes sont déduites par les managers
+ * (trous dans les émissions périodiques : beacons, heartbeats).
+ */
+class LinkQualityTable {
+public:
+	static const uint8_t MAX_PEERS = 8;
+	// Poids du nouvel échantillon (1/8, comme le lissage du RTT TCP)
+	static constexpr float EWMA_ALPHA = 0.125f;
+	
+	LinkQualityTable();
+	
+	// Paquet reçu de 'id' avec sa mesure radio
+	void recordRx(uint32_t id, int rssi, float snr, bool hasSnr);
+	// Paquets attendus de 'id' mais jamais reçus
+	void recordLoss(uint32_t id, uint16_t count);
+	
+	// Nombre de paquets manqués entre deux réceptions d'un émetteur périodique
+	static uint16_t missedSince(unsigned long lastSeenMs, unsigned long now,
+	                            unsigned long intervalMs, unsigned long maxGapMs);
+	
+	const LinkQuality* find(uint32_t id) const;
+	uint8_t size() const { return count; }
+	const LinkQuality& at(uint8_t i) const { return entries[i]; }
+	
+	void print() const;
+	
+private:
+	LinkQuality entries[MAX_PEERS];
+	uint8_t count;
+	
+	LinkQuality* findOrCreate(uint32_t id);
+};
+
+#endif // LINK_QUALITY_TABLE_H
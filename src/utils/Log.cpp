@@ -0,0 +1,225 @@
+#include "Log.h"
+#include "MpscRing.h"
+#include <cstdio>
+#ifndef RADIO_SIM
+#include <freertos/semphr.h>
+#endif
+
+static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0, "LOG_RING_SLOTS doit être une puissance de 2");
+static_assert(LOG_RECORD_DATA_SIZE >= 2 && LOG_RECORD_DATA_SIZE <= 255, "LOG_RECORD_DATA_SIZE hors limites");
+
+static const uint8_t LOG_SEGMENT_TRUNCATED = 0x01;
+static const size_t LOG_LINE_SIZE = 800; // hexa : 3 caractères par octet
+
+// Fichier unique : tous les modes et la simulation partagent la même file
+static MpscRing<LogRecord, LOG_RING_SLOTS> logRing;
+
+#ifndef RADIO_SIM
+static TaskHandle_t logTask = nullptr;
+static SemaphoreHandle_t serialMutex = nullptr;
+static uint32_t reportedDrops = 0;
+#endif
+
+bool Log::begin() {
+#ifdef RADIO_SIM
+	return true;
+#else
+	if (logTask) return true;
+	// Créé avant la tâche : elle le prend pour chaque ligne
+	serialMutex = xSemaphoreCreateRecursiveMutex();
+	if (!serialMutex) {
+		Serial.println("[LOG] ERREUR: verrou série non créé");
+	}
+	if (xTaskCreatePinnedToCore(taskEntry, "log", LOG_TASK_STACK, nullptr,
+	                            LOG_TASK_PRIORITY, &logTask, LOG_TASK_CORE) != pdPASS) {
+		Serial.println("[LOG] ERREUR: tâche du journal non créée");
+		return false;
+	}
+	return true;
+#endif
+}
+
+LogRecord* Log::reserve() {
+	return logRing.reserve();
+}
+
+void Log::commit(LogRecord* rec) {
+	logRing.commit(rec);
+#ifdef RADIO_SIM
+	// Un seul fil d'exécution : afficher tout de suite, sous le préfixe du noeud courant
+	drain();
+#endif
+}
+
+void Log::pack(LogRecord& rec, const LogData& data) {
+	const size_t room = LOG_RECORD_DATA_SIZE - rec.dataLen;
+	if (room < 2) return;
+	size_t len = data.len;
+	uint8_t flags = 0;
+	if (len > room - 2) {
+		len = room - 2;
+		flags = LOG_SEGMENT_TRUNCATED;
+	}
+	rec.data[rec.dataLen++] = (uint8_t)len;
+	rec.data[rec.dataLen++] = flags;
+	if (len > 0) {
+		memcpy(rec.data + rec.dataLen, data.ptr, len);
+		rec.dataLen += (uint8_t)len;
+	}
+}
+
+void Log::drain() {
+	LogRecord* rec;
+	while ((rec = logRing.front()) != nullptr) {
+		emit(*rec);
+		logRing.pop();
+	}
+}
+
+void Log::emit(const LogRecord& rec) {
+	char line[LOG_LINE_SIZE];
+	const size_t len = format(rec, line, sizeof(line));
+	LogSerialLock lock;
+	Serial.write((const uint8_t*)line, len);
+}
+
+uint32_t Log::getDroppedCount() {
+	return logRing.getOverflowCount();
+}
+
+uint32_t Log::getHighWatermark() {
+	return logRing.getHighWatermark();
+}
+
+bool Log::lockSerial() {
+#ifdef RADIO_SIM
+	return false;
+#else
+	if (!serialMutex) return false;
+	return xSemaphoreTakeRecursive(serialMutex, portMAX_DELAY) == pdTRUE;
+#endif
+}
+
+void Log::unlockSerial() {
+#ifndef RADIO_SIM
+	xSemaphoreGiveRecursive(serialMutex);
+#endif
+}
+
+size_t Log::format(const LogRecord& rec, char* out, size_t capacity) {
+	if (capacity < 2) return 0;
+	const size_t limit = capacity - 1; // place du '\n' final
+	size_t n = 0;
+	uint8_t argIndex = 0;
+	uint8_t dataPos = 0;
+
+#ifdef LOG_TIMESTAMPS
+	n += snprintf(out, limit, "[%lu] ", (unsigned long)rec.timestampMs);
+	if (n > limit) n = limit;
+#endif
+	
+	for (const char* p = rec.fmt; *p && n < limit; p++) {
+		if (*p != '%') {
+			out[n++] = *p;
+			continue;
+		}
+		
+		// Spécification : %[0][largeur][.précision][l]conversion
+		char spec[16];
+		size_t s = 0;
+		spec[s++] = '%';
+		p++;
+		while ((*p == '0' || *p == '-') && s < 3) spec[s++] = *p++;
+		while (*p >= '0' && *p <= '9' && s < 8) spec[s++] = *p++;
+		if (*p == '.') {
+			spec[s++] = *p++;
+			while (*p >= '0' && *p <= '9' && s < 12) spec[s++] = *p++;
+		}
+		while (*p == 'l') p++;
+		const char conv = *p;
+		if (conv == '\0') break;
+		if (conv == '%') {
+			out[n++] = '%';
+			continue;
+		}
+		
+		if (conv == 't' || conv == 'p' || conv == 'h') {
+			if (dataPos + 2 > rec.dataLen) continue;
+			uint8_t segLen = rec.data[dataPos++];
+			const uint8_t flags = rec.data[dataPos++];
+			if (dataPos + segLen > rec.dataLen) segLen = rec.dataLen - dataPos;
+			const uint8_t* seg = rec.data + dataPos;
+			dataPos += segLen;
+			for (uint8_t i = 0; i < segLen && n < limit; i++) {
+				if (conv == 't') {
+					out[n++] = (char)seg[i];
+				} else if (conv == 'p') {
+					out[n++] = (seg[i] >= 32 && seg[i] < 127) ? (char)seg[i] : '.';
+				} else {
+					n += snprintf(out + n, capacity - n, "%02X ", seg[i]);
+					if (n > limit) n = limit;
+				}
+			}
+			if ((flags & LOG_SEGMENT_TRUNCATED) && n < limit) {
+				n += snprintf(out + n, capacity - n, "...");
+				if (n > limit) n = limit;
+			}
+			continue;
+		}
+		
+		if (argIndex >= rec.argCount) continue;
+		const LogArg& arg = rec.args[argIndex++];
+		spec[s++] = conv;
+		spec[s] = '\0';
+		
+		int written = 0;
+		switch (conv) {
+			case 'd':
+			case 'i':
+				written = snprintf(out + n, capacity - n, spec, (int)(int32_t)arg.u);
+				break;
+			case 'u':
+			case 'x':
+			case 'X':
+				written = snprintf(out + n, capacity - n, spec, (unsigned int)arg.u);
+				break;
+			case 'c':
+				written = snprintf(out + n, capacity - n, spec, (int)(char)arg.u);
+				break;
+			case 'f':
+				written = snprintf(out + n, capacity - n, spec, (double)arg.f);
+				break;
+			case 's':
+				written = snprintf(out + n, capacity - n, spec, arg.s ? arg.s : "(null)");
+				break;
+			default:
+				break;
+		}
+		if (written > 0) n += (size_t)written;
+		if (n > limit) n = limit;
+	}
+	
+	out[n++] = '\n';
+	return n;
+}
+
+void Log::taskEntry(void* arg) {
+	(void)arg;
+#ifndef RADIO_SIM
+	for (;;) {
+		if (!logRing.front()) {
+			const uint32_t dropped = logRing.getOverflowCount();
+			if (dropped != reportedDrops) {
+				LogSerialLock lock;
+				Serial.print("[LOG] ");
+				Serial.print(dropped - reportedDrops);
+				Serial.println(" enregistrement(s) perdu(s) (file pleine)");
+				reportedDrops = dropped;
+			}
+			vTaskDelay(pdMS_TO_TICKS(LOG_TASK_IDLE_MS));
+			continue;
+		}
+		drain();
+	}
+#endif
+}
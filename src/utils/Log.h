@@ -0,0 +1,171 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "../Config.h"
+
+/**
+ * Journal binaire différé : les chemins chauds n'écrivent plus sur Serial
+ *
+ * Un appel LOG_xxx copie dans un slot de file sans verrou (MpscRing) le
+ * pointeur du format, les arguments numériques et au plus quelques octets de
+ * texte ou de données ; une tâche de faible priorité formate et affiche
+ * ensuite les enregistrements. File pleine : l'enregistrement est perdu et
+ * compté, l'appelant n'attend jamais l'UART.
+ *
+ * Niveaux et catégories au-dessus de LOG_LEVEL / hors de LOG_CATEGORIES
+ * (Config.h) disparaissent à la compilation, format compris.
+ *
+ * Format (sous-ensemble de printf) : %d %u %x %X %c %f avec drapeau 0,
+ * largeur et précision ; %s pour une chaîne à durée de vie statique
+ * (littéral, table) ; %t (texte), %p (ASCII imprimable, '.' sinon) et %h
+ * (octets en hexa) pour un LogData, copié dans l'enregistrement et tronqué
+ * au-delà de LOG_RECORD_DATA_SIZE.
+ *
+ * En simulation (RADIO_SIM), l'enregistrement est affiché immédiatement :
+ * le préfixe du noeud courant reste correct.
+ *
+ * Les Serial.print directs (lignes en plusieurs morceaux, blocs STATUS)
+ * prennent LogSerialLock pour ne pas s'entrelacer avec la tâche du journal.
+ */
+
+#define LOG_LEVEL_NONE   0
+#define LOG_LEVEL_ERROR  1
+#define LOG_LEVEL_WARN   2
+#define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
+
+enum LogCategory : uint8_t {
+	LOG_CAT_RADIO = 0,   // trames brutes des modes
+	LOG_CAT_FRAG = 1,    // FragmentManager (fragments, ACK, FEC)
+	LOG_CAT_PROTO = 2,   // MessageProtocol (affichage des messages)
+	LOG_CAT_SENSOR = 3   // capteur HLK-LD2450
+};
+
+#define LOG_CAT_BIT(cat)  (1u << (cat))
+#define LOG_CAT_ALL       0xFFu
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES LOG_CAT_ALL
+#endif
+
+// Condition constante : le compilateur supprime l'appel et son format
+#define LOG_ENABLED(level, cat) ((level) <= LOG_LEVEL && (LOG_CATEGORIES & LOG_CAT_BIT(cat)) != 0)
+
+#define LOG_AT(level, cat, ...) \
+	do { if (LOG_ENABLED(level, cat)) Log::write((level), (cat), __VA_ARGS__); } while (0)
+
+#define LOG_ERROR(cat, ...) LOG_AT(LOG_LEVEL_ERROR, cat, __VA_ARGS__)
+#define LOG_WARN(cat, ...)  LOG_AT(LOG_LEVEL_WARN, cat, __VA_ARGS__)
+#define LOG_INFO(cat, ...)  LOG_AT(LOG_LEVEL_INFO, cat, __VA_ARGS__)
+#define LOG_DEBUG(cat, ...) LOG_AT(LOG_LEVEL_DEBUG, cat, __VA_ARGS__)
+
+static const uint8_t LOG_MAX_ARGS = 6;
+
+// Argument numérique ou chaîne statique (4 octets sur ESP32)
+union LogArg {
+	uint32_t u;
+	float f;
+	const char* s;
+};
+
+struct LogRecord {
+	uint32_t timestampMs;
+	const char* fmt;                       // littéral : jamais copié
+	uint8_t level;
+	uint8_t category;
+	uint8_t argCount;
+	uint8_t dataLen;
+	LogArg args[LOG_MAX_ARGS];
+	uint8_t data[LOG_RECORD_DATA_SIZE];    // segments [longueur][drapeaux][octets]
+};
+
+// Texte ou octets à copier dans l'enregistrement (%t, %p, %h)
+struct LogData {
+	const uint8_t* ptr;
+	size_t len;
+	LogData(const uint8_t* data, size_t size) : ptr(data), len(size) {}
+	LogData(const char* text, size_t size) : ptr((const uint8_t*)text), len(size) {}
+	explicit LogData(const char* text) : ptr((const uint8_t*)text), len(text ? strlen(text) : 0) {}
+};
+
+class Log {
+public:
+	// Démarre la tâche d'affichage (ESP32) ; avant, les enregistrements s'accumulent
+	static bool begin();
+	
+	template <class... Args>
+	static void write(uint8_t level, uint8_t category, const char* fmt, const Args&... args) {
+		static_assert(sizeof...(Args) <= LOG_MAX_ARGS + 2, "LOG : trop d'arguments");
+		LogRecord* rec = reserve();
+		if (!rec) return;
+		rec->timestampMs = millis();
+		rec->fmt = fmt;
+		rec->level = level;
+		rec->category = category;
+		rec->argCount = 0;
+		rec->dataLen = 0;
+		int expand[] = { 0, (pack(*rec, args), 0)... };
+		(void)expand;
+		commit(rec);
+	}
+	
+	// Affiche les enregistrements en attente (consommateur unique : la tâche du journal)
+	static void drain();
+	
+	// Enregistrement -> ligne de texte terminée par '\n' ; renvoie sa longueur
+	static size_t format(const LogRecord& rec, char* out, size_t capacity);
+	
+	static uint32_t getDroppedCount();
+	static uint32_t getHighWatermark();
+	
+	// Verrou (récursif) de la sortie série ; false s'il n'existe pas encore
+	static bool lockSerial();
+	static void unlockSerial();
+
+private:
+	static LogRecord* reserve();
+	static void commit(LogRecord* rec);
+	static void emit(const LogRecord& rec);
+	
+	template <class T>
+	static typename std::enable_if<std::is_integral<T>::value>::type pack(LogRecord& rec, T value) {
+		if (rec.argCount < LOG_MAX_ARGS) rec.args[rec.argCount++].u = (uint32_t)value;
+	}
+	static void pack(LogRecord& rec, float value) {
+		if (rec.argCount < LOG_MAX_ARGS) rec.args[rec.argCount++].f = value;
+	}
+	static void pack(LogRecord& rec, double value) { pack(rec, (float)value); }
+	static void pack(LogRecord& rec, const char* text) {
+		if (rec.argCount < LOG_MAX_ARGS) rec.args[rec.argCount++].s = text;
+	}
+	static void pack(LogRecord& rec, const LogData& data);
+	
+	static void taskEntry(void* arg);
+};
+
+/**
+ * Sortie série réservée pour la durée d'une portée : les Serial.print qu'elle
+ * contient sortent d'un bloc, sans ligne du journal au milieu. Imbricable ;
+ * sans effet avant Log::begin() et en simulation.
+ */
+class LogSerialLock {
+public:
+	LogSerialLock() : held(Log::lockSerial()) {}
+	~LogSerialLock() {
+		if (held) Log::unlockSerial();
+	}
+	LogSerialLock(const LogSerialLock&) = delete;
+	LogSerialLock& operator=(const LogSerialLock&) = delete;
+
+private:
+	bool held;
+};
+
+#endif // LOG_H
@@ -0,0 +1,92 @@
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * File circulaire sans verrou, plusieurs producteurs / un seul consommateur
+ *
+ * Variante de SpscRing pour les sources concurrentes (loop(), tâches radio) :
+ * chaque slot porte un numéro de séquence. Un producteur réserve un slot par
+ * compare-and-swap sur la tête, l'écrit en place puis le publie en avançant
+ * sa séquence ; le consommateur ne lit un slot que lorsqu'il est publié.
+ * File pleine : la réservation échoue immédiatement (jamais d'attente).
+ *
+ * N doit être une puissance de 2.
+ */
+template <class T, uint32_t N>
+class MpscRing {
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscRing: N doit être une puissance de 2");
+
+public:
+	MpscRing() : head(0), tail(0), overflows(0), highWatermark(0) {
+		for (uint32_t i = 0; i < N; i++) {
+			seqs[i].store(i, std::memory_order_relaxed);
+		}
+	}
+	
+	// --- Producteurs (n'importe quelle tâche) ---
+	
+	// Slot libre à remplir, nullptr si la file est pleine (débordement compté)
+	T* reserve() {
+		uint32_t pos = head.load(std::memory_order_relaxed);
+		for (;;) {
+			const uint32_t seq = seqs[pos & (N - 1)].load(std::memory_order_acquire);
+			const int32_t diff = (int32_t)(seq - pos);
+			if (diff == 0) {
+				if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					const uint32_t depth = pos + 1 - tail.load(std::memory_order_relaxed);
+					if (depth > highWatermark.load(std::memory_order_relaxed)) {
+						highWatermark.store(depth, std::memory_order_relaxed);
+					}
+					return &slots[pos & (N - 1)];
+				}
+				// pos rechargé par l'échec du CAS
+			} else if (diff < 0) {
+				overflows.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			} else {
+				pos = head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+	
+	// Publie le slot obtenu par reserve()
+	void commit(T* slot) {
+		std::atomic<uint32_t>& seq = seqs[slot - slots];
+		seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	
+	// --- Consommateur ---
+	
+	// Slot publié le plus ancien, nullptr si vide ; reste valide jusqu'à pop()
+	T* front() {
+		const uint32_t t = tail.load(std::memory_order_relaxed);
+		if (seqs[t & (N - 1)].load(std::memory_order_acquire) != t + 1) return nullptr;
+		return &slots[t & (N - 1)];
+	}
+	
+	void pop() {
+		const uint32_t t = tail.load(std::memory_order_relaxed);
+		seqs[t & (N - 1)].store(t + N, std::memory_order_release);
+		tail.store(t + 1, std::memory_order_relaxed);
+	}
+	
+	// --- Statistiques (lecture depuis n'importe quel contexte) ---
+	
+	static uint32_t capacity() { return N; }
+	uint32_t getOverflowCount() const { return overflows.load(std::memory_order_relaxed); }
+	uint32_t getHighWatermark() const { return highWatermark.load(std::memory_order_relaxed); }
+
+private:
+	T slots[N];
+	std::atomic<uint32_t> seqs[N];        // pos : libre, pos + 1 : publié
+	std::atomic<uint32_t> head;           // prochain slot à réserver (producteurs)
+	std::atomic<uint32_t> tail;           // prochain slot à lire (consommateur)
+	std::atomic<uint32_t> overflows;
+	std::atomic<uint32_t> highWatermark;
+};
+
+#endif // MPSC_RING_H
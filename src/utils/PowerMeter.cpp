@@ -0,0 +1,110 @@
+#include "PowerMeter.h"
+#include "Log.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+static const uint32_t CPU_CURRENT_UA[CPU_PWR_STATE_COUNT] = {
+	CURRENT_ESP32_ACTIVE_UA, CURRENT_ESP32_LIGHT_SLEEP_UA
+};
+static const uint32_t RADIO_CURRENT_UA[RADIO_PWR_STATE_COUNT] = {
+	CURRENT_E220_RX_UA, CURRENT_E220_WOR_UA
+};
+
+PowerMeter::PowerMeter()
+	: txAirtimeUs(0), radioState(RADIO_PWR_RX), lastUpdateMs(millis()),
+	  wakeByRadio(0), wakeByTimer(0) {
+	for (uint8_t i = 0; i < CPU_PWR_STATE_COUNT; i++) cpuMs[i] = 0;
+	for (uint8_t i = 0; i < RADIO_PWR_STATE_COUNT; i++) radioMs[i] = 0;
+}
+
+void PowerMeter::accumulate(PowerCpuState cpuState) {
+	// millis() continue de compter pendant le light sleep
+	const unsigned long now = millis();
+	const unsigned long elapsed = now - lastUpdateMs;
+	cpuMs[cpuState] += elapsed;
+	radioMs[radioState] += elapsed;
+	lastUpdateMs = now;
+}
+
+void PowerMeter::setRadioState(PowerRadioState state) {
+	if (state == radioState) return;
+	accumulate(CPU_PWR_ACTIVE);
+	radioState = state;
+}
+
+bool PowerMeter::lightSleep(int wakePin, unsigned long maxMs) {
+	accumulate(CPU_PWR_ACTIVE);
+	
+	// AUX passe bas avant la sortie UART de la trame : le réveil (~1 ms) précède les données
+	gpio_wakeup_enable((gpio_num_t)wakePin, GPIO_INTR_LOW_LEVEL);
+	esp_sleep_enable_gpio_wakeup();
+	esp_sleep_enable_timer_wakeup((uint64_t)maxMs * 1000ULL);
+	esp_light_sleep_start();
+	gpio_wakeup_disable((gpio_num_t)wakePin);
+	
+	accumulate(CPU_PWR_LIGHT_SLEEP);
+	
+	const bool byRadio = (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO);
+	if (byRadio) {
+		wakeByRadio++;
+	} else {
+		wakeByTimer++;
+	}
+	return byRadio;
+}
+
+uint32_t PowerMeter::getAverageMicroAmps() {
+	accumulate(CPU_PWR_ACTIVE);
+	
+	uint64_t totalMs = 0;
+	uint64_t chargeUaMs = 0;
+	for (uint8_t i = 0; i < CPU_PWR_STATE_COUNT; i++) {
+		totalMs += cpuMs[i];
+		chargeUaMs += cpuMs[i] * CPU_CURRENT_UA[i];
+	}
+	for (uint8_t i = 0; i < RADIO_PWR_STATE_COUNT; i++) {
+		chargeUaMs += radioMs[i] * RADIO_CURRENT_UA[i];
+	}
+	// Pendant l'émission, le module consomme le courant TX au lieu du courant RX
+	chargeUaMs += (txAirtimeUs / 1000) * (CURRENT_E220_TX_UA - CURRENT_E220_RX_UA);
+	
+	if (totalMs == 0) return 0;
+	return (uint32_t)(chargeUaMs / totalMs);
+}
+
+void PowerMeter::print(const char* label) {
+	const uint32_t averageUa = getAverageMicroAmps();
+	const uint64_t totalMs = cpuMs[CPU_PWR_ACTIVE] + cpuMs[CPU_PWR_LIGHT_SLEEP];
+	
+	LogSerialLock lock;
+	Serial.print("[POWER] ");
+	Serial.print(label);
+	Serial.print(": courant moyen ");
+	Serial.print(averageUa / 1000.0f, 2);
+	Serial.print(" mA sur ");
+	Serial.print((uint32_t)(totalMs / 1000));
+	Serial.println(" s");
+	
+	if (totalMs > 0) {
+		Serial.print("[POWER] ESP32 actif ");
+		Serial.print(100.0f * cpuMs[CPU_PWR_ACTIVE] / totalMs, 1);
+		Serial.print(" %, radio en WOR ");
+		Serial.print(100.0f * radioMs[RADIO_PWR_WOR] / totalMs, 1);
+		Serial.print(" %, émission ");
+		Serial.print(100.0f * (txAirtimeUs / 1000) / totalMs, 2);
+		Serial.println(" %");
+	}
+	
+	Serial.print("[POWER] Réveils radio/timer: ");
+	Serial.print(wakeByRadio);
+	Serial.print("/");
+	Serial.println(wakeByTimer);
+	
+	if (averageUa > 0) {
+		Serial.print("[POWER] Autonomie estimée (");
+		Serial.print(BATTERY_CAPACITY_MAH);
+		Serial.print(" mAh): ");
+		Serial.print(BATTERY_CAPACITY_MAH * 1000.0f / averageUa / 24.0f, 1);
+		Serial.println(" jours");
+	}
+}
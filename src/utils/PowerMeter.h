@@ -0,0 +1,55 @@
+#ifndef POWER_METER_H
+#define POWER_METER_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include "../Config.h"
+
+enum PowerCpuState : uint8_t {
+	CPU_PWR_ACTIVE = 0,
+	CPU_PWR_LIGHT_SLEEP = 1,
+	CPU_PWR_STATE_COUNT = 2
+};
+
+enum PowerRadioState : uint8_t {
+	RADIO_PWR_RX = 0,     // écoute continue (E220 mode 0/1)
+	RADIO_PWR_WOR = 1,    // écoute périodique (E220 mode 2)
+	RADIO_PWR_STATE_COUNT = 2
+};
+
+/**
+ * Bilan énergétique du noeud : temps mesuré dans chaque état (ESP32 et radio)
+ * pondéré par le courant de l'état (Config.h, CURRENT_*)
+ *
+ * Le temps d'émission est fourni par le driver (temps d'antenne cumulé) et
+ * compté au courant TX à la place du courant RX. Le résultat est une moyenne
+ * sur toute la durée mesurée, avec l'autonomie projetée sur BATTERY_CAPACITY_MAH.
+ */
+class PowerMeter {
+public:
+	PowerMeter();
+	
+	void setRadioState(PowerRadioState state);
+	// Temps d'antenne cumulé depuis le démarrage (RadioDriver::getTxAirtimeTotalUs)
+	void setTxAirtimeTotalUs(uint64_t totalUs) { txAirtimeUs = totalUs; }
+	
+	// Light sleep jusqu'à wakePin bas (AUX du E220) ou maxMs.
+	// Retourne true si la radio a réveillé l'ESP32.
+	bool lightSleep(int wakePin, unsigned long maxMs);
+	
+	uint32_t getAverageMicroAmps();
+	void print(const char* label);
+	
+private:
+	uint64_t cpuMs[CPU_PWR_STATE_COUNT];
+	uint64_t radioMs[RADIO_PWR_STATE_COUNT];
+	uint64_t txAirtimeUs;
+	PowerRadioState radioState;
+	unsigned long lastUpdateMs;
+	uint32_t wakeByRadio;
+	uint32_t wakeByTimer;
+	
+	void accumulate(PowerCpuState cpuState);
+};
+
+#endif // POWER_METER_H
@@ -0,0 +1,78 @@
+#ifndef SLOT_POOL_H
+#define SLOT_POOL_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Index invalide : aucun slot
+static const uint16_t POOL_SLOT_NONE = 0xFFFF;
+
+/**
+ * Réserve fixe de N slots de SlotSize octets, allouée une fois pour toutes
+ *
+ * Remplace les petits std::vector alloués et libérés à chaque fragment : la
+ * mémoire occupée ne dépend plus du trafic, et le tas de l'ESP32 ne se
+ * morcelle pas au fil des semaines. Les slots libres forment une pile
+ * d'index : alloc() et release() en O(1), sans parcours.
+ *
+ * Un seul contexte d'exécution (loop()) : pas de synchronisation.
+ */
+template <size_t SlotSize, uint16_t N>
+class SlotPool {
+	static_assert(N >= 1 && N < POOL_SLOT_NONE, "SlotPool: N hors limites");
+
+public:
+	SlotPool() : freeCount(N), highWatermark(0), exhausted(0) {
+		// Slot 0 en sommet de pile
+		for (uint16_t i = 0; i < N; i++) {
+			freeStack[i] = N - 1 - i;
+		}
+	}
+	
+	// Index d'un slot libre, POOL_SLOT_NONE si la réserve est vide (compté)
+	uint16_t alloc() {
+		if (freeCount == 0) {
+			exhausted++;
+			return POOL_SLOT_NONE;
+		}
+		const uint16_t slot = freeStack[--freeCount];
+		if (N - freeCount > highWatermark) {
+			highWatermark = N - freeCount;
+		}
+		return slot;
+	}
+	
+	// Rend un slot obtenu par alloc() (POOL_SLOT_NONE ignoré)
+	void release(uint16_t slot) {
+		if (slot >= N || freeCount >= N) return;
+		freeStack[freeCount++] = slot;
+	}
+	
+	// Vérifie qu'il reste count slots ; sinon compte un épuisement (l'appelant renonce)
+	bool reserveCheck(uint16_t count) {
+		if (count <= freeCount) return true;
+		exhausted++;
+		return false;
+	}
+	
+	uint8_t* data(uint16_t slot) { return slots[slot]; }
+	const uint8_t* data(uint16_t slot) const { return slots[slot]; }
+	
+	// --- Statistiques ---
+	
+	static size_t slotSize() { return SlotSize; }
+	static uint16_t capacity() { return N; }
+	uint16_t getFreeCount() const { return freeCount; }
+	uint16_t getInUse() const { return N - freeCount; }
+	uint16_t getHighWatermark() const { return highWatermark; }
+	uint32_t getExhaustedCount() const { return exhausted; }   // demandes refusées
+
+private:
+	uint8_t slots[N][SlotSize];
+	uint16_t freeStack[N];
+	uint16_t freeCount;
+	uint16_t highWatermark;
+	uint32_t exhausted;
+};
+
+#endif // SLOT_POOL_H
@@ -0,0 +1,77 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * File circulaire sans verrou, un seul producteur / un seul consommateur
+ *
+ * Le producteur (ISR ou tâche) écrit directement dans le slot réservé puis le
+ * publie ; le consommateur lit le slot en tête puis le libère. Aucune copie
+ * intermédiaire, aucun masquage d'interruption : les index sont des compteurs
+ * 32 bits libres (atomiques sur ESP32), publiés en release et lus en acquire.
+ *
+ * N doit être une puissance de 2.
+ */
+template <class T, uint32_t N>
+class SpscRing {
+	static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing: N doit être une puissance de 2");
+	
+public:
+	SpscRing() : head(0), tail(0), overflows(0), highWatermark(0) {}
+	
+	// --- Producteur ---
+	
+	// Slot libre à remplir, nullptr si la file est pleine (débordement compté)
+	T* reserve() {
+		const uint32_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) >= N) {
+			overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		return &slots[h & (N - 1)];
+	}
+	
+	// Publie le slot obtenu par reserve()
+	void commit() {
+		const uint32_t h = head.load(std::memory_order_relaxed) + 1;
+		head.store(h, std::memory_order_release);
+		const uint32_t depth = h - tail.load(std::memory_order_relaxed);
+		if (depth > highWatermark.load(std::memory_order_relaxed)) {
+			highWatermark.store(depth, std::memory_order_relaxed);
+		}
+	}
+	
+	// --- Consommateur ---
+	
+	// Slot le plus ancien, nullptr si vide ; reste valide jusqu'à pop()
+	T* front() {
+		const uint32_t t = tail.load(std::memory_order_relaxed);
+		if (head.load(std::memory_order_acquire) == t) return nullptr;
+		return &slots[t & (N - 1)];
+	}
+	
+	void pop() {
+		tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+	
+	// --- Statistiques (lecture depuis n'importe quel contexte) ---
+	
+	uint32_t size() const {
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+	static uint32_t capacity() { return N; }
+	uint32_t getOverflowCount() const { return overflows.load(std::memory_order_relaxed); }
+	uint32_t getHighWatermark() const { return highWatermark.load(std::memory_order_relaxed); }
+	
+private:
+	T slots[N];
+	std::atomic<uint32_t> head;           // écrit par le producteur
+	std::atomic<uint32_t> tail;           // écrit par le consommateur
+	std::atomic<uint32_t> overflows;      // écrit par le producteur
+	std::atomic<uint32_t> highWatermark;  // écrit par le producteur
+};
+
+#endif // SPSC_RING_H